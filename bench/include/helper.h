@@ -0,0 +1,43 @@
+#ifndef BENCH_HELPER_H
+#define BENCH_HELPER_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RESPONDER_DATAGRAM_MAX  8
+#define RESPONDER_DATAGRAM_SIZE 1400
+#define RESPONDER_PORT_MAX      256
+
+/* Number of calls to `malloc', `calloc' and `realloc' since the program started. */
+extern size_t g_alloc_count;
+
+/* Number of socket and epoll system calls made by the library since the program started. */
+extern size_t g_syscall_count;
+
+/*
+ * UDP server listening on one or more ports of the loopback interface which answers
+ * every request it receives with the same datagrams, until it is stopped.
+ */
+typedef struct responder {
+    int           sockfds[RESPONDER_PORT_MAX];
+    uint16_t      ports[RESPONDER_PORT_MAX];
+    size_t        port_count;
+    pthread_t     thread;
+    volatile bool stop;
+    uint8_t       datagrams[RESPONDER_DATAGRAM_MAX][RESPONDER_DATAGRAM_SIZE];
+    size_t        datagram_lens[RESPONDER_DATAGRAM_MAX];
+    size_t        datagram_count;
+} RESPONDER;
+
+void responder_start(RESPONDER *responder, const char *const *filenames, size_t port_count);
+
+void responder_stop(RESPONDER *responder);
+
+/* Current time of the monotonic clock in seconds. */
+double bench_now(void);
+
+void bench_report(const char *name, size_t iterations, double elapsed, size_t allocs);
+
+#endif /* BENCH_HELPER_H */
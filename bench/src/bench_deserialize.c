@@ -0,0 +1,225 @@
+/*
+ * bench_deserialize.c
+ *
+ * Measures the time per response of the A2S deserializers on responses reassembled from the
+ * datagrams of the test suite, without any network involved.
+ */
+
+#include <assert.h>
+#include <err.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ssq/a2s.h>
+#include <ssq/packet.h>
+#include "helper.h"
+
+#define DEFAULT_ITERATIONS 1000000
+
+#define RESPONSE_PACKET_MAX 8
+
+static const char *const g_css[]    = { "../tests/dgram/info/css.bin", NULL };
+static const char *const g_tf2[]    = { "../tests/dgram/info/tf2.bin", NULL };
+static const char *const g_player[] = { "../tests/dgram/player/example_0.bin", NULL };
+static const char *const g_rules[]  = {
+    "../tests/dgram/rules/tf2_0.bin",
+    "../tests/dgram/rules/tf2_1.bin",
+    "../tests/dgram/rules/tf2_2.bin",
+    "../tests/dgram/rules/tf2_3.bin",
+    "../tests/dgram/rules/tf2_4.bin",
+    NULL
+};
+
+/* Response reassembled from datagram files. */
+typedef struct response {
+    uint8_t *payload;
+    size_t   len;
+} RESPONSE;
+
+static RESPONSE response_load(const char *const filenames[]) {
+    SSQ_PACKET *packets[RESPONSE_PACKET_MAX];
+    uint8_t     packet_count = 0;
+
+    SSQ_ERROR error;
+    ssq_error_clear(&error);
+
+    for (; *filenames != NULL && packet_count < RESPONSE_PACKET_MAX; ++filenames) {
+        FILE *const file = fopen(*filenames, "rb");
+        if (file == NULL)
+            err(EXIT_FAILURE, "fopen: %s", *filenames);
+
+        uint8_t      datagram[RESPONDER_DATAGRAM_SIZE];
+        const size_t datagram_len = fread(datagram, 1, sizeof (datagram), file);
+        fclose(file);
+
+        packets[packet_count++] = ssq_packet_from_datagram(datagram, datagram_len, &error);
+        assert(error.code == SSQ_OK);
+    }
+
+    RESPONSE response;
+    response.payload = ssq_packets_to_response((const SSQ_PACKET *const *)packets, packet_count, &(response.len), &error);
+    assert(error.code == SSQ_OK);
+
+    for (uint8_t i = 0; i < packet_count; ++i)
+        ssq_packet_free(packets[i]);
+
+    return response;
+}
+
+static void deserialize_report(const char name[], const size_t iterations, const double elapsed, const size_t allocs) {
+    printf(
+        "%-28s %8zu responses %10.1f ns/response %8.2f allocs/response\n",
+        name,
+        iterations,
+        elapsed * 1e9 / iterations,
+        (double)allocs / iterations
+    );
+}
+
+static void bench_info(const char name[], const RESPONSE *const response, const size_t iterations) {
+    SSQ_ERROR error;
+    ssq_error_clear(&error);
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        A2S_INFO *const info = ssq_info_deserialize(response->payload, response->len, &error);
+        assert(info != NULL);
+        ssq_info_free(info);
+    }
+
+    deserialize_report(name, iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+static void bench_info_ex(const char name[], const RESPONSE *const response, const uint32_t fields, const size_t iterations) {
+    SSQ_ERROR error;
+    ssq_error_clear(&error);
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        A2S_INFO *const info = ssq_info_deserialize_ex(response->payload, response->len, fields, &error);
+        assert(info != NULL);
+        ssq_info_free(info);
+    }
+
+    deserialize_report(name, iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+static void bench_info_view(const char name[], const RESPONSE *const response, const size_t iterations) {
+    SSQ_ERROR error;
+    ssq_error_clear(&error);
+
+    volatile uint16_t sink = 0;
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        A2S_INFO_REF info;
+        ssq_info_deserialize_view(response->payload, response->len, &info, &error);
+        sink = info.id;
+    }
+
+    (void)sink;
+    deserialize_report(name, iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+static void bench_info_lazy_view(const char name[], const RESPONSE *const response, const size_t iterations) {
+    SSQ_ERROR error;
+    ssq_error_clear(&error);
+
+    volatile size_t sink = 0;
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        A2S_INFO_VIEW view;
+        ssq_info_view_open(response->payload, response->len, &view, &error);
+        sink = ssq_info_view_map(&view).len + ssq_info_view_players(&view);
+    }
+
+    (void)sink;
+    deserialize_report(name, iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+static void bench_player(const RESPONSE *const response, const size_t iterations) {
+    SSQ_ERROR error;
+    ssq_error_clear(&error);
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        uint8_t           player_count;
+        A2S_PLAYER *const players = ssq_player_deserialize(response->payload, response->len, &player_count, &error);
+        assert(players != NULL);
+        ssq_player_free(players, player_count);
+    }
+
+    deserialize_report("ssq_player_deserialize", iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+static void bench_rules(const RESPONSE *const response, const size_t iterations) {
+    SSQ_ERROR error;
+    ssq_error_clear(&error);
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        uint16_t         rule_count;
+        A2S_RULES *const rules = ssq_rules_deserialize(response->payload, response->len, &rule_count, &error);
+        assert(rules != NULL);
+        ssq_rules_free(rules, rule_count);
+    }
+
+    deserialize_report("ssq_rules_deserialize", iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+static void bench_rules_view(const RESPONSE *const response, const size_t iterations) {
+    static A2S_RULES_REF storage[UINT16_MAX];
+
+    SSQ_ERROR error;
+    ssq_error_clear(&error);
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        uint16_t rule_count;
+        ssq_rules_deserialize_view(response->payload, response->len, storage, UINT16_MAX, &rule_count, &error);
+        assert(rule_count != 0);
+    }
+
+    deserialize_report("ssq_rules_deserialize_view", iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_ITERATIONS;
+
+    RESPONSE css    = response_load(g_css);
+    RESPONSE tf2    = response_load(g_tf2);
+    RESPONSE player = response_load(g_player);
+    RESPONSE rules  = response_load(g_rules);
+
+    bench_info("ssq_info_deserialize (css)", &css, iterations);
+    bench_info("ssq_info_deserialize (tf2)", &tf2, iterations);
+    bench_info_ex("ssq_info_deserialize_ex", &tf2, A2S_INFO_FIELD_MAP | A2S_INFO_FIELD_PLAYERS | A2S_INFO_FIELD_MAX_PLAYERS, iterations);
+    bench_info_view("ssq_info_deserialize_view", &tf2, iterations);
+    bench_info_lazy_view("ssq_info_view_open", &tf2, iterations);
+    bench_player(&player, iterations);
+
+    // A rules response holds hundreds of rules, each one taking as long as a whole info response.
+    bench_rules(&rules, iterations / 100);
+    bench_rules_view(&rules, iterations / 100);
+
+    free(css.payload);
+    free(tf2.payload);
+    free(player.payload);
+    free(rules.payload);
+
+    return EXIT_SUCCESS;
+}
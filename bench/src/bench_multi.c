@@ -0,0 +1,93 @@
+/*
+ * bench_multi.c
+ *
+ * Measures the throughput of `ssq_multi' and the number of system calls it makes per response
+ * against a responder running on the loopback interface.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ssq/multi.h>
+#include "helper.h"
+
+#define DEFAULT_ITERATIONS 10000
+
+/* Number of ports the responder listens on, as if there were as many servers. */
+#define TARGET_COUNT 256
+
+static const char *const g_info[]  = { "../tests/dgram/info/css.bin", NULL };
+static const char *const g_rules[] = {
+    "../tests/dgram/rules/tf2_0.bin",
+    "../tests/dgram/rules/tf2_1.bin",
+    "../tests/dgram/rules/tf2_2.bin",
+    "../tests/dgram/rules/tf2_3.bin",
+    "../tests/dgram/rules/tf2_4.bin",
+    NULL
+};
+
+static size_t g_responses = 0;
+
+static void bench_callback(SSQ_MULTI_RESULT *const result) {
+    assert(result->err.code == SSQ_OK);
+    ++g_responses;
+
+    if (result->info != NULL)
+        ssq_info_free(result->info);
+    if (result->rules != NULL)
+        ssq_rules_free(result->rules, result->rule_count);
+}
+
+static void bench_multi(
+    const char            name[],
+    const char     *const filenames[],
+    const SSQ_MULTI_QUERY query,
+    const bool            shared,
+    const size_t          iterations
+) {
+    RESPONDER responder;
+    responder_start(&responder, filenames, TARGET_COUNT);
+
+    SSQ_MULTI *const multi = ssq_multi_init();
+    assert(multi != NULL);
+
+    ssq_multi_set_callback(multi, bench_callback);
+    ssq_multi_set_shared_socket(multi, shared);
+
+    g_responses = 0;
+
+    const size_t syscalls = g_syscall_count;
+    const size_t allocs   = g_alloc_count;
+    const double start    = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i)
+        ssq_multi_add(multi, "127.0.0.1", responder.ports[i % TARGET_COUNT], query, NULL);
+
+    ssq_multi_run(multi);
+    assert(ssq_multi_ok(multi));
+
+    const double elapsed = bench_now() - start;
+
+    printf(
+        "%-24s %8zu queries %10.0f responses/s %8.2f syscalls/response %8.2f allocs/query\n",
+        name,
+        iterations,
+        g_responses / elapsed,
+        (double)(g_syscall_count - syscalls) / g_responses,
+        (double)(g_alloc_count - allocs) / iterations
+    );
+
+    ssq_multi_free(multi);
+    responder_stop(&responder);
+}
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_ITERATIONS;
+
+    bench_multi("ssq_multi (info)", g_info, SSQ_MULTI_INFO, false, iterations);
+    bench_multi("ssq_multi (rules)", g_rules, SSQ_MULTI_RULES, false, iterations);
+    bench_multi("ssq_multi shared (info)", g_info, SSQ_MULTI_INFO, true, iterations);
+    bench_multi("ssq_multi shared (rules)", g_rules, SSQ_MULTI_RULES, true, iterations);
+
+    return EXIT_SUCCESS;
+}
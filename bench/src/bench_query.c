@@ -0,0 +1,147 @@
+/*
+ * bench_query.c
+ *
+ * Measures the time and the number of allocations per query of `ssq_query' and of the
+ * A2S functions against a responder running on the loopback interface.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ssq/a2s.h>
+#include <ssq/query.h>
+#include <ssq/response.h>
+#include "helper.h"
+
+#define DEFAULT_ITERATIONS 10000
+
+static const char *const g_info[]  = { "../tests/dgram/info/css.bin", NULL };
+static const char *const g_rules[] = {
+    "../tests/dgram/rules/tf2_0.bin",
+    "../tests/dgram/rules/tf2_1.bin",
+    "../tests/dgram/rules/tf2_2.bin",
+    "../tests/dgram/rules/tf2_3.bin",
+    "../tests/dgram/rules/tf2_4.bin",
+    NULL
+};
+
+static SSQ_QUERIER *bench_querier(const RESPONDER *const responder) {
+    SSQ_QUERIER *const querier = ssq_init();
+    assert(querier != NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder->ports[0]);
+    assert(ssq_ok(querier));
+
+    return querier;
+}
+
+static void bench_query(const char name[], SSQ_QUERIER *const querier, const uint8_t payload[], const size_t payload_len, const size_t iterations) {
+    size_t response_len;
+
+    // Warms up the querier's socket.
+    free(ssq_query(querier, payload, payload_len, &response_len));
+    assert(ssq_ok(querier));
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        uint8_t *const response = ssq_query(querier, payload, payload_len, &response_len);
+        assert(ssq_ok(querier));
+        free(response);
+    }
+
+    bench_report(name, iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+static void bench_info(SSQ_QUERIER *const querier, const size_t iterations) {
+    ssq_info_free(ssq_info(querier));
+    assert(ssq_ok(querier));
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        A2S_INFO *const info = ssq_info(querier);
+        assert(ssq_ok(querier));
+        ssq_info_free(info);
+    }
+
+    bench_report("ssq_info", iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+static void bench_rules(SSQ_QUERIER *const querier, const size_t iterations) {
+    uint16_t rule_count;
+
+    // Warms up the querier, the rule count being read once the query stored it.
+    A2S_RULES *const warmup = ssq_rules(querier, &rule_count);
+    assert(ssq_ok(querier));
+    ssq_rules_free(warmup, rule_count);
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        A2S_RULES *const rules = ssq_rules(querier, &rule_count);
+        assert(ssq_ok(querier));
+        ssq_rules_free(rules, rule_count);
+    }
+
+    bench_report("ssq_rules", iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+static void bench_rules_view(SSQ_QUERIER *const querier, const uint8_t payload[], const size_t payload_len, const size_t iterations) {
+    static A2S_RULES_REF storage[UINT16_MAX];
+
+    const size_t allocs = g_alloc_count;
+    const double start  = bench_now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        size_t         response_len;
+        uint8_t *const response = ssq_query(querier, payload, payload_len, &response_len);
+        assert(ssq_ok(querier));
+
+        uint16_t rule_count;
+        ssq_rules_deserialize_view(response, response_len, storage, UINT16_MAX, &rule_count, &(querier->err));
+        assert(ssq_ok(querier));
+
+        free(response);
+    }
+
+    bench_report("ssq_rules (view)", iterations, bench_now() - start, g_alloc_count - allocs);
+}
+
+int main(int argc, char *argv[]) {
+    const size_t iterations = (argc > 1) ? strtoul(argv[1], NULL, 10) : DEFAULT_ITERATIONS;
+
+    RESPONDER info_responder;
+    responder_start(&info_responder, g_info, 1);
+
+    SSQ_QUERIER *querier = bench_querier(&info_responder);
+
+    uint8_t      info_payload[A2S_INFO_PAYLOAD_LEN];
+    const size_t info_payload_len = ssq_info_payload(info_payload, A2S_CHALLENGE_NONE);
+
+    bench_query("ssq_query (single)", querier, info_payload, info_payload_len, iterations);
+    bench_info(querier, iterations);
+
+    ssq_free(querier);
+    responder_stop(&info_responder);
+
+    RESPONDER rules_responder;
+    responder_start(&rules_responder, g_rules, 1);
+
+    querier = bench_querier(&rules_responder);
+
+    uint8_t      rules_payload[A2S_RULES_PAYLOAD_LEN];
+    const size_t rules_payload_len = ssq_rules_payload(rules_payload, A2S_CHALLENGE_NONE);
+
+    bench_query("ssq_query (multi)", querier, rules_payload, rules_payload_len, iterations);
+    bench_rules(querier, iterations);
+    bench_rules_view(querier, rules_payload, rules_payload_len, iterations);
+
+    ssq_free(querier);
+    responder_stop(&rules_responder);
+
+    return EXIT_SUCCESS;
+}
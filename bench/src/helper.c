@@ -0,0 +1,213 @@
+#include <arpa/inet.h>
+#include <err.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "helper.h"
+
+size_t g_alloc_count   = 0;
+size_t g_syscall_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void  __real_free(void *ptr);
+
+void *__wrap_malloc(size_t size) {
+    ++g_alloc_count;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    ++g_alloc_count;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    ++g_alloc_count;
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr) {
+    __real_free(ptr);
+}
+
+struct mmsghdr;
+
+ssize_t __real_send(int sockfd, const void *buf, size_t len, int flags);
+ssize_t __real_recv(int sockfd, void *buf, size_t len, int flags);
+ssize_t __real_sendto(int sockfd, const void *buf, size_t len, int flags, const struct sockaddr *addr, socklen_t addr_len);
+ssize_t __real_recvfrom(int sockfd, void *buf, size_t len, int flags, struct sockaddr *addr, socklen_t *addr_len);
+int     __real_sendmmsg(int sockfd, struct mmsghdr *msgs, unsigned int vlen, int flags);
+int     __real_recvmmsg(int sockfd, struct mmsghdr *msgs, unsigned int vlen, int flags, struct timespec *timeout);
+int     __real_epoll_wait(int epollfd, struct epoll_event *events, int maxevents, int timeout);
+int     __real_epoll_ctl(int epollfd, int op, int fd, struct epoll_event *event);
+int     __real_socket(int domain, int type, int protocol);
+int     __real_connect(int sockfd, const struct sockaddr *addr, socklen_t addr_len);
+int     __real_close(int fd);
+
+ssize_t __wrap_send(int sockfd, const void *buf, size_t len, int flags) {
+    ++g_syscall_count;
+    return __real_send(sockfd, buf, len, flags);
+}
+
+ssize_t __wrap_recv(int sockfd, void *buf, size_t len, int flags) {
+    ++g_syscall_count;
+    return __real_recv(sockfd, buf, len, flags);
+}
+
+ssize_t __wrap_sendto(int sockfd, const void *buf, size_t len, int flags, const struct sockaddr *addr, socklen_t addr_len) {
+    ++g_syscall_count;
+    return __real_sendto(sockfd, buf, len, flags, addr, addr_len);
+}
+
+ssize_t __wrap_recvfrom(int sockfd, void *buf, size_t len, int flags, struct sockaddr *addr, socklen_t *addr_len) {
+    ++g_syscall_count;
+    return __real_recvfrom(sockfd, buf, len, flags, addr, addr_len);
+}
+
+int __wrap_sendmmsg(int sockfd, struct mmsghdr *msgs, unsigned int vlen, int flags) {
+    ++g_syscall_count;
+    return __real_sendmmsg(sockfd, msgs, vlen, flags);
+}
+
+int __wrap_recvmmsg(int sockfd, struct mmsghdr *msgs, unsigned int vlen, int flags, struct timespec *timeout) {
+    ++g_syscall_count;
+    return __real_recvmmsg(sockfd, msgs, vlen, flags, timeout);
+}
+
+int __wrap_epoll_wait(int epollfd, struct epoll_event *events, int maxevents, int timeout) {
+    ++g_syscall_count;
+    return __real_epoll_wait(epollfd, events, maxevents, timeout);
+}
+
+int __wrap_epoll_ctl(int epollfd, int op, int fd, struct epoll_event *event) {
+    ++g_syscall_count;
+    return __real_epoll_ctl(epollfd, op, fd, event);
+}
+
+int __wrap_socket(int domain, int type, int protocol) {
+    ++g_syscall_count;
+    return __real_socket(domain, type, protocol);
+}
+
+int __wrap_connect(int sockfd, const struct sockaddr *addr, socklen_t addr_len) {
+    ++g_syscall_count;
+    return __real_connect(sockfd, addr, addr_len);
+}
+
+int __wrap_close(int fd) {
+    ++g_syscall_count;
+    return __real_close(fd);
+}
+
+// The responder calls the real functions so that only the library's system calls are counted.
+static void *responder_run(void *const arg) {
+    RESPONDER *const responder = arg;
+
+    struct pollfd pollfds[RESPONDER_PORT_MAX];
+
+    for (size_t i = 0; i < responder->port_count; ++i) {
+        pollfds[i].fd     = responder->sockfds[i];
+        pollfds[i].events = POLLIN;
+    }
+
+    while (!responder->stop) {
+        // Lets the responder thread notice it was stopped.
+        if (poll(pollfds, responder->port_count, 100) <= 0)
+            continue;
+
+        for (size_t i = 0; i < responder->port_count; ++i) {
+            if (!(pollfds[i].revents & POLLIN))
+                continue;
+
+            uint8_t            request[64];
+            struct sockaddr_in peer;
+            socklen_t          peer_len = sizeof (peer);
+
+            while (__real_recvfrom(responder->sockfds[i], request, sizeof (request), MSG_DONTWAIT, (struct sockaddr *)&peer, &peer_len) != -1) {
+                for (size_t j = 0; j < responder->datagram_count; ++j)
+                    __real_sendto(responder->sockfds[i], responder->datagrams[j], responder->datagram_lens[j], 0, (struct sockaddr *)&peer, peer_len);
+
+                peer_len = sizeof (peer);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+void responder_start(RESPONDER *const responder, const char *const filenames[], const size_t port_count) {
+    responder->datagram_count = 0;
+    responder->port_count     = 0;
+    responder->stop           = false;
+
+    for (; *filenames != NULL && responder->datagram_count < RESPONDER_DATAGRAM_MAX; ++filenames) {
+        const int fd = open(*filenames, O_RDONLY);
+        if (fd == -1)
+            err(EXIT_FAILURE, "open: %s", *filenames);
+
+        const ssize_t len = read(fd, responder->datagrams[responder->datagram_count], RESPONDER_DATAGRAM_SIZE);
+        if (len == -1)
+            err(EXIT_FAILURE, "read: %s", *filenames);
+
+        close(fd);
+        responder->datagram_lens[responder->datagram_count++] = len;
+    }
+
+    for (; responder->port_count < port_count && responder->port_count < RESPONDER_PORT_MAX; ++(responder->port_count)) {
+        const int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (sockfd == -1)
+            err(EXIT_FAILURE, "socket");
+
+        struct sockaddr_in addr = { 0 };
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (bind(sockfd, (struct sockaddr *)&addr, sizeof (addr)) == -1)
+            err(EXIT_FAILURE, "bind");
+
+        socklen_t addr_len = sizeof (addr);
+        if (getsockname(sockfd, (struct sockaddr *)&addr, &addr_len) == -1)
+            err(EXIT_FAILURE, "getsockname");
+
+        const int rcvbuf = 4 * 1024 * 1024;
+        setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof (rcvbuf));
+
+        responder->sockfds[responder->port_count] = sockfd;
+        responder->ports[responder->port_count]   = ntohs(addr.sin_port);
+    }
+
+    if (pthread_create(&(responder->thread), NULL, responder_run, responder) != 0)
+        errx(EXIT_FAILURE, "pthread_create");
+}
+
+void responder_stop(RESPONDER *const responder) {
+    responder->stop = true;
+    pthread_join(responder->thread, NULL);
+
+    for (size_t i = 0; i < responder->port_count; ++i)
+        close(responder->sockfds[i]);
+}
+
+double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void bench_report(const char name[], const size_t iterations, const double elapsed, const size_t allocs) {
+    printf(
+        "%-24s %8zu queries %10.2f us/query %8.2f allocs/query\n",
+        name,
+        iterations,
+        elapsed * 1e6 / iterations,
+        (double)allocs / iterations
+    );
+}
@@ -58,10 +58,15 @@ int main(int argc, char *argv[]) {
     // Asserts that the memory allocation was successful.
     assert(querier != NULL);
 
-    /* Sets the timeout for both receiving and sending operations to 3000 ms.
-     * If this function is *not* called, the timeouts for receiving/sending operations will be set to the
-     * default values of `SSQ_TIMEOUT_RECV_DEFAULT_VALUE' and `SSQ_TIMEOUT_SEND_DEFAULT_VALUE' respectively. */
-    ssq_set_timeout(querier, SSQ_TIMEOUT_RECV | SSQ_TIMEOUT_SEND, 3000);
+    /* Sets the timeout for both receiving and sending operations, as well as for whole queries, to 3000 ms.
+     * If this function is *not* called, the timeouts for receiving/sending operations and queries will be set to the
+     * default values of `SSQ_TIMEOUT_RECV_DEFAULT_VALUE', `SSQ_TIMEOUT_SEND_DEFAULT_VALUE' and
+     * `SSQ_TIMEOUT_QUERY_DEFAULT_VALUE' respectively. */
+    ssq_set_timeout(querier, SSQ_TIMEOUT_RECV | SSQ_TIMEOUT_SEND | SSQ_TIMEOUT_QUERY, 3000);
+
+    /* Sends each request up to 3 times should it get lost, instead of waiting for the whole query timeout.
+     * The retransmission timeout adapts to the round-trip times measured to the target. */
+    ssq_set_max_attempts(querier, 3);
 
     // Sets the Source server querier's target.
     ssq_set_target(querier, hostname, port);
@@ -1,3 +1,4 @@
 #include "ssq/a2s/info.h"
 #include "ssq/a2s/player.h"
 #include "ssq/a2s/rules.h"
+#include "ssq/snapshot.h"
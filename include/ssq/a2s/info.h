@@ -1,6 +1,7 @@
 #ifndef SSQ_A2S_INFO_H
 #define SSQ_A2S_INFO_H
 
+#include "ssq/buf.h"
 #include "ssq/ssq.h"
 
 #define A2S_INFO_FLAG_GAMEID   0x01
@@ -9,6 +10,34 @@
 #define A2S_INFO_FLAG_STEAMID  0x10
 #define A2S_INFO_FLAG_STV      0x40
 
+/* Fields of an A2S_INFO response to read, in the order of the wire format. */
+#define A2S_INFO_FIELD_PROTOCOL    0x000001
+#define A2S_INFO_FIELD_NAME        0x000002
+#define A2S_INFO_FIELD_MAP         0x000004
+#define A2S_INFO_FIELD_FOLDER      0x000008
+#define A2S_INFO_FIELD_GAME        0x000010
+#define A2S_INFO_FIELD_ID          0x000020
+#define A2S_INFO_FIELD_PLAYERS     0x000040
+#define A2S_INFO_FIELD_MAX_PLAYERS 0x000080
+#define A2S_INFO_FIELD_BOTS        0x000100
+#define A2S_INFO_FIELD_SERVER_TYPE 0x000200
+#define A2S_INFO_FIELD_ENVIRONMENT 0x000400
+#define A2S_INFO_FIELD_VISIBILITY  0x000800
+#define A2S_INFO_FIELD_VAC         0x001000
+#define A2S_INFO_FIELD_VERSION     0x002000
+#define A2S_INFO_FIELD_EDF         0x004000
+#define A2S_INFO_FIELD_PORT        0x008000
+#define A2S_INFO_FIELD_STEAMID     0x010000
+#define A2S_INFO_FIELD_STV_PORT    0x020000
+#define A2S_INFO_FIELD_STV_NAME    0x040000
+#define A2S_INFO_FIELD_KEYWORDS    0x080000
+#define A2S_INFO_FIELD_GAMEID      0x100000
+#define A2S_INFO_FIELD_ALL         0x1FFFFF
+
+#define A2S_INFO_PAYLOAD_LEN 29
+
+#define S2A_HEADER_INFO 0x49
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -56,8 +85,61 @@ typedef struct a2s_info {
     char           *keywords;     /** Tags that describe the game according to the server      */
     size_t          keywords_len; /** Length of the `keywords' string                          */
     uint64_t        gameid;       /** The server's 64-bit GameID                               */
+    uint32_t        fields;       /** Fields read from the response, as `A2S_INFO_FIELD_*'     */
 } A2S_INFO;
 
+/*
+ * Fields of an A2S_INFO response whose strings are borrowed from the response buffer.
+ * The strings of the EDF which are missing from the response have no `str'.
+ */
+typedef struct a2s_info_ref {
+    uint8_t         protocol;    /** Protocol version used by the server                      */
+    SSQ_STRING_VIEW name;        /** Name of the server                                       */
+    SSQ_STRING_VIEW map;         /** Map the server has currently loaded                      */
+    SSQ_STRING_VIEW folder;      /** Name of the folder containing the game files             */
+    SSQ_STRING_VIEW game;        /** Full name of the game                                    */
+    uint16_t        id;          /** Steam Application ID of game                             */
+    uint8_t         players;     /** Number of players on the server                          */
+    uint8_t         max_players; /** Maximum number of players the server reports it can hold */
+    uint8_t         bots;        /** Number of bots on the server                             */
+    A2S_SERVER_TYPE server_type; /** The type of server                                       */
+    A2S_ENVIRONMENT environment; /** The operating system of the server                       */
+    bool            visibility;  /** Whether the server requires a password                   */
+    bool            vac;         /** Whether the server uses VAC                              */
+    SSQ_STRING_VIEW version;     /** Version of the game installed on the server              */
+    uint8_t         edf;         /** Extra Data Flag                                          */
+    uint16_t        port;        /** The server's game port number                            */
+    uint64_t        steamid;     /** Server's SteamID                                         */
+    uint16_t        stv_port;    /** Spectator port number for SourceTV                       */
+    SSQ_STRING_VIEW stv_name;    /** Name of the spectator server for SourceTV                */
+    SSQ_STRING_VIEW keywords;    /** Tags that describe the game according to the server      */
+    uint64_t        gameid;      /** The server's 64-bit GameID                               */
+} A2S_INFO_REF;
+
+/*
+ * A2S_INFO response read in place, whose fields are all borrowed from the response buffer.
+ * Opening a view locates the strings preceding the EDF in a single pass, the fixed-size fields being
+ * read from the response when asked for, and the EDF and the fields it flags being decoded on first access.
+ */
+typedef struct a2s_info_view {
+    const uint8_t  *protocol;    /** Byte of the protocol version                                 */
+    SSQ_STRING_VIEW name;        /** Name of the server                                           */
+    SSQ_STRING_VIEW map;         /** Map the server has currently loaded                          */
+    SSQ_STRING_VIEW folder;      /** Name of the folder containing the game files                 */
+    SSQ_STRING_VIEW game;        /** Full name of the game                                        */
+    const uint8_t  *details;     /** Bytes of the fields from the Steam Application ID to VAC     */
+    SSQ_STRING_VIEW version;     /** Version of the game installed on the server                  */
+    SSQ_BUF         trailer;     /** Bytes following the version, starting with the EDF           */
+    bool            edf_decoded; /** Whether the EDF and the fields it flags were decoded         */
+    uint8_t         edf;         /** Extra Data Flag, once decoded                                */
+    uint16_t        port;        /** The server's game port number, once decoded                  */
+    uint64_t        steamid;     /** Server's SteamID, once decoded                               */
+    uint16_t        stv_port;    /** Spectator port number for SourceTV, once decoded             */
+    SSQ_STRING_VIEW stv_name;    /** Name of the spectator server for SourceTV, once decoded      */
+    SSQ_STRING_VIEW keywords;    /** Tags that describe the game, once decoded                    */
+    uint64_t        gameid;      /** The server's 64-bit GameID, once decoded                     */
+} A2S_INFO_VIEW;
+
 /**
  * Sends an A2S_INFO query to a Source game server.
  *
@@ -69,7 +151,147 @@ typedef struct a2s_info {
 A2S_INFO *ssq_info(SSQ_QUERIER *querier);
 
 /**
- * Frees an `A2S_INFO' struct.
+ * Sends an A2S_INFO query to a Source game server and overwrites a previous result with the response.
+ * The result is reused as long as the new strings fit in the memory it holds, so polling a server
+ * allocates nothing once its strings stopped growing.
+ *
+ * @param querier Source server querier to use
+ * @param reuse   `A2S_INFO' struct returned by a previous query, or NULL
+ *
+ * @return `reuse' or a larger dynamically-allocated `A2S_INFO' struct, in which case `reuse' is freed,
+ *         or NULL if there was an error, in which case `reuse' is left intact for the caller to keep or free
+ */
+A2S_INFO *ssq_info_into(SSQ_QUERIER *querier, A2S_INFO *reuse);
+
+/**
+ * Sends an A2S_INFO query to a Source game server and reads some fields of the response only.
+ * The strings left out are read past without being copied, and the fields left out are NULL or 0.
+ * The EDF is read along with any of the fields it flags, so that `ssq_info_has_*' agree with them.
+ *
+ * @param querier Source server querier to use
+ * @param fields  `A2S_INFO_FIELD_*' flags of the fields to read
+ *
+ * @return dynamically-allocated `A2S_INFO' struct containing the fields read, or NULL if there was an error
+ */
+A2S_INFO *ssq_info_ex(SSQ_QUERIER *querier, uint32_t fields);
+
+/**
+ * Builds the payload of an A2S_INFO query.
+ *
+ * @param payload where to store the payload
+ * @param chall   challenge number to send, or `A2S_CHALLENGE_NONE'
+ *
+ * @return length of the payload
+ */
+size_t ssq_info_payload(uint8_t payload[A2S_INFO_PAYLOAD_LEN], int32_t chall);
+
+/**
+ * Deserializes an A2S_INFO response.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param err          where to report potential errors
+ *
+ * @return dynamically-allocated `A2S_INFO' struct, or NULL if there was an error.
+ *         The struct and its strings are held by a single allocation.
+ */
+A2S_INFO *ssq_info_deserialize(const uint8_t *response, size_t response_len, SSQ_ERROR *err);
+
+/**
+ * Deserializes an A2S_INFO response into a previous result, which is reused if the new strings fit in it.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param reuse        `A2S_INFO' struct returned by a previous deserialization or query, or NULL
+ * @param err          where to report potential errors
+ *
+ * @return `reuse' or a larger dynamically-allocated `A2S_INFO' struct, in which case `reuse' is freed,
+ *         or NULL if there was an error, in which case `reuse' is left intact for the caller to keep or free
+ */
+A2S_INFO *ssq_info_deserialize_into(const uint8_t *response, size_t response_len, A2S_INFO *reuse, SSQ_ERROR *err);
+
+/**
+ * Deserializes some fields of an A2S_INFO response.
+ * The strings left out are read past without being copied, and the fields left out are NULL or 0.
+ * The EDF is read along with any of the fields it flags, so that `ssq_info_has_*' agree with them.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param fields       `A2S_INFO_FIELD_*' flags of the fields to read
+ * @param err          where to report potential errors
+ *
+ * @return dynamically-allocated `A2S_INFO' struct, or NULL if there was an error.
+ *         The struct and the strings read are held by a single allocation.
+ */
+A2S_INFO *ssq_info_deserialize_ex(const uint8_t *response, size_t response_len, uint32_t fields, SSQ_ERROR *err);
+
+/**
+ * Deserializes an A2S_INFO response without allocating: the strings are borrowed from the response.
+ *
+ * @param response     response buffer, which must outlive `info'
+ * @param response_len length of the response
+ * @param info         where to store the fields of the response
+ * @param err          where to report potential errors
+ *
+ * @return false if there was an error
+ */
+bool ssq_info_deserialize_view(const uint8_t *response, size_t response_len, A2S_INFO_REF *info, SSQ_ERROR *err);
+
+/**
+ * Opens a view on an A2S_INFO response, such as the one returned by `ssq_query', without copying it.
+ *
+ * @param response     response buffer, which must outlive `view'
+ * @param response_len length of the response
+ * @param view         view to open
+ * @param err          where to report potential errors
+ *
+ * @return false if there was an error
+ */
+bool ssq_info_view_open(const uint8_t *response, size_t response_len, A2S_INFO_VIEW *view, SSQ_ERROR *err);
+
+/*
+ * Fields of an A2S_INFO response read through a view. The strings are borrowed from the response
+ * and are empty if it was truncated before them, and the missing numbers read as zero.
+ * The first access to the EDF or to one of its fields decodes them all.
+ */
+uint8_t ssq_info_view_protocol(const A2S_INFO_VIEW *view);
+SSQ_STRING_VIEW ssq_info_view_name(const A2S_INFO_VIEW *view);
+SSQ_STRING_VIEW ssq_info_view_map(const A2S_INFO_VIEW *view);
+SSQ_STRING_VIEW ssq_info_view_folder(const A2S_INFO_VIEW *view);
+SSQ_STRING_VIEW ssq_info_view_game(const A2S_INFO_VIEW *view);
+uint16_t ssq_info_view_id(const A2S_INFO_VIEW *view);
+uint8_t ssq_info_view_players(const A2S_INFO_VIEW *view);
+uint8_t ssq_info_view_max_players(const A2S_INFO_VIEW *view);
+uint8_t ssq_info_view_bots(const A2S_INFO_VIEW *view);
+A2S_SERVER_TYPE ssq_info_view_server_type(const A2S_INFO_VIEW *view);
+A2S_ENVIRONMENT ssq_info_view_environment(const A2S_INFO_VIEW *view);
+bool ssq_info_view_visibility(const A2S_INFO_VIEW *view);
+bool ssq_info_view_vac(const A2S_INFO_VIEW *view);
+SSQ_STRING_VIEW ssq_info_view_version(const A2S_INFO_VIEW *view);
+uint8_t ssq_info_view_edf(A2S_INFO_VIEW *view);
+uint16_t ssq_info_view_port(A2S_INFO_VIEW *view);
+uint64_t ssq_info_view_steamid(A2S_INFO_VIEW *view);
+uint16_t ssq_info_view_stv_port(A2S_INFO_VIEW *view);
+SSQ_STRING_VIEW ssq_info_view_stv_name(A2S_INFO_VIEW *view);
+SSQ_STRING_VIEW ssq_info_view_keywords(A2S_INFO_VIEW *view);
+uint64_t ssq_info_view_gameid(A2S_INFO_VIEW *view);
+
+/**
+ * Serializes the fields of an A2S_INFO response, starting at its response header.
+ * The 0xFFFFFFFF header a server prepends to a single-packet response is not written: prepend it before sending the response.
+ * The EDF and the fields it flags are left out if no flag is set.
+ * Nothing is written past `response_size' bytes, but the length of the whole response is returned in any case.
+ *
+ * @param info          fields of the response
+ * @param response      where to write the response, starting with its response header, or NULL to compute its length only
+ * @param response_size number of bytes `response' can hold
+ *
+ * @return length of the response
+ */
+size_t ssq_info_serialize(const A2S_INFO_REF *info, uint8_t *response, size_t response_size);
+
+/**
+ * Frees an `A2S_INFO' struct along with its strings.
  * @param info `A2S_INFO' struct to free
  */
 void ssq_info_free(A2S_INFO *info);
@@ -1,8 +1,13 @@
 #ifndef SSQ_A2S_PLAYER_H
 #define SSQ_A2S_PLAYER_H
 
+#include "ssq/buf.h"
 #include "ssq/ssq.h"
 
+#define A2S_PLAYER_PAYLOAD_LEN 9
+
+#define S2A_HEADER_PLAYER 0x44
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,6 +20,24 @@ typedef struct a2s_player {
     float   duration; /** Time (in seconds) player has been connected to the server */
 } A2S_PLAYER;
 
+/* Player of an A2S_PLAYER response whose name is borrowed from the response buffer. */
+typedef struct a2s_player_ref {
+    uint8_t         index;    /** Index of player chunk starting from 0                     */
+    SSQ_STRING_VIEW name;     /** Name of the player                                        */
+    int32_t         score;    /** Player's score (usually "frags" or "kills")               */
+    float           duration; /** Time (in seconds) player has been connected to the server */
+} A2S_PLAYER_REF;
+
+/**
+ * Function called on each player of an A2S_PLAYER response as it is read.
+ *
+ * @param player    player, whose strings are borrowed from the response and only valid during the call
+ * @param user_data user data given along with the function
+ *
+ * @return false to stop the walk
+ */
+typedef bool (*SSQ_PLAYER_CALLBACK)(const A2S_PLAYER_REF *player, void *user_data);
+
 /**
  * Sends an A2S_PLAYER query to a Source game server.
  *
@@ -27,10 +50,111 @@ typedef struct a2s_player {
 A2S_PLAYER *ssq_player(SSQ_QUERIER *querier, uint8_t *player_count);
 
 /**
- * Frees an `A2S_PLAYER' array.
+ * Sends an A2S_PLAYER query to a Source game server and overwrites a previous result with the response.
+ * The array is reused as long as the new players and their names fit in the memory it holds, and is kept
+ * when there are no players, so polling a server allocates nothing once its player list stopped growing.
+ *
+ * @param querier      Source server querier to use
+ * @param reuse        `A2S_PLAYER' array returned by a previous query, or NULL
+ * @param player_count where to store the number of players in the output array
+ *
+ * @return `reuse' or a larger dynamically-allocated `A2S_PLAYER' array, in which case `reuse' is freed,
+ *         or NULL if an error occurred, in which case `reuse' and the count are left intact for the caller to keep or free
+ */
+A2S_PLAYER *ssq_player_into(SSQ_QUERIER *querier, A2S_PLAYER *reuse, uint8_t *player_count);
+
+/**
+ * Builds the payload of an A2S_PLAYER query.
+ *
+ * @param payload where to store the payload
+ * @param chall   challenge number to send, or `A2S_CHALLENGE_NONE'
+ *
+ * @return length of the payload
+ */
+size_t ssq_player_payload(uint8_t payload[A2S_PLAYER_PAYLOAD_LEN], int32_t chall);
+
+/**
+ * Deserializes an A2S_PLAYER response.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param player_count where to store the number of players in the output array
+ * @param err          where to report potential errors
+ *
+ * @return dynamically-allocated `A2S_PLAYER' array, or NULL if an error occurred or there are no players.
+ *         The array and the names of the players are held by a single allocation.
+ */
+A2S_PLAYER *ssq_player_deserialize(const uint8_t *response, size_t response_len, uint8_t *player_count, SSQ_ERROR *err);
+
+/**
+ * Deserializes an A2S_PLAYER response into a previous result, which is reused if the new players fit in it.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param reuse        `A2S_PLAYER' array returned by a previous deserialization or query, or NULL
+ * @param player_count where to store the number of players in the output array
+ * @param err          where to report potential errors
+ *
+ * @return `reuse' or a larger dynamically-allocated `A2S_PLAYER' array, in which case `reuse' is freed,
+ *         or NULL if an error occurred, in which case `reuse' and the count are left intact for the caller to keep or free
+ */
+A2S_PLAYER *ssq_player_deserialize_into(const uint8_t *response, size_t response_len, A2S_PLAYER *reuse, uint8_t *player_count, SSQ_ERROR *err);
+
+/**
+ * Deserializes an A2S_PLAYER response without copying the names of the players, which are borrowed from the response.
+ *
+ * @param response      response buffer, which must outlive the output array
+ * @param response_len  length of the response
+ * @param storage       array to store the players in, or NULL
+ * @param storage_count number of players `storage' can hold
+ * @param player_count  where to store the number of players in the output array
+ * @param err           where to report potential errors
+ *
+ * @return `storage' if it can hold every player, otherwise a dynamically-allocated `A2S_PLAYER_REF' array
+ *         to free with `ssq_mem_free', or NULL if an error occurred or there are no players
+ */
+A2S_PLAYER_REF *ssq_player_deserialize_view(const uint8_t *response, size_t response_len, A2S_PLAYER_REF *storage, size_t storage_count, uint8_t *player_count, SSQ_ERROR *err);
+
+/**
+ * Sends an A2S_PLAYER query to a Source game server and calls a function on each player of the response,
+ * without building an array of players.
+ *
+ * @param querier   Source server querier to use
+ * @param callback  function to call on each player, which may stop the walk early
+ * @param user_data user data to give to `callback'
+ */
+void ssq_player_foreach(SSQ_QUERIER *querier, SSQ_PLAYER_CALLBACK callback, void *user_data);
+
+/**
+ * Walks an A2S_PLAYER response and calls a function on each of its players, without allocating.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param callback     function to call on each player, which may stop the walk early
+ * @param user_data    user data to give to `callback'
+ * @param err          where to report potential errors
+ */
+void ssq_player_deserialize_foreach(const uint8_t *response, size_t response_len, SSQ_PLAYER_CALLBACK callback, void *user_data, SSQ_ERROR *err);
+
+/**
+ * Serializes the players of an A2S_PLAYER response, starting at its response header.
+ * The 0xFFFFFFFF header a server prepends to a single-packet response is not written: prepend it before sending the response.
+ * Nothing is written past `response_size' bytes, but the length of the whole response is returned in any case.
+ *
+ * @param players       players of the response
+ * @param player_count  number of players
+ * @param response      where to write the response, starting with its response header, or NULL to compute its length only
+ * @param response_size number of bytes `response' can hold
+ *
+ * @return length of the response
+ */
+size_t ssq_player_serialize(const A2S_PLAYER_REF *players, uint8_t player_count, uint8_t *response, size_t response_size);
+
+/**
+ * Frees an `A2S_PLAYER' array along with the names of the players.
  *
  * @param players      `A2S_PLAYER' array to free
- * @param player_count number of players in the `A2S_PLAYER' array
+ * @param player_count number of players in the `A2S_PLAYER' array, kept for source compatibility
  */
 void ssq_player_free(A2S_PLAYER *players, uint8_t player_count);
 
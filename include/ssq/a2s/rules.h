@@ -1,8 +1,13 @@
 #ifndef SSQ_A2S_RULES_H
 #define SSQ_A2S_RULES_H
 
+#include "ssq/buf.h"
 #include "ssq/ssq.h"
 
+#define A2S_RULES_PAYLOAD_LEN 9
+
+#define S2A_HEADER_RULES 0x45
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -14,6 +19,22 @@ typedef struct a2s_rules {
     size_t value_len; /** Length of the `value' string */
 } A2S_RULES;
 
+/* Rule of an A2S_RULES response whose name and value are borrowed from the response buffer. */
+typedef struct a2s_rules_ref {
+    SSQ_STRING_VIEW name;  /** Name of the rule  */
+    SSQ_STRING_VIEW value; /** Value of the rule */
+} A2S_RULES_REF;
+
+/**
+ * Function called on each rule of an A2S_RULES response as it is read.
+ *
+ * @param rule      rule, whose strings are borrowed from the response and only valid during the call
+ * @param user_data user data given along with the function
+ *
+ * @return false to stop the walk
+ */
+typedef bool (*SSQ_RULES_CALLBACK)(const A2S_RULES_REF *rule, void *user_data);
+
 /**
  * Sends an A2S_RULES query to a Source game server.
  *
@@ -26,10 +47,111 @@ typedef struct a2s_rules {
 A2S_RULES *ssq_rules(SSQ_QUERIER *querier, uint16_t *rule_count);
 
 /**
- * Frees an `A2S_RULES' array.
+ * Sends an A2S_RULES query to a Source game server and overwrites a previous result with the response.
+ * The array is reused as long as the new rules and their strings fit in the memory it holds, and is kept
+ * when there are no rules, so polling a server allocates nothing once its rules stopped growing.
+ *
+ * @param querier    Source server querier to use
+ * @param reuse      `A2S_RULES' array returned by a previous query, or NULL
+ * @param rule_count where to store the number of rules in the output array
+ *
+ * @return `reuse' or a larger dynamically-allocated `A2S_RULES' array, in which case `reuse' is freed,
+ *         or NULL if an error occurred, in which case `reuse' and the count are left intact for the caller to keep or free
+ */
+A2S_RULES *ssq_rules_into(SSQ_QUERIER *querier, A2S_RULES *reuse, uint16_t *rule_count);
+
+/**
+ * Builds the payload of an A2S_RULES query.
+ *
+ * @param payload where to store the payload
+ * @param chall   challenge number to send, or `A2S_CHALLENGE_NONE'
+ *
+ * @return length of the payload
+ */
+size_t ssq_rules_payload(uint8_t payload[A2S_RULES_PAYLOAD_LEN], int32_t chall);
+
+/**
+ * Deserializes an A2S_RULES response.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param rule_count   where to store the number of rules in the output array
+ * @param err          where to report potential errors
+ *
+ * @return dynamically-allocated `A2S_RULES' array, or NULL if an error occurred or there are no rules.
+ *         The array and the names and values of the rules are held by a single allocation.
+ */
+A2S_RULES *ssq_rules_deserialize(const uint8_t *response, size_t response_len, uint16_t *rule_count, SSQ_ERROR *err);
+
+/**
+ * Deserializes an A2S_RULES response into a previous result, which is reused if the new rules fit in it.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param reuse        `A2S_RULES' array returned by a previous deserialization or query, or NULL
+ * @param rule_count   where to store the number of rules in the output array
+ * @param err          where to report potential errors
+ *
+ * @return `reuse' or a larger dynamically-allocated `A2S_RULES' array, in which case `reuse' is freed,
+ *         or NULL if an error occurred, in which case `reuse' and the count are left intact for the caller to keep or free
+ */
+A2S_RULES *ssq_rules_deserialize_into(const uint8_t *response, size_t response_len, A2S_RULES *reuse, uint16_t *rule_count, SSQ_ERROR *err);
+
+/**
+ * Deserializes an A2S_RULES response without copying the names and values of the rules, which are borrowed from the response.
+ *
+ * @param response      response buffer, which must outlive the output array
+ * @param response_len  length of the response
+ * @param storage       array to store the rules in, or NULL
+ * @param storage_count number of rules `storage' can hold
+ * @param rule_count    where to store the number of rules in the output array
+ * @param err           where to report potential errors
+ *
+ * @return `storage' if it can hold every rule, otherwise a dynamically-allocated `A2S_RULES_REF' array
+ *         to free with `ssq_mem_free', or NULL if an error occurred or there are no rules
+ */
+A2S_RULES_REF *ssq_rules_deserialize_view(const uint8_t *response, size_t response_len, A2S_RULES_REF *storage, size_t storage_count, uint16_t *rule_count, SSQ_ERROR *err);
+
+/**
+ * Sends an A2S_RULES query to a Source game server and calls a function on each rule of the response,
+ * without building an array of rules.
+ *
+ * @param querier   Source server querier to use
+ * @param callback  function to call on each rule, which may stop the walk early
+ * @param user_data user data to give to `callback'
+ */
+void ssq_rules_foreach(SSQ_QUERIER *querier, SSQ_RULES_CALLBACK callback, void *user_data);
+
+/**
+ * Walks an A2S_RULES response and calls a function on each of its rules, without allocating.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param callback     function to call on each rule, which may stop the walk early
+ * @param user_data    user data to give to `callback'
+ * @param err          where to report potential errors
+ */
+void ssq_rules_deserialize_foreach(const uint8_t *response, size_t response_len, SSQ_RULES_CALLBACK callback, void *user_data, SSQ_ERROR *err);
+
+/**
+ * Serializes the rules of an A2S_RULES response, starting at its response header.
+ * The 0xFFFFFFFF header a server prepends to a single-packet response is not written: prepend it before sending the response.
+ * Nothing is written past `response_size' bytes, but the length of the whole response is returned in any case.
+ *
+ * @param rules         rules of the response
+ * @param rule_count    number of rules
+ * @param response      where to write the response, starting with its response header, or NULL to compute its length only
+ * @param response_size number of bytes `response' can hold
+ *
+ * @return length of the response
+ */
+size_t ssq_rules_serialize(const A2S_RULES_REF *rules, uint16_t rule_count, uint8_t *response, size_t response_size);
+
+/**
+ * Frees an `A2S_RULES' array along with the names and values of the rules.
  *
  * @param rules      `A2S_RULES' array to free
- * @param rule_count number of rules in the `A2S_RULES' array
+ * @param rule_count number of rules in the `A2S_RULES' array, kept for source compatibility
  */
 void ssq_rules_free(A2S_RULES *rules, uint16_t rule_count);
 
@@ -0,0 +1,93 @@
+#ifndef SSQ_BATCH_H
+#define SSQ_BATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include "ssq/error.h"
+#include "ssq/packet.h"
+
+#define SSQ_BATCH_CAPACITY_DEFAULT_VALUE 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct mmsghdr;
+struct iovec;
+
+typedef struct ssq_batch {
+    size_t                    capacity; /** Number of slots                                     */
+    size_t                    count;    /** Number of slots filled                              */
+    uint8_t                 (*slots)[SSQ_PACKET_SIZE];
+    uint16_t                 *lens;     /** Length of the datagram held by each slot            */
+    struct sockaddr_storage  *addrs;    /** Source or destination address of each slot          */
+    struct mmsghdr           *msgs;
+    struct iovec             *iovecs;
+} SSQ_BATCH;
+
+/**
+ * Initializes a batch of datagram slots, each of which holds a datagram of at most
+ * `SSQ_PACKET_SIZE' bytes. Batches are sent with one `sendmmsg' and received with one `recvmmsg' (Linux only).
+ *
+ * @param batch    batch to initialize
+ * @param capacity number of slots
+ * @param err      where to report potential errors
+ */
+void ssq_batch_init(SSQ_BATCH *batch, size_t capacity, SSQ_ERROR *err);
+
+/**
+ * Frees the slots of a batch.
+ * @param batch batch to free
+ */
+void ssq_batch_free(SSQ_BATCH *batch);
+
+/**
+ * Empties a batch without freeing its slots.
+ * @param batch batch to empty
+ */
+void ssq_batch_clear(SSQ_BATCH *batch);
+
+/**
+ * Copies a datagram into the next free slot of a batch.
+ *
+ * @param batch        batch
+ * @param datagram     datagram to queue
+ * @param datagram_len length of the datagram
+ * @param addr         destination address, or NULL if the socket the batch is sent on is connected
+ * @param addr_len     length of the destination address
+ *
+ * @return false if the batch is full or the datagram is larger than a slot
+ */
+bool ssq_batch_push(SSQ_BATCH *batch, const uint8_t *datagram, size_t datagram_len, const struct sockaddr *addr, socklen_t addr_len);
+
+/**
+ * Sends the datagrams queued in a batch, in as few `sendmmsg' calls as the kernel allows, and empties it.
+ * A datagram the kernel refuses is dropped as if it were lost, and the error is reported.
+ *
+ * @param batch  batch to send
+ * @param sockfd socket to send the datagrams on
+ * @param err    where to report potential errors
+ *
+ * @return number of datagrams sent
+ */
+size_t ssq_batch_send(SSQ_BATCH *batch, int sockfd, SSQ_ERROR *err);
+
+/**
+ * Receives the datagrams queued on a socket into the slots of a batch, without blocking.
+ * The datagrams can then be parsed in place from `batch->slots'.
+ *
+ * @param batch  batch to fill
+ * @param sockfd socket to receive the datagrams from
+ * @param err    where to report potential errors
+ *
+ * @return number of datagrams received, which is less than the capacity of the batch once the socket is drained
+ */
+size_t ssq_batch_recv(SSQ_BATCH *batch, int sockfd, SSQ_ERROR *err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_BATCH_H */
@@ -4,6 +4,9 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#define SSQ_BUF_RESERVE_MAX 32 /* most bytes reserved at once by `ssq_buf_reserve' */
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,6 +18,11 @@ typedef struct ssq_buf {
     size_t         cursor;
 } SSQ_BUF;
 
+typedef struct ssq_string_view {
+    const char *str; /** Start of the string, borrowed from the buffer it was read from */
+    size_t      len; /** Length of the string                                           */
+} SSQ_STRING_VIEW;
+
 /**
  * Initializes a byte buffer.
  *
@@ -135,6 +143,28 @@ double ssq_buf_get_double(SSQ_BUF *buf);
  */
 bool ssq_buf_get_bool(SSQ_BUF *buf);
 
+/**
+ * Finds the first null byte among N bytes, reading none past them.
+ * The bytes are scanned 32 at a time with AVX2 if the CPU supports it, otherwise 16 at a time with SSE2,
+ * or one at a time on other architectures.
+ *
+ * @param src bytes to scan
+ * @param n   number of bytes to scan
+ *
+ * @return offset of the first null byte, or N if there is none
+ */
+size_t ssq_buf_scan_nul(const uint8_t *src, size_t n);
+
+/**
+ * Computes the length of the null-terminated string at a byte buffer's current position.
+ * If there is no null terminator, the string is considered to end at the end of the byte buffer.
+ *
+ * @param buf byte buffer
+ *
+ * @return length of the string at the byte buffer's current position
+ */
+size_t ssq_buf_get_string_len(const SSQ_BUF *buf);
+
 /**
  * Reads a null-terminated string from a byte buffer.
  *
@@ -145,6 +175,109 @@ bool ssq_buf_get_bool(SSQ_BUF *buf);
  */
 char *ssq_buf_get_string(SSQ_BUF *buf, size_t *len);
 
+/**
+ * Computes the size of an arena large enough to hold N null-terminated strings read from a byte buffer.
+ * Every string takes at most the bytes it spans in the byte buffer, plus a null terminator if it has none.
+ *
+ * @param buf          byte buffer
+ * @param string_count number of strings to read from the byte buffer
+ *
+ * @return size of the arena in bytes
+ */
+size_t ssq_buf_strings_size(const SSQ_BUF *buf, size_t string_count);
+
+/**
+ * Reads a null-terminated string from a byte buffer into an arena.
+ *
+ * @param buf   byte buffer to read from
+ * @param arena where to copy the string, advanced past its null terminator
+ * @param len   where to store the length of the string
+ *
+ * @return copy of the string at the byte buffer's current position, which lives in the arena
+ */
+char *ssq_buf_get_string_into(SSQ_BUF *buf, char **arena, size_t *len);
+
+/**
+ * Reads a null-terminated string from a byte buffer without copying it.
+ * The string is null-terminated in place, unless it is cut by the end of the byte buffer.
+ *
+ * @param buf byte buffer to read from
+ *
+ * @return view of the string at the byte buffer's current position
+ */
+SSQ_STRING_VIEW ssq_buf_get_string_view(SSQ_BUF *buf);
+
+/* Zeroes handed out by `ssq_buf_reserve' in place of the bytes missing from a byte buffer. */
+extern const uint8_t ssq_buf_zeroes[SSQ_BUF_RESERVE_MAX];
+
+/**
+ * Reserves N bytes of a byte buffer for reads of a fixed-size block of fields, checking the bounds once.
+ * The fields are then read from the returned bytes with the `ssq_buf_load_*' functions, which check nothing.
+ * If fewer bytes are available, the byte buffer is moved to its end and the fields all read as zero.
+ *
+ * @param buf byte buffer
+ * @param n   number of bytes to reserve, at most `SSQ_BUF_RESERVE_MAX'
+ *
+ * @return N bytes to read the fields from
+ */
+static inline const uint8_t *ssq_buf_reserve(SSQ_BUF *const buf, const size_t n) {
+    if (buf->cursor < buf->payload_len && n <= buf->payload_len - buf->cursor) {
+        const uint8_t *const block = buf->payload + buf->cursor;
+        buf->cursor += n;
+        return block;
+    }
+
+    if (buf->cursor < buf->payload_len)
+        buf->cursor = buf->payload_len;
+
+    return ssq_buf_zeroes;
+}
+
+/**
+ * Loads a field from bytes returned by `ssq_buf_reserve', without checking anything.
+ * The bytes need not be aligned for the type of the field, which is read in host byte order.
+ *
+ * @param src bytes to load the field from
+ *
+ * @return value of the field
+ */
+static inline int8_t ssq_buf_load_int8(const uint8_t *const src) { int8_t value; memcpy(&value, src, sizeof (value)); return value; }
+static inline int16_t ssq_buf_load_int16(const uint8_t *const src) { int16_t value; memcpy(&value, src, sizeof (value)); return value; }
+static inline int32_t ssq_buf_load_int32(const uint8_t *const src) { int32_t value; memcpy(&value, src, sizeof (value)); return value; }
+static inline int64_t ssq_buf_load_int64(const uint8_t *const src) { int64_t value; memcpy(&value, src, sizeof (value)); return value; }
+static inline uint8_t ssq_buf_load_uint8(const uint8_t *const src) { return *src; }
+static inline uint16_t ssq_buf_load_uint16(const uint8_t *const src) { uint16_t value; memcpy(&value, src, sizeof (value)); return value; }
+static inline uint32_t ssq_buf_load_uint32(const uint8_t *const src) { uint32_t value; memcpy(&value, src, sizeof (value)); return value; }
+static inline uint64_t ssq_buf_load_uint64(const uint8_t *const src) { uint64_t value; memcpy(&value, src, sizeof (value)); return value; }
+static inline float ssq_buf_load_float(const uint8_t *const src) { float value; memcpy(&value, src, sizeof (value)); return value; }
+static inline double ssq_buf_load_double(const uint8_t *const src) { double value; memcpy(&value, src, sizeof (value)); return value; }
+static inline bool ssq_buf_load_bool(const uint8_t *const src) { return *src != 0; }
+
+/**
+ * Copies a string borrowed from a byte buffer into an arena.
+ *
+ * @param view  string to copy, or a view with no string
+ * @param arena where to copy the string, advanced past its null terminator
+ * @param len   where to store the length of the string
+ *
+ * @return copy of the string, which lives in the arena, or NULL if the view has no string
+ */
+static inline char *ssq_buf_copy_string_view(const SSQ_STRING_VIEW view, char **const arena, size_t *const len) {
+    *len = view.len;
+
+    if (view.str == NULL)
+        return NULL;
+
+    char *const dst = *arena;
+
+    memcpy(dst, view.str, view.len);
+    dst[view.len] = '\0';
+
+    *arena += view.len + 1;
+
+    return dst;
+}
+
 #ifdef __cplusplus
 }
 #endif
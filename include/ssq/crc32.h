@@ -0,0 +1,25 @@
+#ifndef SSQ_CRC32_H
+#define SSQ_CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Computes the CRC32 checksum of a buffer.
+ *
+ * @param buf buffer
+ * @param len length of the buffer
+ *
+ * @return CRC32 checksum of the buffer
+ */
+uint32_t ssq_crc32(const uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_CRC32_H */
@@ -14,6 +14,7 @@ typedef enum ssq_error_code {
     SSQ_ERR_BADRES,      /* bad response          */
     SSQ_ERR_UNSUPPORTED, /* unsupported feature   */
     SSQ_ERR_NOENDPOINT,  /* no endpoint available */
+    SSQ_ERR_TIMEOUT,     /* timed out             */
 } SSQ_ERROR_CODE;
 
 typedef struct ssq_error {
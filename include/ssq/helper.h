@@ -5,8 +5,11 @@
 #include <stdio.h>
 #include <string.h>
 
-#ifndef _WIN32
+#ifdef _WIN32
+# include <winsock2.h> /* includes windows.h, after winsock2.h as it must be */
+#else /* not _WIN32 */
 # include <sys/time.h>
+# include <time.h>
 #endif /* _WIN32 */
 
 #define SSQ_PORT_LEN  5
@@ -17,6 +20,11 @@
  */
 static inline size_t ssq_helper_minz(const size_t x, const size_t y) { return (x < y) ? x : y; }
 
+/**
+ * @return maximum `size_t' between `x' and `y'
+ */
+static inline size_t ssq_helper_maxz(const size_t x, const size_t y) { return (x > y) ? x : y; }
+
 /** Portable version of `strncpy'. */
 static inline void ssq_helper_strncpy(char dst[], const char src[], size_t len) {
 #if _WIN32
@@ -55,4 +63,18 @@ static inline void ssq_helper_ms_to_tv(const time_t value_in_ms, struct timeval
 }
 #endif /* _WIN32 */
 
+/**
+ * Reads the monotonic clock.
+ * @return current time of the monotonic clock in milliseconds
+ */
+static inline int64_t ssq_helper_now_ms(void) {
+#ifdef _WIN32
+    return (int64_t)GetTickCount64();
+#else /* not _WIN32 */
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+#endif /* _WIN32 */
+}
+
 #endif /* SSQ_HELPER_H */
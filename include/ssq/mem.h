@@ -0,0 +1,123 @@
+#ifndef SSQ_MEM_H
+#define SSQ_MEM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void *(*SSQ_MALLOC_FN)(size_t size, void *user_data);
+typedef void *(*SSQ_CALLOC_FN)(size_t count, size_t size, void *user_data);
+typedef void  (*SSQ_FREE_FN)(void *ptr, void *user_data);
+
+/*
+ * Memory held by the allocations charged to a querier, or to several queriers sharing the statistics.
+ * The statistics must outlive the memory charged to them, results included, and be used by one thread at a time.
+ */
+typedef struct ssq_mem_stats {
+    size_t   current; /** Bytes currently allocated            */
+    size_t   peak;    /** Most bytes allocated at once         */
+    uint64_t allocs;  /** Number of allocations made           */
+    uint64_t frees;   /** Number of allocations freed          */
+} SSQ_MEM_STATS;
+
+/**
+ * Sets the functions all of the allocations of the library go through, in place of those of libc.
+ * It must be called while the library holds no memory, before the first querier is initialized.
+ * The cache of resolved addresses does not count, as it always allocates with libc.
+ * The memory handed out by the library, such as the buffers returned by `ssq_query', must then be freed
+ * with `ssq_mem_free'.
+ *
+ * @param malloc_fn function allocating memory, or NULL to restore the allocator of libc
+ * @param calloc_fn function allocating zeroed memory, or NULL to restore the allocator of libc
+ * @param free_fn   function freeing memory, or NULL to restore the allocator of libc
+ * @param user_data user data passed to the functions
+ */
+void ssq_set_allocator(SSQ_MALLOC_FN malloc_fn, SSQ_CALLOC_FN calloc_fn, SSQ_FREE_FN free_fn, void *user_data);
+
+/**
+ * Sets whether the allocations of the library are accounted, in which case each allocation records its size
+ * and the statistics it was charged to, if any, in a header. It must be called while the library holds no memory,
+ * and the memory handed out by the library must then be freed with `ssq_mem_free'.
+ *
+ * @param enabled true to account the allocations
+ */
+void ssq_set_accounting(bool enabled);
+
+/**
+ * Sets the statistics the allocations of the calling thread are charged to, while accounting is enabled.
+ *
+ * @param stats statistics to charge, or NULL to charge none
+ *
+ * @return statistics charged until then, to restore afterwards
+ */
+SSQ_MEM_STATS *ssq_mem_charge(SSQ_MEM_STATS *stats);
+
+/**
+ * Allocates memory with the allocator of the library.
+ * @param size number of bytes to allocate
+ * @return allocated memory or NULL in case of a memory allocation failure, with `errno' set
+ */
+void *ssq_mem_alloc(size_t size);
+
+/**
+ * Allocates zeroed memory for an array with the allocator of the library.
+ *
+ * @param count number of elements
+ * @param size  size of an element
+ *
+ * @return allocated memory or NULL in case of a memory allocation failure, with `errno' set
+ */
+void *ssq_mem_calloc(size_t count, size_t size);
+
+/**
+ * Resizes memory allocated with the allocator of the library.
+ * The allocator having no function to resize memory, the contents are copied unless the allocator is libc's.
+ *
+ * @param ptr      memory to resize, or NULL
+ * @param old_size current size of the memory
+ * @param size     new size of the memory
+ *
+ * @return resized memory or NULL in case of a memory allocation failure, with `errno' set and `ptr' left intact
+ */
+void *ssq_mem_realloc(void *ptr, size_t old_size, size_t size);
+
+/**
+ * Frees memory allocated by the library.
+ * @param ptr memory to free, or NULL
+ */
+void ssq_mem_free(void *ptr);
+
+/**
+ * Allocates memory which records its own size, so that it can be reused by `ssq_mem_reuse'.
+ * @param size number of bytes to allocate
+ * @return allocated memory or NULL in case of a memory allocation failure, with `errno' set
+ */
+void *ssq_mem_alloc_sized(size_t size);
+
+/**
+ * Reuses memory allocated by `ssq_mem_alloc_sized' if it can hold the given number of bytes,
+ * and otherwise allocates a larger one and frees it. The contents are not kept.
+ *
+ * @param ptr  memory to reuse, or NULL to allocate new memory
+ * @param size number of bytes needed
+ *
+ * @return `ptr' or newly-allocated memory, or NULL in case of a memory allocation failure, with `errno' set
+ *         and `ptr' left intact
+ */
+void *ssq_mem_reuse(void *ptr, size_t size);
+
+/**
+ * Frees memory allocated by `ssq_mem_alloc_sized'.
+ * @param ptr memory to free, or NULL
+ */
+void ssq_mem_free_sized(void *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_MEM_H */
@@ -0,0 +1,231 @@
+#ifndef SSQ_MULTI_H
+#define SSQ_MULTI_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "ssq/a2s.h"
+#include "ssq/batch.h"
+#include "ssq/error.h"
+#include "ssq/mem.h"
+#include "ssq/pool.h"
+
+#define SSQ_MULTI_TIMEOUT_DEFAULT_VALUE      5000 // ms
+#define SSQ_MULTI_MAX_INFLIGHT_DEFAULT_VALUE 256
+#define SSQ_MULTI_POOL_FRAGMENTS             8 // fragments of a response whose buffer is pooled
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum ssq_multi_query {
+    SSQ_MULTI_INFO,   /* A2S_INFO   */
+    SSQ_MULTI_PLAYER, /* A2S_PLAYER */
+    SSQ_MULTI_RULES   /* A2S_RULES  */
+} SSQ_MULTI_QUERY;
+
+typedef struct ssq_multi_result {
+    SSQ_MULTI_QUERY query;        /** Type of the query which finished                      */
+    void           *user_data;    /** User data given when the query was added              */
+    SSQ_ERROR       err;          /** Error of the query, if any                            */
+    A2S_INFO       *info;         /** A2S_INFO response if `query' is `SSQ_MULTI_INFO'      */
+    A2S_PLAYER     *players;      /** A2S_PLAYER response if `query' is `SSQ_MULTI_PLAYER'  */
+    uint8_t         player_count; /** Number of players in the `players' array              */
+    A2S_RULES      *rules;        /** A2S_RULES response if `query' is `SSQ_MULTI_RULES'    */
+    uint16_t        rule_count;   /** Number of rules in the `rules' array                  */
+} SSQ_MULTI_RESULT;
+
+/**
+ * Function called each time a query of a multi-target querier finishes.
+ * The callback takes ownership of the `info', `players' and `rules' of the result.
+ *
+ * @param result result of the query
+ */
+typedef void (*SSQ_MULTI_CALLBACK)(SSQ_MULTI_RESULT *result);
+
+struct ssq_multi_request;
+struct ssq_multi_entry;
+struct ssq_multi_target;
+struct ssq_resolver;
+
+typedef struct ssq_multi {
+    int                        epollfd;
+    SSQ_MULTI_CALLBACK         callback;
+    time_t                     timeout;        /** Timeout of the queries added from now on in ms                */
+    uint8_t                    max_challenges; /** Maximum number of challenges answered per query               */
+    uint8_t                    max_attempts;   /** Maximum number of times each request is sent                  */
+    size_t                     max_inflight;   /** Maximum number of queries in flight                           */
+    struct ssq_multi_request  *queue_head;     /** Queries waiting to be sent                                    */
+    struct ssq_multi_request  *queue_tail;
+    size_t                     queue_len;
+    struct ssq_resolver       *resolver;       /** Resolver of the hostnames not in the resolution cache         */
+    size_t                     lookup_count;   /** Queries waiting for the resolver                              */
+    struct ssq_multi_request **inflight;       /** Queries in flight, as a min-heap of wake-up times             */
+    size_t                     inflight_count;
+    size_t                     inflight_size;
+    SSQ_BATCH                  batch;          /** Slots the datagrams are received into                         */
+    bool                       shared;         /** Whether the queries started from now on share one socket      */
+    int                        sockfd;         /** Shared unconnected socket, or -1                              */
+    SSQ_BATCH                  send_batch;     /** Datagrams waiting to be sent on the shared socket             */
+    struct ssq_multi_entry    *table;          /** Queries on the shared socket, keyed by target and response    */
+    size_t                     table_size;
+    size_t                     table_count;
+    size_t                     waiting_count;  /** Queries waiting for another one to the same target to finish */
+    size_t                     stray_count;    /** Datagrams received on the shared socket matching no query     */
+    SSQ_POOL                   reassemblies;   /** Pool of the reassemblies of multi-packet responses            */
+    SSQ_POOL                   buffers;        /** Pool of the buffers of multi-packet responses of few packets  */
+    struct ssq_multi_target   *targets;        /** Round-trip time estimates, keyed by target                    */
+    size_t                     targets_size;
+    size_t                     targets_count;
+    SSQ_MEM_STATS             *mem;            /** Statistics the queries are charged to, or NULL                */
+    struct ssq_error           err;
+} SSQ_MULTI;
+
+/**
+ * Initializes a new multi-target Source server querier.
+ * It keeps many queries in flight together on non-blocking sockets driven by epoll (Linux only).
+ *
+ * @return new dynamically-allocated multi-target querier or NULL in case of an error
+ */
+SSQ_MULTI *ssq_multi_init(void);
+
+/**
+ * Frees a multi-target querier. The queries which did not finish yet are dropped.
+ * @param multi multi-target querier to free
+ */
+void ssq_multi_free(SSQ_MULTI *multi);
+
+/**
+ * Sets the function called each time a query of a multi-target querier finishes.
+ *
+ * @param multi    multi-target querier
+ * @param callback completion callback
+ */
+void ssq_multi_set_callback(SSQ_MULTI *multi, SSQ_MULTI_CALLBACK callback);
+
+/**
+ * Sets the timeout of the queries added to a multi-target querier from now on.
+ * The timeout starts when the query is sent and covers the whole exchange.
+ *
+ * @param multi       multi-target querier
+ * @param value_in_ms value to set in milliseconds
+ */
+void ssq_multi_set_timeout(SSQ_MULTI *multi, time_t value_in_ms);
+
+/**
+ * Sets the maximum number of challenges answered per query added to a multi-target querier from now on.
+ * A query to a server which keeps reissuing challenges past this number fails.
+ *
+ * @param multi          multi-target querier
+ * @param max_challenges maximum number of challenges answered per query
+ */
+void ssq_multi_set_max_challenges(SSQ_MULTI *multi, uint8_t max_challenges);
+
+/**
+ * Sets the maximum number of times each request of the queries added to a multi-target querier from now on
+ * is sent. A request which is not answered within the retransmission timeout of its target is sent again
+ * until this number is reached. The timeout is computed from the round-trip times measured to the target,
+ * which the querier keeps until it is freed. The default of 1 disables retransmission.
+ *
+ * @param multi        multi-target querier
+ * @param max_attempts maximum number of times each request is sent
+ */
+void ssq_multi_set_max_attempts(SSQ_MULTI *multi, uint8_t max_attempts);
+
+/**
+ * Sets the maximum number of queries a multi-target querier keeps in flight.
+ * A maximum of 0 counts as 1, since no query would ever start otherwise.
+ *
+ * @param multi        multi-target querier
+ * @param max_inflight maximum number of queries in flight
+ */
+void ssq_multi_set_max_inflight(SSQ_MULTI *multi, size_t max_inflight);
+
+/**
+ * Sets whether the queries started from now on share a single unconnected socket, which spares a
+ * file descriptor and a kernel socket per query in flight. The replies are routed back to their query
+ * from their source address and port, their response header and their multi-packet response ID.
+ * Datagrams matching no query in flight, such as late replies, are counted in `stray_count' and dropped.
+ * A query to a target which already has a query of the same type in flight on the shared socket is started
+ * once the latter finishes.
+ *
+ * @param multi  multi-target querier
+ * @param shared true to share a single socket between the queries
+ */
+void ssq_multi_set_shared_socket(SSQ_MULTI *multi, bool shared);
+
+/**
+ * Sets the statistics the memory allocated by the queries of a multi-target querier is charged to,
+ * while accounting is enabled with `ssq_set_accounting'. The results handed to the callback are charged
+ * until freed, so the statistics must outlive them as well as the querier.
+ *
+ * @param multi multi-target querier
+ * @param stats statistics to charge, or NULL to charge none
+ */
+void ssq_multi_set_mem_stats(SSQ_MULTI *multi, SSQ_MEM_STATS *stats);
+
+/**
+ * Adds a query to a multi-target querier. It is sent by a subsequent call
+ * to `ssq_multi_perform' once there is room for it in flight.
+ * A hostname which is neither numeric nor in the resolution cache is resolved on a worker thread,
+ * without holding up the queries in flight.
+ *
+ * @param multi     multi-target querier
+ * @param hostname  target hostname
+ * @param port      target port number
+ * @param query     type of query to send
+ * @param user_data user data passed back in the query's result
+ */
+void ssq_multi_add(SSQ_MULTI *multi, const char *hostname, uint16_t port, SSQ_MULTI_QUERY query, void *user_data);
+
+/**
+ * Sends the queued queries of a multi-target querier which fit in flight, waits for
+ * responses and reports each query which finished or timed out to the callback.
+ *
+ * @param multi      multi-target querier
+ * @param timeout_ms maximum time to wait for responses in milliseconds, or -1 to wait
+ *                   until at least one event occurs
+ *
+ * @return number of queries which did not finish yet
+ */
+size_t ssq_multi_perform(SSQ_MULTI *multi, int timeout_ms);
+
+/**
+ * Performs the queries of a multi-target querier until all of them finish.
+ * @param multi multi-target querier
+ */
+void ssq_multi_run(SSQ_MULTI *multi);
+
+/**
+ * Gets the last error code of a multi-target querier.
+ * @param multi multi-target querier
+ * @return last error code of the multi-target querier
+ */
+SSQ_ERROR_CODE ssq_multi_errc(const SSQ_MULTI *multi);
+
+/**
+ * Gets the last error message of a multi-target querier.
+ * @param multi multi-target querier
+ * @return last error message of the multi-target querier
+ */
+const char *ssq_multi_errm(const SSQ_MULTI *multi);
+
+/**
+ * Checks if a multi-target querier has an error currently set.
+ * @param multi multi-target querier
+ * @return true if the multi-target querier has no error currently set
+ */
+bool ssq_multi_ok(const SSQ_MULTI *multi);
+
+/**
+ * Clears a multi-target querier's last error.
+ * @param multi multi-target querier
+ */
+void ssq_multi_errclr(SSQ_MULTI *multi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_MULTI_H */
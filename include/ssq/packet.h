@@ -5,12 +5,17 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "ssq/error.h"
+#include "ssq/pool.h"
 
 #define A2S_PACKET_HEADER_SINGLE 0xFFFFFFFF
 #define A2S_PACKET_HEADER_MULTI  0xFFFFFFFE
 
 #define A2S_PACKET_FLAG_COMPRESSION 0x80000000
 
+#define SSQ_PACKET_SIZE 1400
+
+#define SSQ_PACKET_DECOMPRESSED_SIZE_MAX 0x100000 /* sanity bound on the announced size of a compressed response */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,6 +30,19 @@ typedef struct ssq_packet {
     size_t   payload_len; /** Length of the packet's payload                 */
 } SSQ_PACKET;
 
+typedef struct ssq_reassembly {
+    uint8_t *buf;                 /** Buffer the payloads are written to at their final offset */
+    size_t   slot_size;           /** Offset between the payloads of two consecutive packets   */
+    uint16_t slot_count;          /** Number of payloads the buffer holds                      */
+    int32_t  id;                  /** ID of the response being reassembled                     */
+    uint8_t  total;               /** Total number of packets in the response, or 0 until known */
+    uint16_t received;            /** Number of distinct packets received so far               */
+    uint64_t bitmap[4];           /** Packets received, one bit per packet number              */
+    uint16_t lens[UINT8_MAX + 1]; /** Length of the payload of each packet received            */
+    SSQ_POOL *pool;               /** Pool of the buffers which fit in a slot, or NULL         */
+    bool     pooled;              /** Whether the buffer, or the response handed out, is a slot */
+} SSQ_REASSEMBLY;
+
 /**
  * Deserializes a packet from a datagram.
  *
@@ -58,6 +76,64 @@ bool ssq_packets_verify_integrity(const SSQ_PACKET *const *packets, uint8_t pack
  */
 uint8_t *ssq_packets_to_response(const SSQ_PACKET *const *packets, uint8_t packet_count, size_t *buf_len, SSQ_ERROR *err);
 
+/**
+ * Initializes the reassembly of a response.
+ * @param reassembly reassembly to initialize
+ */
+void ssq_reassembly_init(SSQ_REASSEMBLY *reassembly);
+
+/**
+ * Initializes the reassembly of a response whose buffer is taken from a pool when it fits in a slot,
+ * as it is then for most multi-packet responses. Its response must be freed with `ssq_reassembly_free_response'.
+ *
+ * @param reassembly reassembly to initialize
+ * @param pool       pool of the buffers
+ */
+void ssq_reassembly_init_pooled(SSQ_REASSEMBLY *reassembly, SSQ_POOL *pool);
+
+/**
+ * Adds a datagram to the reassembly of a response. Its payload is written straight to its final
+ * offset in the response buffer, which is allocated once from the total number of packets and their
+ * announced size, and grown once should a payload turn out to be larger than announced.
+ * The packets received are tracked in a bitmap, so that the packets may come in any order and the
+ * total number of packets may be learnt from any of them. Duplicate packets, packets of another
+ * response and packets whose number or total contradicts the others are dropped.
+ *
+ * @param reassembly   reassembly of the response
+ * @param datagram     source datagram
+ * @param datagram_len length of the source datagram
+ * @param err          where to report potential errors
+ *
+ * @return true if all of the packets of the response were received
+ */
+bool ssq_reassembly_add(SSQ_REASSEMBLY *reassembly, const uint8_t *datagram, uint16_t datagram_len, SSQ_ERROR *err);
+
+/**
+ * Hands out the buffer of a complete reassembly. A compressed response is decompressed straight
+ * into a buffer of its announced size, which is verified along with its CRC32 checksum.
+ *
+ * @param reassembly   complete reassembly
+ * @param response_len where to store the length of the response
+ * @param err          where to report potential errors
+ *
+ * @return dynamically-allocated buffer made of the packets payloads' concatenation
+ */
+uint8_t *ssq_reassembly_release(SSQ_REASSEMBLY *reassembly, size_t *response_len, SSQ_ERROR *err);
+
+/**
+ * Frees the buffer of a reassembly, if it was not handed out.
+ * @param reassembly reassembly to free
+ */
+void ssq_reassembly_free(SSQ_REASSEMBLY *reassembly);
+
+/**
+ * Frees the response handed out by a reassembly, which goes back to the pool of the reassembly if it is a slot.
+ *
+ * @param reassembly reassembly which handed out the response
+ * @param response   response to free
+ */
+void ssq_reassembly_free_response(SSQ_REASSEMBLY *reassembly, uint8_t *response);
+
 /**
  * Frees a packet.
  * @param packet packet to free
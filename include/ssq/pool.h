@@ -0,0 +1,60 @@
+#ifndef SSQ_POOL_H
+#define SSQ_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SSQ_POOL_SLAB_SLOTS 8 /* slots carved out of each slab */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ssq_pool_slab;
+
+/*
+ * Pool of fixed-size slots, carved out of slabs allocated as needed. Released slots are kept on a free list
+ * and handed out again, and the slabs are freed only when the pool is.
+ */
+typedef struct ssq_pool {
+    size_t                slot_size; /** Size of a slot, rounded up to keep the slots aligned     */
+    void                 *free_list; /** Slots released or not handed out yet                     */
+    struct ssq_pool_slab *slabs;     /** Slabs allocated so far                                   */
+    uint64_t              hits;      /** Slots handed out from the free list                      */
+    uint64_t              misses;    /** Slots which needed a new slab to be allocated            */
+} SSQ_POOL;
+
+/**
+ * Initializes an empty pool.
+ *
+ * @param pool      pool to initialize
+ * @param slot_size size of the slots
+ */
+void ssq_pool_init(SSQ_POOL *pool, size_t slot_size);
+
+/**
+ * Frees the slabs of a pool. The slots handed out must not be used any longer.
+ * @param pool pool to free
+ */
+void ssq_pool_free(SSQ_POOL *pool);
+
+/**
+ * Takes a slot from a pool, and allocates a new slab if none is free.
+ * @param pool pool
+ * @return slot of `slot_size' bytes or NULL in case of a memory allocation failure
+ */
+void *ssq_pool_alloc(SSQ_POOL *pool);
+
+/**
+ * Gives a slot back to the pool it was taken from.
+ *
+ * @param pool pool the slot was taken from
+ * @param slot slot to release, or NULL
+ */
+void ssq_pool_release(SSQ_POOL *pool, void *slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_POOL_H */
@@ -3,22 +3,75 @@
 
 #include "ssq/ssq.h"
 
+#define SSQ_QUERY_PIPELINE_MAX 3 /* maximum number of queries sent at once by `ssq_query_pipeline' */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Function building the payload of a query from a challenge.
+ *
+ * @param payload where to store the payload
+ * @param chall   challenge to send along
+ *
+ * @return length of the payload
+ */
+typedef size_t (*SSQ_PAYLOAD_BUILDER)(uint8_t *payload, int32_t chall);
+
 /**
  * Sends a query to a Source server.
+ * The querier's socket is created and connected on first use, and is kept open
+ * until the target is changed or the querier is freed.
+ * A single-packet response is returned as received, starting with its single-packet response header.
+ * All of the packets of the response must be received within the query timeout of the querier.
+ * The query is sent again if no reply comes within the retransmission timeout of the target,
+ * up to the maximum number of attempts of the querier.
  *
  * @param querier      Source server querier to use
  * @param payload      query's payload
  * @param payload_len  length of the query's payload
  * @param response_len where to store the length of the query's response
  *
- * @return dynamically-allocated buffer containing the query's response
+ * @return dynamically-allocated buffer containing the query's response, to free with `ssq_mem_free'
  */
 uint8_t *ssq_query(SSQ_QUERIER *querier, const uint8_t *payload, size_t payload_len, size_t *response_len);
 
+/**
+ * Sends an A2S query to a Source server along with the querier's last challenge, and answers the
+ * challenges the server hands out, at most `max_challenges' times. The whole exchange must be over
+ * within the query timeout of the querier.
+ *
+ * @param querier       Source server querier to use
+ * @param build_payload function building the query's payload from a challenge
+ * @param response_len  where to store the length of the query's response
+ *
+ * @return dynamically-allocated buffer containing the query's response, to free with `ssq_mem_free'
+ */
+uint8_t *ssq_query_challenge(SSQ_QUERIER *querier, SSQ_PAYLOAD_BUILDER build_payload, size_t *response_len);
+
+/**
+ * Sends several A2S queries to a Source server back-to-back on the querier's socket, along with the querier's
+ * last challenge, and routes each response to its query from its response header. A new challenge handed out
+ * by the server is answered once for all of the queries waiting for a response, at most `max_challenges' times.
+ * The queries not answered within the retransmission timeout of the target are sent again, up to the maximum
+ * number of attempts of the querier. The whole exchange must be over within the query timeout of the querier.
+ *
+ * @param querier          Source server querier to use
+ * @param build_payloads   function building the payload of each query from a challenge
+ * @param response_headers header of the response expected to each query, all different
+ * @param query_count      number of queries, at most `SSQ_QUERY_PIPELINE_MAX'
+ * @param responses        where to store the dynamically-allocated response to each query, or NULLs in case of an error
+ * @param response_lens    where to store the length of the response to each query
+ */
+void ssq_query_pipeline(SSQ_QUERIER *querier, const SSQ_PAYLOAD_BUILDER *build_payloads, const uint8_t *response_headers, size_t query_count, uint8_t **responses, size_t *response_lens);
+
+/**
+ * Closes the socket of a Source server querier, if it has one open.
+ * @param querier Source server querier
+ */
+void ssq_query_close(SSQ_QUERIER *querier);
+
 #ifdef __cplusplus
 }
 #endif
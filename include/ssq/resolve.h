@@ -0,0 +1,71 @@
+#ifndef SSQ_RESOLVE_H
+#define SSQ_RESOLVE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+# include <ws2tcpip.h>
+#else /* not _WIN32 */
+# include <netdb.h>
+#endif /* _WIN32 */
+
+#include "ssq/error.h"
+
+#define SSQ_RESOLVE_CACHE_TTL_DEFAULT_VALUE 60000 // ms
+#define SSQ_RESOLVE_CACHE_SIZE              256   // hostnames
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Resolves the IPv4 and IPv6 addresses of a target, in the order of preference of the system. A numeric host
+ * skips the resolver, and the addresses of the other hostnames are kept in a cache shared by the whole process
+ * until their time to live runs out.
+ *
+ * @param hostname target hostname
+ * @param port     target port number
+ * @param err      where to report potential errors
+ *
+ * @return dynamically-allocated list of the addresses of the target, to free with `ssq_resolve_free',
+ *         or NULL if there was an error
+ */
+struct addrinfo *ssq_resolve(const char *hostname, uint16_t port, SSQ_ERROR *err);
+
+/**
+ * Resolves the addresses of a target without calling the resolver, that is if the host is numeric
+ * or if its addresses are in the cache.
+ *
+ * @param hostname  target hostname
+ * @param port      target port number
+ * @param addr_list where to store the dynamically-allocated list of the addresses of the target,
+ *                  to free with `ssq_resolve_free'
+ * @param err       where to report potential errors
+ *
+ * @return true if the addresses of the target were known, even if they could not be copied
+ */
+bool ssq_resolve_cached(const char *hostname, uint16_t port, struct addrinfo **addr_list, SSQ_ERROR *err);
+
+/**
+ * Frees a list of addresses returned by `ssq_resolve'.
+ * @param addr_list list of addresses to free, or NULL
+ */
+void ssq_resolve_free(struct addrinfo *addr_list);
+
+/**
+ * Sets how long the addresses of the hostnames resolved from now on are kept in the cache.
+ * @param ttl_ms time to live in milliseconds, or 0 to disable the cache
+ */
+void ssq_resolve_set_cache_ttl(int64_t ttl_ms);
+
+/**
+ * Empties the cache of resolved addresses.
+ */
+void ssq_resolve_clear_cache(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_RESOLVE_H */
@@ -0,0 +1,77 @@
+#ifndef SSQ_RESOLVER_H
+#define SSQ_RESOLVER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ssq/error.h"
+#include "ssq/resolve.h"
+
+#define SSQ_RESOLVER_THREADS_DEFAULT_VALUE 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ssq_resolver;
+
+typedef struct ssq_resolver SSQ_RESOLVER;
+
+typedef struct ssq_resolver_result {
+    void            *user_data; /** User data given when the target was submitted                   */
+    struct addrinfo *addr_list; /** Addresses of the target, to free with `ssq_resolve_free'         */
+    SSQ_ERROR        err;       /** Error of the resolution, in which case `addr_list' is NULL       */
+} SSQ_RESOLVER_RESULT;
+
+/**
+ * Initializes an asynchronous resolver, which resolves targets with `ssq_resolve' on worker threads (Linux only).
+ * The completion of the resolutions is signaled on a file descriptor to watch along with the sockets of the queries.
+ *
+ * @param thread_count number of worker threads
+ * @param err          where to report potential errors
+ *
+ * @return new dynamically-allocated resolver or NULL in case of an error
+ */
+SSQ_RESOLVER *ssq_resolver_init(size_t thread_count, SSQ_ERROR *err);
+
+/**
+ * Frees an asynchronous resolver once its worker threads finish their current resolution.
+ *
+ * @param resolver resolver to free
+ * @param drop     function called on the user data of each target whose result was not polled, or NULL
+ */
+void ssq_resolver_free(SSQ_RESOLVER *resolver, void (*drop)(void *user_data));
+
+/**
+ * Submits a target to an asynchronous resolver.
+ *
+ * @param resolver  resolver
+ * @param hostname  target hostname
+ * @param port      target port number
+ * @param user_data user data passed back in the result
+ * @param err       where to report potential errors
+ */
+void ssq_resolver_submit(SSQ_RESOLVER *resolver, const char *hostname, uint16_t port, void *user_data, SSQ_ERROR *err);
+
+/**
+ * Gets the file descriptor of an asynchronous resolver, which is readable when results are ready to be polled.
+ * @param resolver resolver
+ * @return file descriptor signaling completed resolutions
+ */
+int ssq_resolver_fd(const SSQ_RESOLVER *resolver);
+
+/**
+ * Takes the next completed resolution of an asynchronous resolver, without blocking.
+ *
+ * @param resolver resolver
+ * @param result   where to store the result of the resolution
+ *
+ * @return false if no resolution was completed
+ */
+bool ssq_resolver_poll(SSQ_RESOLVER *resolver, SSQ_RESOLVER_RESULT *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_RESOLVER_H */
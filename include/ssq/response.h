@@ -7,12 +7,26 @@
 
 #define S2A_HEADER_CHALL 0x41
 
+#define A2S_CHALLENGE_NONE (-1) /* placeholder challenge asking the server for a new one */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Gets the header of a response, which tells the kind of response it is.
+ * The response may start with the single-packet response header.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ *
+ * @return response header, such as `S2A_HEADER_CHALL'
+ */
+uint8_t ssq_response_get_header(const uint8_t *response, size_t response_len);
+
 /**
  * Determines if a response has a challenge.
+ * The response may start with the single-packet response header.
  *
  * @param response     response buffer
  * @param response_len length of the response
@@ -23,6 +37,7 @@ bool ssq_response_has_challenge(const uint8_t *response, size_t response_len);
 
 /**
  * Gets the challenge in a challenge response.
+ * The response may start with the single-packet response header.
  *
  * @param response     challenge response buffer
  * @param response_len length of the challenge response
@@ -0,0 +1,55 @@
+#ifndef SSQ_RTT_H
+#define SSQ_RTT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SSQ_RTT_RTO_INITIAL 1000  // ms, until the first round-trip time is measured
+#define SSQ_RTT_RTO_MIN     100   // ms
+#define SSQ_RTT_RTO_MAX     10000 // ms
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Round-trip time estimator of a target, after Jacobson and Karels.
+ * The estimates are kept in fixed point, as in the original algorithm.
+ */
+typedef struct ssq_rtt {
+    int64_t srtt;     /** Smoothed round-trip time in 1/8 ms         */
+    int64_t rttvar;   /** Round-trip time variation in 1/4 ms         */
+    bool    measured; /** Whether a round-trip time was measured yet */
+} SSQ_RTT;
+
+/**
+ * Initializes a round-trip time estimator with no measurement.
+ * @param rtt round-trip time estimator
+ */
+void ssq_rtt_init(SSQ_RTT *rtt);
+
+/**
+ * Feeds a round-trip time measurement to an estimator.
+ * Following Karn's algorithm, only the exchanges which were not retransmitted must be measured.
+ *
+ * @param rtt       round-trip time estimator
+ * @param sample_ms round-trip time measured in milliseconds
+ */
+void ssq_rtt_sample(SSQ_RTT *rtt, int64_t sample_ms);
+
+/**
+ * Computes the retransmission timeout of an attempt: the smoothed round-trip time plus four times its
+ * variation, doubled for each attempt already made, and kept between `SSQ_RTT_RTO_MIN' and `SSQ_RTT_RTO_MAX'.
+ *
+ * @param rtt     round-trip time estimator
+ * @param attempt number of attempts already made
+ *
+ * @return retransmission timeout in milliseconds
+ */
+int64_t ssq_rtt_rto(const SSQ_RTT *rtt, uint8_t attempt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_RTT_H */
@@ -0,0 +1,234 @@
+#ifndef SSQ_SCHEMA_H
+#define SSQ_SCHEMA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "ssq/buf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum ssq_field_type {
+    SSQ_FIELD_UINT8  = 0, /* uint8_t                                                        */
+    SSQ_FIELD_UINT16 = 1, /* uint16_t                                                       */
+    SSQ_FIELD_INT32  = 2, /* int32_t                                                        */
+    SSQ_FIELD_UINT64 = 3, /* uint64_t                                                       */
+    SSQ_FIELD_FLOAT  = 4, /* float                                                          */
+    SSQ_FIELD_BOOL   = 5, /* bool                                                           */
+    SSQ_FIELD_CHAR   = 6, /* character, stored as an int-sized enum through a map           */
+    SSQ_FIELD_STRING = 7, /* null-terminated string, stored as an `SSQ_STRING_VIEW'         */
+    SSQ_FIELD_EDF    = 8  /* uint8_t of flags telling which of the next fields are present,
+                             present itself only if the response does not end before it     */
+} SSQ_FIELD_TYPE;
+
+/*
+ * Field of a response format, as laid out in the wire format.
+ * A response format is described by an array of fields, usually generated from an X-macro.
+ */
+typedef struct ssq_field {
+    size_t         offset; /** Offset of the field in the struct it is decoded into or encoded from            */
+    SSQ_FIELD_TYPE type;   /** Type of the field                                                               */
+    uint8_t        flag;   /** EDF flag the field depends on, or 0 if the field is always present              */
+    const char    *map;    /** Value stored for each of the 256 characters, 0 if unknown, for `SSQ_FIELD_CHAR' */
+} SSQ_FIELD;
+
+/* Value stored in an `SSQ_FIELD_CHAR' field for a character its map does not know. */
+#define SSQ_FIELD_CHAR_UNKNOWN '?'
+
+/*
+ * Unrolls the loop it precedes, which lets an inline function walking a constant schema be compiled into
+ * straight-line code for that schema. Other compilers walk the schema at run time.
+ */
+#if defined(__clang__)
+#define SSQ_SCHEMA_UNROLL _Pragma("unroll 64")
+#elif defined(__GNUC__) && (__GNUC__ >= 8)
+#define SSQ_SCHEMA_UNROLL _Pragma("GCC unroll 64")
+#else
+#define SSQ_SCHEMA_UNROLL
+#endif
+
+/**
+ * Computes the size of a field in the wire format.
+ *
+ * @param type type of the field
+ *
+ * @return size of the field in bytes, or 0 if it has no fixed size
+ */
+static inline size_t ssq_schema_wire_size(const SSQ_FIELD_TYPE type) {
+    switch (type) {
+        case SSQ_FIELD_UINT8:
+        case SSQ_FIELD_BOOL:
+        case SSQ_FIELD_CHAR:   return 1;
+        case SSQ_FIELD_UINT16: return 2;
+        case SSQ_FIELD_INT32:
+        case SSQ_FIELD_FLOAT:  return 4;
+        case SSQ_FIELD_UINT64: return 8;
+        default:               return 0;
+    }
+}
+
+/**
+ * Finds the end of the run of fixed-size fields starting at a field, whose bounds are checked at once.
+ * A run ends before a field of no fixed size, a field depending on another EDF flag, or `SSQ_BUF_RESERVE_MAX' bytes.
+ *
+ * @param fields      fields of the response format
+ * @param field_count number of fields
+ * @param first       index of the first field of the run
+ * @param size        where to store the size of the run in bytes
+ *
+ * @return index of the field following the run
+ */
+static inline size_t ssq_schema_run_end(const SSQ_FIELD fields[], const size_t field_count, const size_t first, size_t *const size) {
+    *size = 0;
+
+    SSQ_SCHEMA_UNROLL
+    for (size_t i = first; i < field_count; ++i) {
+        const size_t field_size = ssq_schema_wire_size(fields[i].type);
+
+        if (fields[i].flag != fields[first].flag || field_size == 0 || *size + field_size > SSQ_BUF_RESERVE_MAX)
+            return i;
+
+        *size += field_size;
+    }
+
+    return field_count;
+}
+
+/* Selection of every field of a response format, which has 32 fields at most. */
+#define SSQ_SCHEMA_ALL UINT32_MAX
+
+/**
+ * Decodes some fields of a response format from a byte buffer into a struct.
+ * The bounds of each run of fixed-size fields are checked once. The fields missing from a truncated
+ * response read as zero and as empty strings, and the fields absent from the EDF are left as they are.
+ * The fields left out of the selection are read past without being stored, and are left as they are too.
+ * Given a constant schema, the decoder is compiled into the reads a hand-written deserializer would do.
+ *
+ * @param fields      fields of the response format
+ * @param field_count number of fields
+ * @param selected    fields to store, bit N standing for field N
+ * @param buf         byte buffer to read from
+ * @param dst         struct to decode into
+ */
+static inline void ssq_schema_decode_selected(
+    const SSQ_FIELD fields[],
+    const size_t    field_count,
+    const uint32_t  selected,
+    SSQ_BUF  *const buf,
+    void     *const dst
+) {
+    const uint8_t *block   = ssq_buf_zeroes;
+    size_t         run_end = 0;
+    uint8_t        edf     = 0;
+
+    SSQ_SCHEMA_UNROLL
+    for (size_t i = 0; i < field_count; ++i) {
+        const SSQ_FIELD *const field = &(fields[i]);
+        uint8_t         *const value = (uint8_t *)dst + field->offset;
+        const bool             store = (selected >> i) & 1;
+
+        if (field->flag != 0 && !(edf & field->flag))
+            continue;
+
+        if (field->type == SSQ_FIELD_STRING) {
+            const SSQ_STRING_VIEW view = ssq_buf_get_string_view(buf);
+            if (store)
+                *(SSQ_STRING_VIEW *)value = view;
+            continue;
+        }
+
+        /* The EDF is read in any case, as it tells which of the next fields are present. */
+        if (field->type == SSQ_FIELD_EDF) {
+            if (ssq_buf_eof(buf))
+                return;
+
+            edf = ssq_buf_load_uint8(ssq_buf_reserve(buf, 1));
+            if (store)
+                *value = edf;
+            continue;
+        }
+
+        /* The first field of a run reserves the bytes of the whole run. */
+        if (i >= run_end) {
+            size_t run_size;
+            run_end = ssq_schema_run_end(fields, field_count, i, &run_size);
+            block   = ssq_buf_reserve(buf, run_size);
+        }
+
+        if (!store) {
+            block += ssq_schema_wire_size(field->type);
+            continue;
+        }
+
+        /* The struct is not necessarily aligned for the wider fields, which are copied with constant sizes. */
+        switch (field->type) {
+            case SSQ_FIELD_UINT8:
+                *value = ssq_buf_load_uint8(block);
+                block += 1;
+                break;
+
+            case SSQ_FIELD_UINT16:
+                memcpy(value, block, 2);
+                block += 2;
+                break;
+
+            case SSQ_FIELD_INT32:
+            case SSQ_FIELD_FLOAT:
+                memcpy(value, block, 4);
+                block += 4;
+                break;
+
+            case SSQ_FIELD_UINT64:
+                memcpy(value, block, 8);
+                block += 8;
+                break;
+
+            case SSQ_FIELD_BOOL:
+                *(bool *)value = ssq_buf_load_bool(block);
+                block += 1;
+                break;
+
+            default: {
+                const char c = field->map[ssq_buf_load_uint8(block)];
+                *(int *)value = (c != '\0') ? c : SSQ_FIELD_CHAR_UNKNOWN;
+                block += 1;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Decodes all the fields of a response format from a byte buffer into a struct.
+ *
+ * @param fields      fields of the response format
+ * @param field_count number of fields
+ * @param buf         byte buffer to read from
+ * @param dst         struct to decode into
+ */
+static inline void ssq_schema_decode(const SSQ_FIELD fields[], const size_t field_count, SSQ_BUF *const buf, void *const dst) {
+    ssq_schema_decode_selected(fields, field_count, SSQ_SCHEMA_ALL, buf, dst);
+}
+
+/**
+ * Encodes the fields of a response format from a struct.
+ * Nothing is written past `dst_size' bytes, but the length of the whole encoding is returned in any case.
+ *
+ * @param fields      fields of the response format
+ * @param field_count number of fields
+ * @param src         struct to encode from
+ * @param dst         where to write the encoding, or NULL to compute its length only
+ * @param dst_size    number of bytes `dst' can hold
+ *
+ * @return length of the encoding
+ */
+size_t ssq_schema_encode(const SSQ_FIELD *fields, size_t field_count, const void *src, uint8_t *dst, size_t dst_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_SCHEMA_H */
@@ -0,0 +1,41 @@
+#ifndef SSQ_SNAPSHOT_H
+#define SSQ_SNAPSHOT_H
+
+#include "ssq/a2s/info.h"
+#include "ssq/a2s/player.h"
+#include "ssq/a2s/rules.h"
+#include "ssq/ssq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ssq_snapshot {
+    A2S_INFO   *info;         /** A2S_INFO response              */
+    A2S_PLAYER *players;      /** A2S_PLAYER response            */
+    uint8_t     player_count; /** Number of players in `players' */
+    A2S_RULES  *rules;        /** A2S_RULES response             */
+    uint16_t    rule_count;   /** Number of rules in `rules'     */
+} SSQ_SNAPSHOT;
+
+/**
+ * Sends the A2S_INFO, A2S_PLAYER and A2S_RULES queries to a Source game server at once, on the querier's
+ * socket and with a single challenge handshake, so that the whole snapshot takes about one round trip.
+ *
+ * @param querier Source server querier to use
+ *
+ * @return dynamically-allocated snapshot of the server, or NULL if an error occurred
+ */
+SSQ_SNAPSHOT *ssq_snapshot(SSQ_QUERIER *querier);
+
+/**
+ * Frees a snapshot along with the responses it holds.
+ * @param snapshot snapshot to free
+ */
+void ssq_snapshot_free(SSQ_SNAPSHOT *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SSQ_SNAPSHOT_H */
@@ -12,21 +12,50 @@
 #endif /* _WIN32 */
 
 #include "ssq/error.h"
+#include "ssq/mem.h"
+#include "ssq/rtt.h"
 
-#define SSQ_TIMEOUT_RECV_DEFAULT_VALUE 5000 // ms
-#define SSQ_TIMEOUT_SEND_DEFAULT_VALUE 5000 // ms
+#define SSQ_TIMEOUT_RECV_DEFAULT_VALUE  5000 // ms
+#define SSQ_TIMEOUT_SEND_DEFAULT_VALUE  5000 // ms
+#define SSQ_TIMEOUT_QUERY_DEFAULT_VALUE 5000 // ms
+
+#define SSQ_MAX_CHALLENGES_DEFAULT_VALUE 3
+#define SSQ_MAX_ATTEMPTS_DEFAULT_VALUE   1
+
+#define SSQ_RACE_STAGGER_DEFAULT_VALUE 100 // ms
+#define SSQ_RACE_MAX                   8   // addresses raced at once
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifdef _WIN32
+typedef SOCKET SSQ_SOCKET;
+# define SSQ_SOCKET_INVALID INVALID_SOCKET
+#else /* not _WIN32 */
+typedef int    SSQ_SOCKET;
+# define SSQ_SOCKET_INVALID (-1)
+#endif /* _WIN32 */
+
+/*
+ * Timeouts of a Source server querier, in milliseconds.
+ * A timeout of 0 never expires, and a negative one counts as 0.
+ */
 typedef enum ssq_timeout {
-    SSQ_TIMEOUT_RECV = 0x1,
-    SSQ_TIMEOUT_SEND = 0x2
+    SSQ_TIMEOUT_RECV  = 0x1, /* wait for each datagram                                    */
+    SSQ_TIMEOUT_SEND  = 0x2, /* wait for each send                                        */
+    SSQ_TIMEOUT_QUERY = 0x4  /* whole query, challenge handshake and all packets included */
 } SSQ_TIMEOUT;
 
+typedef enum ssq_race {
+    SSQ_RACE_OFF      = 0, /* the first address of the target is used alone */
+    SSQ_RACE_FAMILIES = 1, /* the first address of each family races        */
+    SSQ_RACE_ALL      = 2  /* every address races, families interleaved     */
+} SSQ_RACE;
+
 typedef struct ssq_querier {
     struct addrinfo *addr_list;
+    struct addrinfo *addr_preferred;   /** Address of the target which answered first, or NULL     */
     struct ssq_error err;
 
 #ifdef _WIN32
@@ -36,6 +65,18 @@ typedef struct ssq_querier {
     struct timeval   timeout_recv;
     struct timeval   timeout_send;
 #endif /* _WIN32 */
+
+    int64_t          timeout_query;    /** Time a whole query may take in ms                         */
+
+    SSQ_SOCKET       sockfd;           /** Socket connected to the target, or `SSQ_SOCKET_INVALID' */
+    bool             timeouts_changed; /** Whether the timeouts must be re-applied to the socket    */
+    int32_t          chall;            /** Last challenge handed out by the target                 */
+    uint8_t          max_challenges;   /** Maximum number of challenges answered per query         */
+    uint8_t          max_attempts;     /** Maximum number of times a request is sent                */
+    SSQ_RTT          rtt;              /** Round-trip time estimate of the target                  */
+    SSQ_RACE         race;             /** Addresses of the target raced by the first query        */
+    int64_t          race_stagger;     /** Delay between the requests of a race in ms               */
+    SSQ_MEM_STATS   *mem;              /** Statistics the queries are charged to, or NULL          */
 } SSQ_QUERIER;
 
 /**
@@ -52,6 +93,8 @@ void ssq_free(SSQ_QUERIER *querier);
 
 /**
  * Sets the target server of a Source server querier.
+ * Closes the socket connected to the previous target, if any, and forgets its challenge and round-trip time estimate.
+ * The target is resolved with `ssq_resolve', which spares the resolver numeric hosts and hostnames it resolved lately.
  *
  * @param querier  Source server querier
  * @param hostname target hostname
@@ -61,6 +104,9 @@ void ssq_set_target(SSQ_QUERIER *querier, const char *hostname, uint16_t port);
 
 /**
  * Sets the timeouts of a Source server querier.
+ * The query timeout is a deadline on the monotonic clock covering the challenge handshake
+ * and all of the packets of the response, while the receive timeout bounds each wait for a datagram.
+ * A timeout of 0 is disabled, which lets the query wait with no limit, and a negative timeout counts as 0.
  *
  * @param querier     Source server querier
  * @param which       timeouts to set (bitwise)
@@ -76,6 +122,49 @@ void ssq_set_timeout(
 #endif /* _WIN32 */
 );
 
+/**
+ * Sets the maximum number of challenges a Source server querier answers during one query,
+ * past which the query fails instead of going on with a server which keeps reissuing challenges.
+ *
+ * @param querier        Source server querier
+ * @param max_challenges maximum number of challenges answered per query
+ */
+void ssq_set_max_challenges(SSQ_QUERIER *querier, uint8_t max_challenges);
+
+/**
+ * Sets the maximum number of times a Source server querier sends each request of a query.
+ * A request which is not answered within the retransmission timeout, computed from the round-trip times
+ * measured to the target, is sent again until this number is reached. The last attempt waits as long as the
+ * receive and query timeouts allow. The default of 1 disables retransmission.
+ *
+ * @param querier      Source server querier
+ * @param max_attempts maximum number of times each request is sent
+ */
+void ssq_set_max_attempts(SSQ_QUERIER *querier, uint8_t max_attempts);
+
+/**
+ * Sets the racing mode of a Source server querier, after Happy Eyeballs. As long as no address of the target
+ * answered yet, a query sends its request to several addresses of the target, one after the other with the given
+ * stagger, or at once to the next address when one turns out unreachable. The address which answers first with
+ * a valid reply is kept for the rest of the query and the following ones, until the target is changed.
+ * Pipelined queries do not race, but go to the address kept if any.
+ *
+ * @param querier    Source server querier
+ * @param race       addresses of the target to race
+ * @param stagger_ms delay between the requests sent to the raced addresses in milliseconds
+ */
+void ssq_set_race(SSQ_QUERIER *querier, SSQ_RACE race, int64_t stagger_ms);
+
+/**
+ * Sets the statistics the memory allocated by a Source server querier is charged to, while accounting is enabled
+ * with `ssq_set_accounting'. The target's addresses and the queries' buffers and results are charged, and discharged
+ * once freed, so the statistics must outlive the results. Several queriers may share the same statistics.
+ *
+ * @param querier Source server querier
+ * @param stats   statistics to charge, or NULL to charge none
+ */
+void ssq_set_mem_stats(SSQ_QUERIER *querier, SSQ_MEM_STATS *stats);
+
 /**
  * Gets the last error code of a Source server querier.
  * @param querier Source server querier
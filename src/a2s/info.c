@@ -1,17 +1,98 @@
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include "ssq/a2s/info.h"
 #include "ssq/buf.h"
+#include "ssq/mem.h"
 #include "ssq/query.h"
 #include "ssq/response.h"
+#include "ssq/schema.h"
 
 #define A2S_HEADER_INFO 0x54
-#define S2A_HEADER_INFO 0x49
 
-#define A2S_INFO_PAYLOAD_LEN                   29
 #define A2S_INFO_PAYLOAD_LEN_WITHOUT_CHALLENGE (A2S_INFO_PAYLOAD_LEN - 4)
 #define A2S_INFO_PAYLOAD_CHALLENGE_OFFSET      25
 
+#define A2S_INFO_STRING_COUNT 7 /* name, map, folder, game, version, stv_name and keywords */
+
+static const char g_a2s_info_server_types[UINT8_MAX + 1] = {
+    ['d'] = A2S_SERVER_TYPE_DEDICATED,
+    ['l'] = A2S_SERVER_TYPE_NON_DEDICATED,
+    ['p'] = A2S_SERVER_TYPE_STV_RELAY
+};
+
+static const char g_a2s_info_environments[UINT8_MAX + 1] = {
+    ['l'] = A2S_ENVIRONMENT_LINUX,
+    ['w'] = A2S_ENVIRONMENT_WINDOWS,
+    ['m'] = A2S_ENVIRONMENT_MAC,
+    ['o'] = A2S_ENVIRONMENT_MAC
+};
+
+/*
+ * Fields of an A2S_INFO response following its header, in the order of the wire format.
+ * X(field of `A2S_INFO_REF', type, EDF flag, map of characters).
+ */
+#define A2S_INFO_HEAD_FIELDS(X)                                                       \
+    X(protocol,    SSQ_FIELD_UINT8,  0,                      NULL)                    \
+    X(name,        SSQ_FIELD_STRING, 0,                      NULL)                    \
+    X(map,         SSQ_FIELD_STRING, 0,                      NULL)                    \
+    X(folder,      SSQ_FIELD_STRING, 0,                      NULL)                    \
+    X(game,        SSQ_FIELD_STRING, 0,                      NULL)                    \
+    X(id,          SSQ_FIELD_UINT16, 0,                      NULL)                    \
+    X(players,     SSQ_FIELD_UINT8,  0,                      NULL)                    \
+    X(max_players, SSQ_FIELD_UINT8,  0,                      NULL)                    \
+    X(bots,        SSQ_FIELD_UINT8,  0,                      NULL)                    \
+    X(server_type, SSQ_FIELD_CHAR,   0,                      g_a2s_info_server_types) \
+    X(environment, SSQ_FIELD_CHAR,   0,                      g_a2s_info_environments) \
+    X(visibility,  SSQ_FIELD_BOOL,   0,                      NULL)                    \
+    X(vac,         SSQ_FIELD_BOOL,   0,                      NULL)                    \
+    X(version,     SSQ_FIELD_STRING, 0,                      NULL)
+
+/* Fields of the EDF trailer, which are also fields of `A2S_INFO_VIEW'. */
+#define A2S_INFO_EDF_FIELDS(X)                                                        \
+    X(edf,         SSQ_FIELD_EDF,    0,                      NULL)                    \
+    X(port,        SSQ_FIELD_UINT16, A2S_INFO_FLAG_PORT,     NULL)                    \
+    X(steamid,     SSQ_FIELD_UINT64, A2S_INFO_FLAG_STEAMID,  NULL)                    \
+    X(stv_port,    SSQ_FIELD_UINT16, A2S_INFO_FLAG_STV,      NULL)                    \
+    X(stv_name,    SSQ_FIELD_STRING, A2S_INFO_FLAG_STV,      NULL)                    \
+    X(keywords,    SSQ_FIELD_STRING, A2S_INFO_FLAG_KEYWORDS, NULL)                    \
+    X(gameid,      SSQ_FIELD_UINT64, A2S_INFO_FLAG_GAMEID,   NULL)
+
+#define A2S_INFO_FIELDS(X) A2S_INFO_HEAD_FIELDS(X) A2S_INFO_EDF_FIELDS(X)
+
+#define A2S_INFO_FIELD(field, type, flag, map) { offsetof(A2S_INFO_REF, field), type, flag, map },
+
+static const SSQ_FIELD g_a2s_info_fields[] = { A2S_INFO_FIELDS(A2S_INFO_FIELD) };
+
+#define A2S_INFO_FIELD_COUNT (sizeof (g_a2s_info_fields) / sizeof (*g_a2s_info_fields))
+
+#define A2S_INFO_VIEW_FIELD(field, type, flag, map) { offsetof(A2S_INFO_VIEW, field), type, flag, map },
+
+static const SSQ_FIELD g_a2s_info_view_edf_fields[] = { A2S_INFO_EDF_FIELDS(A2S_INFO_VIEW_FIELD) };
+
+#define A2S_INFO_VIEW_EDF_FIELD_COUNT (sizeof (g_a2s_info_view_edf_fields) / sizeof (*g_a2s_info_view_edf_fields))
+
+/* Offsets of the fields held by the details of an `A2S_INFO_VIEW', from the Steam Application ID to VAC. */
+#define A2S_INFO_DETAILS_ID          0
+#define A2S_INFO_DETAILS_PLAYERS     2
+#define A2S_INFO_DETAILS_MAX_PLAYERS 3
+#define A2S_INFO_DETAILS_BOTS        4
+#define A2S_INFO_DETAILS_SERVER_TYPE 5
+#define A2S_INFO_DETAILS_ENVIRONMENT 6
+#define A2S_INFO_DETAILS_VISIBILITY  7
+#define A2S_INFO_DETAILS_VAC         8
+#define A2S_INFO_DETAILS_LEN         9
+
+/* Fields flagged by the EDF, which cannot be read without it. */
+#define A2S_INFO_FIELD_EDF_FLAGGED \
+    (A2S_INFO_FIELD_PORT | A2S_INFO_FIELD_STEAMID | A2S_INFO_FIELD_STV_PORT | A2S_INFO_FIELD_STV_NAME | A2S_INFO_FIELD_KEYWORDS | A2S_INFO_FIELD_GAMEID)
+
+/* Each field of the response is selected by the `A2S_INFO_FIELD_*' flag of its index. */
+typedef char a2s_info_check_field_flags[(A2S_INFO_FIELD_ALL == (1u << A2S_INFO_FIELD_COUNT) - 1) ? 1 : -1];
+
+/* The server type and the environment are stored as the ints of `SSQ_FIELD_CHAR' fields. */
+typedef char a2s_info_check_enum_size[(sizeof (A2S_SERVER_TYPE) == sizeof (int) && sizeof (A2S_ENVIRONMENT) == sizeof (int)) ? 1 : -1];
+
 static const uint8_t g_a2s_info_payload_template[A2S_INFO_PAYLOAD_LEN] = {
     0xFF, 0xFF, 0xFF, 0xFF, A2S_HEADER_INFO,
     0x53, 0x6F, 0x75, 0x72, 0x63,
@@ -29,129 +110,372 @@ static inline void ssq_info_payload_set_challenge(uint8_t payload[A2S_INFO_PAYLO
     memcpy(payload + A2S_INFO_PAYLOAD_CHALLENGE_OFFSET, &chall, sizeof (chall));
 }
 
-static A2S_ENVIRONMENT ssq_info_deserialize_environment(SSQ_BUF *const buf) {
-    switch (ssq_buf_get_uint8(buf)) {
-        case 'l': return A2S_ENVIRONMENT_LINUX;
-        case 'w': return A2S_ENVIRONMENT_WINDOWS;
-        case 'm':
-        case 'o': return A2S_ENVIRONMENT_MAC;
-        default:  return A2S_ENVIRONMENT_UNKNOWN;
-    }
+size_t ssq_info_payload(uint8_t payload[A2S_INFO_PAYLOAD_LEN], const int32_t chall) {
+    ssq_info_payload_init(payload);
+
+    if (chall == A2S_CHALLENGE_NONE)
+        return A2S_INFO_PAYLOAD_LEN_WITHOUT_CHALLENGE;
+
+    ssq_info_payload_set_challenge(payload, chall);
+
+    return A2S_INFO_PAYLOAD_LEN;
 }
 
-static A2S_SERVER_TYPE ssq_info_deserialize_server_type(SSQ_BUF *const buf) {
-    switch (ssq_buf_get_uint8(buf)) {
-        case 'd': return A2S_SERVER_TYPE_DEDICATED;
-        case 'l': return A2S_SERVER_TYPE_NON_DEDICATED;
-        case 'p': return A2S_SERVER_TYPE_STV_RELAY;
-        default:  return A2S_SERVER_TYPE_UNKNOWN;
+/**
+ * Starts reading an A2S_INFO response, checking its header.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param buf          where to store the byte buffer reading the fields following the header
+ * @param err          where to report potential errors
+ *
+ * @return false if there was an error
+ */
+static bool ssq_info_response_open(
+    const uint8_t    response[],
+    const size_t     response_len,
+    SSQ_BUF   *const buf,
+    SSQ_ERROR *const err
+) {
+    *buf = ssq_buf_init(response, response_len);
+
+    if (ssq_response_is_truncated(response, response_len))
+        ssq_buf_forward(buf, 4);
+
+    const uint8_t response_header = ssq_buf_load_uint8(ssq_buf_reserve(buf, 1));
+
+    if (response_header != S2A_HEADER_INFO) {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid A2S_INFO response header");
+        return false;
     }
+
+    return true;
 }
 
-A2S_INFO *ssq_info_deserialize(const uint8_t payload[], const size_t payload_len, SSQ_ERROR *const err) {
-    A2S_INFO *info = NULL;
+/**
+ * Deserializes some fields of an A2S_INFO response, borrowing its strings.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param fields       `A2S_INFO_FIELD_*' flags of the fields to read, the other ones being left zeroed
+ * @param info         where to store the fields of the response
+ * @param err          where to report potential errors
+ *
+ * @return false if there was an error
+ */
+static bool ssq_info_deserialize_view_fields(
+    const uint8_t       response[],
+    const size_t        response_len,
+    const uint32_t      fields,
+    A2S_INFO_REF *const info,
+    SSQ_ERROR    *const err
+) {
+    memset(info, 0, sizeof (*info));
+
+    SSQ_BUF buf;
+
+    if (!ssq_info_response_open(response, response_len, &buf, err))
+        return false;
+
+    ssq_schema_decode_selected(g_a2s_info_fields, A2S_INFO_FIELD_COUNT, fields, &buf, info);
+
+    return true;
+}
 
-    SSQ_BUF buf = ssq_buf_init(payload, payload_len);
-
-    if (ssq_response_is_truncated(payload, payload_len))
-        ssq_buf_forward(&buf, 4);
-
-    const uint8_t response_header = ssq_buf_get_uint8(&buf);
-
-    if (response_header == S2A_HEADER_INFO) {
-        info = malloc(sizeof (*info));
-
-        if (info != NULL) {
-            memset(info, 0, sizeof (*info));
-
-            info->protocol    = ssq_buf_get_uint8(&buf);
-            info->name        = ssq_buf_get_string(&buf, &(info->name_len));
-            info->map         = ssq_buf_get_string(&buf, &(info->map_len));
-            info->folder      = ssq_buf_get_string(&buf, &(info->folder_len));
-            info->game        = ssq_buf_get_string(&buf, &(info->game_len));
-            info->id          = ssq_buf_get_uint16(&buf);
-            info->players     = ssq_buf_get_uint8(&buf);
-            info->max_players = ssq_buf_get_uint8(&buf);
-            info->bots        = ssq_buf_get_uint8(&buf);
-            info->server_type = ssq_info_deserialize_server_type(&buf);
-            info->environment = ssq_info_deserialize_environment(&buf);
-            info->visibility  = ssq_buf_get_bool(&buf);
-            info->vac         = ssq_buf_get_bool(&buf);
-            info->version     = ssq_buf_get_string(&buf, &(info->version_len));
-
-            if (!ssq_buf_eof(&buf)) {
-                info->edf = ssq_buf_get_uint8(&buf);
-
-                if (info->edf & A2S_INFO_FLAG_PORT)
-                    info->port = ssq_buf_get_uint16(&buf);
-
-                if (info->edf & A2S_INFO_FLAG_STEAMID)
-                    info->steamid = ssq_buf_get_uint64(&buf);
-
-                if (info->edf & A2S_INFO_FLAG_STV) {
-                    info->stv_port = ssq_buf_get_uint16(&buf);
-                    info->stv_name = ssq_buf_get_string(&buf, &(info->stv_name_len));
-                }
-
-                if (info->edf & A2S_INFO_FLAG_KEYWORDS)
-                    info->keywords = ssq_buf_get_string(&buf, &(info->keywords_len));
-
-                if (info->edf & A2S_INFO_FLAG_GAMEID)
-                    info->gameid = ssq_buf_get_uint64(&buf);
-            }
-        } else {
-            ssq_error_set_from_errno(err);
-        }
-    } else {
-        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid A2S_INFO response header");
-    }
+bool ssq_info_deserialize_view(
+    const uint8_t       response[],
+    const size_t        response_len,
+    A2S_INFO_REF *const info,
+    SSQ_ERROR    *const err
+) {
+    return ssq_info_deserialize_view_fields(response, response_len, A2S_INFO_FIELD_ALL, info, err);
+}
 
-    return info;
+bool ssq_info_view_open(
+    const uint8_t        response[],
+    const size_t         response_len,
+    A2S_INFO_VIEW *const view,
+    SSQ_ERROR     *const err
+) {
+    memset(view, 0, sizeof (*view));
+
+    SSQ_BUF buf;
+
+    if (!ssq_info_response_open(response, response_len, &buf, err))
+        return false;
+
+    // Only the strings are scanned, the fixed-size fields between them being skipped over.
+    view->protocol = ssq_buf_reserve(&buf, 1);
+    view->name     = ssq_buf_get_string_view(&buf);
+    view->map      = ssq_buf_get_string_view(&buf);
+    view->folder   = ssq_buf_get_string_view(&buf);
+    view->game     = ssq_buf_get_string_view(&buf);
+    view->details  = ssq_buf_reserve(&buf, A2S_INFO_DETAILS_LEN);
+    view->version  = ssq_buf_get_string_view(&buf);
+    view->trailer  = buf;
+
+    return true;
 }
 
-static uint8_t *ssq_info_query(SSQ_QUERIER *const querier, size_t *const response_len) {
-    uint8_t payload[A2S_INFO_PAYLOAD_LEN];
-    ssq_info_payload_init(payload);
+/**
+ * Decodes the EDF trailer of an A2S_INFO response read through a view, unless it already was.
+ * @param view view on the response
+ */
+static void ssq_info_view_decode_edf(A2S_INFO_VIEW *const view) {
+    if (view->edf_decoded)
+        return;
 
-    uint8_t *response = ssq_query(querier, payload, A2S_INFO_PAYLOAD_LEN_WITHOUT_CHALLENGE, response_len);
+    ssq_schema_decode(g_a2s_info_view_edf_fields, A2S_INFO_VIEW_EDF_FIELD_COUNT, &(view->trailer), view);
+    view->edf_decoded = true;
+}
 
-    while (ssq_ok(querier) && ssq_response_has_challenge(response, *response_len)) {
-        const int32_t chall = ssq_response_get_challenge(response, *response_len);
-        ssq_info_payload_set_challenge(payload, chall);
+/**
+ * Reads a character through the map of an `SSQ_FIELD_CHAR' field.
+ *
+ * @param map value stored for each character read
+ * @param c   character read
+ *
+ * @return value stored for the character, or `SSQ_FIELD_CHAR_UNKNOWN'
+ */
+static int ssq_info_view_char(const char map[], const uint8_t c) {
+    return (map[c] != '\0') ? map[c] : SSQ_FIELD_CHAR_UNKNOWN;
+}
+
+uint8_t ssq_info_view_protocol(const A2S_INFO_VIEW *const view) {
+    return ssq_buf_load_uint8(view->protocol);
+}
+
+SSQ_STRING_VIEW ssq_info_view_name(const A2S_INFO_VIEW *const view) {
+    return view->name;
+}
+
+SSQ_STRING_VIEW ssq_info_view_map(const A2S_INFO_VIEW *const view) {
+    return view->map;
+}
+
+SSQ_STRING_VIEW ssq_info_view_folder(const A2S_INFO_VIEW *const view) {
+    return view->folder;
+}
+
+SSQ_STRING_VIEW ssq_info_view_game(const A2S_INFO_VIEW *const view) {
+    return view->game;
+}
+
+uint16_t ssq_info_view_id(const A2S_INFO_VIEW *const view) {
+    return ssq_buf_load_uint16(view->details + A2S_INFO_DETAILS_ID);
+}
+
+uint8_t ssq_info_view_players(const A2S_INFO_VIEW *const view) {
+    return ssq_buf_load_uint8(view->details + A2S_INFO_DETAILS_PLAYERS);
+}
+
+uint8_t ssq_info_view_max_players(const A2S_INFO_VIEW *const view) {
+    return ssq_buf_load_uint8(view->details + A2S_INFO_DETAILS_MAX_PLAYERS);
+}
+
+uint8_t ssq_info_view_bots(const A2S_INFO_VIEW *const view) {
+    return ssq_buf_load_uint8(view->details + A2S_INFO_DETAILS_BOTS);
+}
+
+A2S_SERVER_TYPE ssq_info_view_server_type(const A2S_INFO_VIEW *const view) {
+    return ssq_info_view_char(g_a2s_info_server_types, view->details[A2S_INFO_DETAILS_SERVER_TYPE]);
+}
 
-        free(response);
-        response = ssq_query(querier, payload, A2S_INFO_PAYLOAD_LEN, response_len);
+A2S_ENVIRONMENT ssq_info_view_environment(const A2S_INFO_VIEW *const view) {
+    return ssq_info_view_char(g_a2s_info_environments, view->details[A2S_INFO_DETAILS_ENVIRONMENT]);
+}
+
+bool ssq_info_view_visibility(const A2S_INFO_VIEW *const view) {
+    return ssq_buf_load_bool(view->details + A2S_INFO_DETAILS_VISIBILITY);
+}
+
+bool ssq_info_view_vac(const A2S_INFO_VIEW *const view) {
+    return ssq_buf_load_bool(view->details + A2S_INFO_DETAILS_VAC);
+}
+
+SSQ_STRING_VIEW ssq_info_view_version(const A2S_INFO_VIEW *const view) {
+    return view->version;
+}
+
+uint8_t ssq_info_view_edf(A2S_INFO_VIEW *const view) {
+    ssq_info_view_decode_edf(view);
+    return view->edf;
+}
+
+uint16_t ssq_info_view_port(A2S_INFO_VIEW *const view) {
+    ssq_info_view_decode_edf(view);
+    return view->port;
+}
+
+uint64_t ssq_info_view_steamid(A2S_INFO_VIEW *const view) {
+    ssq_info_view_decode_edf(view);
+    return view->steamid;
+}
+
+uint16_t ssq_info_view_stv_port(A2S_INFO_VIEW *const view) {
+    ssq_info_view_decode_edf(view);
+    return view->stv_port;
+}
+
+SSQ_STRING_VIEW ssq_info_view_stv_name(A2S_INFO_VIEW *const view) {
+    ssq_info_view_decode_edf(view);
+    return view->stv_name;
+}
+
+SSQ_STRING_VIEW ssq_info_view_keywords(A2S_INFO_VIEW *const view) {
+    ssq_info_view_decode_edf(view);
+    return view->keywords;
+}
+
+uint64_t ssq_info_view_gameid(A2S_INFO_VIEW *const view) {
+    ssq_info_view_decode_edf(view);
+    return view->gameid;
+}
+
+size_t ssq_info_serialize(const A2S_INFO_REF *const info, uint8_t response[], const size_t response_size) {
+    if (response_size != 0)
+        response[0] = S2A_HEADER_INFO;
+
+    return 1 + ssq_schema_encode(
+        g_a2s_info_fields,
+        A2S_INFO_FIELD_COUNT,
+        info,
+        (response_size != 0) ? response + 1 : NULL,
+        (response_size != 0) ? response_size - 1 : 0
+    );
+}
+
+/**
+ * Deserializes some fields of an A2S_INFO response into a previous result, which is reused if the strings read fit in it.
+ * The strings left out have no `str' in the view, hence take no room and are copied as NULL.
+ *
+ * @param response     response buffer
+ * @param response_len length of the response
+ * @param fields       `A2S_INFO_FIELD_*' flags of the fields to read
+ * @param reuse        `A2S_INFO' struct returned by a previous deserialization or query, or NULL
+ * @param err          where to report potential errors
+ *
+ * @return `reuse' or a larger dynamically-allocated `A2S_INFO' struct, in which case `reuse' is freed,
+ *         or NULL if there was an error, in which case `reuse' is left intact
+ */
+static A2S_INFO *ssq_info_deserialize_fields(
+    const uint8_t    response[],
+    const size_t     response_len,
+    uint32_t         fields,
+    A2S_INFO  *const reuse,
+    SSQ_ERROR *const err
+) {
+    // The EDF tells whether the fields it flags are present, which the `ssq_info_has_*' functions rely on.
+    if (fields & A2S_INFO_FIELD_EDF_FLAGGED)
+        fields |= A2S_INFO_FIELD_EDF;
+
+    A2S_INFO_REF ref;
+
+    if (!ssq_info_deserialize_view_fields(response, response_len, fields, &ref, err))
+        return NULL;
+
+    const size_t strings_size =
+        ref.name.len + ref.map.len + ref.folder.len + ref.game.len + ref.version.len + ref.stv_name.len + ref.keywords.len
+        + A2S_INFO_STRING_COUNT;
+
+    // The strings live in the same allocation, right after the struct.
+    A2S_INFO *const info = ssq_mem_reuse(reuse, sizeof (*info) + strings_size);
+
+    if (info == NULL) {
+        ssq_error_set_from_errno(err);
+        return NULL;
     }
 
-    return response;
+    char *arena = (char *)(info + 1);
+
+    info->protocol    = ref.protocol;
+    info->name        = ssq_buf_copy_string_view(ref.name, &arena, &(info->name_len));
+    info->map         = ssq_buf_copy_string_view(ref.map, &arena, &(info->map_len));
+    info->folder      = ssq_buf_copy_string_view(ref.folder, &arena, &(info->folder_len));
+    info->game        = ssq_buf_copy_string_view(ref.game, &arena, &(info->game_len));
+    info->id          = ref.id;
+    info->players     = ref.players;
+    info->max_players = ref.max_players;
+    info->bots        = ref.bots;
+    info->server_type = ref.server_type;
+    info->environment = ref.environment;
+    info->visibility  = ref.visibility;
+    info->vac         = ref.vac;
+    info->version     = ssq_buf_copy_string_view(ref.version, &arena, &(info->version_len));
+    info->edf         = ref.edf;
+    info->port        = ref.port;
+    info->steamid     = ref.steamid;
+    info->stv_port    = ref.stv_port;
+    info->stv_name    = ssq_buf_copy_string_view(ref.stv_name, &arena, &(info->stv_name_len));
+    info->keywords    = ssq_buf_copy_string_view(ref.keywords, &arena, &(info->keywords_len));
+    info->gameid      = ref.gameid;
+    info->fields      = fields;
+
+    return info;
 }
 
-A2S_INFO *ssq_info(SSQ_QUERIER *const querier) {
+A2S_INFO *ssq_info_deserialize(const uint8_t payload[], const size_t payload_len, SSQ_ERROR *const err) {
+    return ssq_info_deserialize_fields(payload, payload_len, A2S_INFO_FIELD_ALL, NULL, err);
+}
+
+A2S_INFO *ssq_info_deserialize_ex(
+    const uint8_t    response[],
+    const size_t     response_len,
+    const uint32_t   fields,
+    SSQ_ERROR *const err
+) {
+    return ssq_info_deserialize_fields(response, response_len, fields & A2S_INFO_FIELD_ALL, NULL, err);
+}
+
+A2S_INFO *ssq_info_deserialize_into(
+    const uint8_t    response[],
+    const size_t     response_len,
+    A2S_INFO  *const reuse,
+    SSQ_ERROR *const err
+) {
+    return ssq_info_deserialize_fields(response, response_len, A2S_INFO_FIELD_ALL, reuse, err);
+}
+
+/**
+ * Sends an A2S_INFO query to a Source game server and deserializes some fields of the response into a previous result.
+ *
+ * @param querier Source server querier to use
+ * @param fields  `A2S_INFO_FIELD_*' flags of the fields to read
+ * @param reuse   `A2S_INFO' struct returned by a previous query, or NULL
+ *
+ * @return `reuse' or a larger dynamically-allocated `A2S_INFO' struct, in which case `reuse' is freed,
+ *         or NULL if there was an error, in which case `reuse' is left intact
+ */
+static A2S_INFO *ssq_info_query(SSQ_QUERIER *const querier, const uint32_t fields, A2S_INFO *const reuse) {
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(querier->mem);
+
     A2S_INFO *info = NULL;
 
     size_t         response_len;
-    uint8_t *const response = ssq_info_query(querier, &response_len);
+    uint8_t *const response = ssq_query_challenge(querier, ssq_info_payload, &response_len);
 
     if (ssq_ok(querier)) {
-        info = ssq_info_deserialize(response, response_len, &(querier->err));
-        free(response);
+        info = ssq_info_deserialize_fields(response, response_len, fields, reuse, &(querier->err));
+        ssq_mem_free(response);
     }
 
+    ssq_mem_charge(charged);
+
     return info;
 }
 
-void ssq_info_free(A2S_INFO *const info) {
-    free(info->name);
-    free(info->map);
-    free(info->folder);
-    free(info->game);
-    free(info->version);
+A2S_INFO *ssq_info(SSQ_QUERIER *const querier) {
+    return ssq_info_query(querier, A2S_INFO_FIELD_ALL, NULL);
+}
 
-    if (ssq_info_has_stv(info))
-        free(info->stv_name);
+A2S_INFO *ssq_info_ex(SSQ_QUERIER *const querier, const uint32_t fields) {
+    return ssq_info_query(querier, fields & A2S_INFO_FIELD_ALL, NULL);
+}
 
-    if (ssq_info_has_keywords(info))
-        free(info->keywords);
+A2S_INFO *ssq_info_into(SSQ_QUERIER *const querier, A2S_INFO *const reuse) {
+    return ssq_info_query(querier, A2S_INFO_FIELD_ALL, reuse);
+}
 
-    free(info);
+void ssq_info_free(A2S_INFO *const info) {
+    ssq_mem_free_sized(info);
 }
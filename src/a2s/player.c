@@ -1,16 +1,33 @@
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include "ssq/a2s/player.h"
 #include "ssq/buf.h"
+#include "ssq/mem.h"
 #include "ssq/query.h"
 #include "ssq/response.h"
+#include "ssq/schema.h"
 
 #define A2S_HEADER_PLAYER 0x55
-#define S2A_HEADER_PLAYER 0x44
 
-#define A2S_PLAYER_PAYLOAD_LEN              9
 #define A2S_PLAYER_PAYLOAD_CHALLENGE_OFFSET 5
 
+/*
+ * Fields of a player of an A2S_PLAYER response, in the order of the wire format.
+ * X(field of `A2S_PLAYER_REF', type).
+ */
+#define A2S_PLAYER_FIELDS(X)      \
+    X(index,    SSQ_FIELD_UINT8)  \
+    X(name,     SSQ_FIELD_STRING) \
+    X(score,    SSQ_FIELD_INT32)  \
+    X(duration, SSQ_FIELD_FLOAT)
+
+#define A2S_PLAYER_FIELD(field, type) { offsetof(A2S_PLAYER_REF, field), type, 0, NULL },
+
+static const SSQ_FIELD g_a2s_player_fields[] = { A2S_PLAYER_FIELDS(A2S_PLAYER_FIELD) };
+
+#define A2S_PLAYER_FIELD_COUNT (sizeof (g_a2s_player_fields) / sizeof (*g_a2s_player_fields))
+
 static const uint8_t g_a2s_player_payload_template[A2S_PLAYER_PAYLOAD_LEN] = {
     0xFF, 0xFF, 0xFF, 0xFF, A2S_HEADER_PLAYER, 0xFF, 0xFF, 0xFF, 0xFF
 };
@@ -23,11 +40,28 @@ static inline void ssq_player_payload_set_challenge(uint8_t payload[A2S_PLAYER_P
     memcpy(payload + A2S_PLAYER_PAYLOAD_CHALLENGE_OFFSET, &chall, sizeof (chall));
 }
 
+size_t ssq_player_payload(uint8_t payload[A2S_PLAYER_PAYLOAD_LEN], const int32_t chall) {
+    ssq_player_payload_init(payload);
+    ssq_player_payload_set_challenge(payload, chall);
+
+    return A2S_PLAYER_PAYLOAD_LEN;
+}
+
 A2S_PLAYER *ssq_player_deserialize(
     const uint8_t    response[],
     const size_t     response_len,
     uint8_t   *const player_count,
     SSQ_ERROR *const err
+) {
+    return ssq_player_deserialize_into(response, response_len, NULL, player_count, err);
+}
+
+A2S_PLAYER *ssq_player_deserialize_into(
+    const uint8_t     response[],
+    const size_t      response_len,
+    A2S_PLAYER *const reuse,
+    uint8_t    *const player_count,
+    SSQ_ERROR  *const err
 ) {
     A2S_PLAYER *players = NULL;
 
@@ -36,24 +70,36 @@ A2S_PLAYER *ssq_player_deserialize(
     if (ssq_response_is_truncated(response, response_len))
         ssq_buf_forward(&buf, 4);
 
-    const uint8_t response_header = ssq_buf_get_uint8(&buf);
+    const uint8_t response_header = ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1));
 
     if (response_header == S2A_HEADER_PLAYER) {
-        *player_count = ssq_buf_get_uint8(&buf);
+        const uint8_t count = ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1));
 
-        if (*player_count != 0) {
-            players = calloc(*player_count, sizeof (*players));
+        if (count != 0) {
+            // The strings live in the same allocation, right after the array.
+            players = ssq_mem_reuse(reuse, count * sizeof (*players) + ssq_buf_strings_size(&buf, count));
 
             if (players != NULL) {
-                for (uint8_t i = 0; i < *player_count; ++i) {
-                    players[i].index    = ssq_buf_get_uint8(&buf);
-                    players[i].name     = ssq_buf_get_string(&buf, &(players[i].name_len));
-                    players[i].score    = ssq_buf_get_int32(&buf);
-                    players[i].duration = ssq_buf_get_float(&buf);
+                char *arena = (char *)(players + count);
+
+                *player_count = count;
+
+                for (uint8_t i = 0; i < count; ++i) {
+                    A2S_PLAYER_REF ref;
+                    ssq_schema_decode(g_a2s_player_fields, A2S_PLAYER_FIELD_COUNT, &buf, &ref);
+
+                    players[i].index    = ref.index;
+                    players[i].name     = ssq_buf_copy_string_view(ref.name, &arena, &(players[i].name_len));
+                    players[i].score    = ref.score;
+                    players[i].duration = ref.duration;
                 }
             } else {
                 ssq_error_set_from_errno(err);
             }
+        } else {
+            // The array is kept for the next responses.
+            players       = reuse;
+            *player_count = 0;
         }
     } else {
         ssq_error_set(err, SSQ_ERR_BADRES, "Invalid A2S_PLAYER response header");
@@ -62,40 +108,147 @@ A2S_PLAYER *ssq_player_deserialize(
     return players;
 }
 
-static uint8_t *ssq_player_query(SSQ_QUERIER *const querier, size_t *const response_len) {
-    uint8_t payload[A2S_PLAYER_PAYLOAD_LEN];
-    ssq_player_payload_init(payload);
+A2S_PLAYER_REF *ssq_player_deserialize_view(
+    const uint8_t         response[],
+    const size_t          response_len,
+    A2S_PLAYER_REF *const storage,
+    const size_t          storage_count,
+    uint8_t        *const player_count,
+    SSQ_ERROR      *const err
+) {
+    A2S_PLAYER_REF *players = NULL;
+
+    SSQ_BUF buf = ssq_buf_init(response, response_len);
+
+    if (ssq_response_is_truncated(response, response_len))
+        ssq_buf_forward(&buf, 4);
+
+    const uint8_t response_header = ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1));
+
+    if (response_header == S2A_HEADER_PLAYER) {
+        *player_count = ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1));
+
+        if (*player_count != 0) {
+            players = (*player_count <= storage_count) ? storage : ssq_mem_alloc(*player_count * sizeof (*players));
+
+            if (players != NULL) {
+                for (uint8_t i = 0; i < *player_count; ++i)
+                    ssq_schema_decode(g_a2s_player_fields, A2S_PLAYER_FIELD_COUNT, &buf, &(players[i]));
+            } else {
+                ssq_error_set_from_errno(err);
+            }
+        }
+    } else {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid A2S_PLAYER response header");
+    }
+
+    return players;
+}
+
+void ssq_player_deserialize_foreach(
+    const uint8_t             response[],
+    const size_t              response_len,
+    const SSQ_PLAYER_CALLBACK callback,
+    void               *const user_data,
+    SSQ_ERROR          *const err
+) {
+    SSQ_BUF buf = ssq_buf_init(response, response_len);
+
+    if (ssq_response_is_truncated(response, response_len))
+        ssq_buf_forward(&buf, 4);
+
+    const uint8_t response_header = ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1));
+
+    if (response_header != S2A_HEADER_PLAYER) {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid A2S_PLAYER response header");
+        return;
+    }
+
+    const uint8_t player_count = ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1));
+
+    for (uint8_t i = 0; i < player_count; ++i) {
+        A2S_PLAYER_REF player;
+        ssq_schema_decode(g_a2s_player_fields, A2S_PLAYER_FIELD_COUNT, &buf, &player);
+
+        if (!callback(&player, user_data))
+            break;
+    }
+}
+
+size_t ssq_player_serialize(
+    const A2S_PLAYER_REF players[],
+    const uint8_t        player_count,
+    uint8_t              response[],
+    const size_t         response_size
+) {
+    const uint8_t header[] = { S2A_HEADER_PLAYER, player_count };
 
-    uint8_t *response = ssq_query(querier, payload, A2S_PLAYER_PAYLOAD_LEN, response_len);
+    size_t len = sizeof (header);
 
-    while (ssq_ok(querier) && ssq_response_has_challenge(response, *response_len)) {
-        const int32_t chall = ssq_response_get_challenge(response, *response_len);
-        ssq_player_payload_set_challenge(payload, chall);
+    if (response_size >= len)
+        memcpy(response, header, len);
 
-        free(response);
-        response = ssq_query(querier, payload, A2S_PLAYER_PAYLOAD_LEN, response_len);
+    for (uint8_t i = 0; i < player_count; ++i) {
+        len += ssq_schema_encode(
+            g_a2s_player_fields,
+            A2S_PLAYER_FIELD_COUNT,
+            &(players[i]),
+            (len <= response_size) ? response + len : NULL,
+            (len <= response_size) ? response_size - len : 0
+        );
     }
 
-    return response;
+    return len;
 }
 
 A2S_PLAYER *ssq_player(SSQ_QUERIER *const querier, uint8_t *const player_count) {
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(querier->mem);
+
     A2S_PLAYER *players = NULL;
 
     size_t          response_len;
-    uint8_t  *const response = ssq_player_query(querier, &response_len);
+    uint8_t  *const response = ssq_query_challenge(querier, ssq_player_payload, &response_len);
 
     if (ssq_ok(querier)) {
         players = ssq_player_deserialize(response, response_len, player_count, &(querier->err));
-        free(response);
+        ssq_mem_free(response);
+    }
+
+    ssq_mem_charge(charged);
+
+    return players;
+}
+
+A2S_PLAYER *ssq_player_into(SSQ_QUERIER *const querier, A2S_PLAYER *const reuse, uint8_t *const player_count) {
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(querier->mem);
+
+    A2S_PLAYER *players = NULL;
+
+    size_t         response_len;
+    uint8_t *const response = ssq_query_challenge(querier, ssq_player_payload, &response_len);
+
+    if (ssq_ok(querier)) {
+        players = ssq_player_deserialize_into(response, response_len, reuse, player_count, &(querier->err));
+        ssq_mem_free(response);
     }
 
+    ssq_mem_charge(charged);
+
     return players;
 }
 
+void ssq_player_foreach(SSQ_QUERIER *const querier, const SSQ_PLAYER_CALLBACK callback, void *const user_data) {
+    size_t         response_len;
+    uint8_t *const response = ssq_query_challenge(querier, ssq_player_payload, &response_len);
+
+    if (ssq_ok(querier)) {
+        ssq_player_deserialize_foreach(response, response_len, callback, user_data, &(querier->err));
+        ssq_mem_free(response);
+    }
+}
+
 void ssq_player_free(A2S_PLAYER players[], const uint8_t player_count) {
-    for (uint8_t i = 0; i < player_count; ++i)
-        free(players[i].name);
+    (void)player_count;
 
-    free(players);
+    ssq_mem_free_sized(players);
 }
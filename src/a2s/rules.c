@@ -1,16 +1,31 @@
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include "ssq/a2s/rules.h"
 #include "ssq/buf.h"
+#include "ssq/mem.h"
 #include "ssq/query.h"
 #include "ssq/response.h"
+#include "ssq/schema.h"
 
 #define A2S_HEADER_RULES 0x56
-#define S2A_HEADER_RULES 0x45
 
-#define A2S_RULES_PAYLOAD_LEN              9
 #define A2S_RULES_PAYLOAD_CHALLENGE_OFFSET 5
 
+/*
+ * Fields of a rule of an A2S_RULES response, in the order of the wire format.
+ * X(field of `A2S_RULES_REF', type).
+ */
+#define A2S_RULES_FIELDS(X)    \
+    X(name,  SSQ_FIELD_STRING) \
+    X(value, SSQ_FIELD_STRING)
+
+#define A2S_RULES_FIELD(field, type) { offsetof(A2S_RULES_REF, field), type, 0, NULL },
+
+static const SSQ_FIELD g_a2s_rules_fields[] = { A2S_RULES_FIELDS(A2S_RULES_FIELD) };
+
+#define A2S_RULES_FIELD_COUNT (sizeof (g_a2s_rules_fields) / sizeof (*g_a2s_rules_fields))
+
 static const uint8_t g_a2s_rules_payload_template[A2S_RULES_PAYLOAD_LEN] = {
     0xFF, 0xFF, 0xFF, 0xFF, A2S_HEADER_RULES, 0xFF, 0xFF, 0xFF, 0xFF
 };
@@ -23,11 +38,28 @@ static inline void ssq_rules_payload_set_challenge(uint8_t payload[A2S_RULES_PAY
     memcpy(payload + A2S_RULES_PAYLOAD_CHALLENGE_OFFSET, &chall, sizeof (chall));
 }
 
+size_t ssq_rules_payload(uint8_t payload[A2S_RULES_PAYLOAD_LEN], const int32_t chall) {
+    ssq_rules_payload_init(payload);
+    ssq_rules_payload_set_challenge(payload, chall);
+
+    return A2S_RULES_PAYLOAD_LEN;
+}
+
 A2S_RULES *ssq_rules_deserialize(
     const uint8_t    response[],
     const size_t     response_len,
     uint16_t  *const rule_count,
     SSQ_ERROR *const err
+) {
+    return ssq_rules_deserialize_into(response, response_len, NULL, rule_count, err);
+}
+
+A2S_RULES *ssq_rules_deserialize_into(
+    const uint8_t    response[],
+    const size_t     response_len,
+    A2S_RULES *const reuse,
+    uint16_t  *const rule_count,
+    SSQ_ERROR *const err
 ) {
     A2S_RULES *rules = NULL;
 
@@ -36,22 +68,34 @@ A2S_RULES *ssq_rules_deserialize(
     if (ssq_response_is_truncated(response, response_len))
         ssq_buf_forward(&buf, 4);
 
-    const uint8_t response_header = ssq_buf_get_uint8(&buf);
+    const uint8_t response_header = ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1));
 
     if (response_header == S2A_HEADER_RULES) {
-        *rule_count = ssq_buf_get_uint16(&buf);
+        const uint16_t count = ssq_buf_load_uint16(ssq_buf_reserve(&buf, sizeof (count)));
 
-        if (*rule_count != 0) {
-            rules = calloc(*rule_count, sizeof (*rules));
+        if (count != 0) {
+            // The strings live in the same allocation, right after the array.
+            rules = ssq_mem_reuse(reuse, count * sizeof (*rules) + ssq_buf_strings_size(&buf, 2 * (size_t)count));
 
             if (rules != NULL) {
-                for (uint16_t i = 0; i < *rule_count; ++i) {
-                    rules[i].name  = ssq_buf_get_string(&buf, &(rules[i].name_len));
-                    rules[i].value = ssq_buf_get_string(&buf, &(rules[i].value_len));
+                char *arena = (char *)(rules + count);
+
+                *rule_count = count;
+
+                for (uint16_t i = 0; i < count; ++i) {
+                    A2S_RULES_REF ref;
+                    ssq_schema_decode(g_a2s_rules_fields, A2S_RULES_FIELD_COUNT, &buf, &ref);
+
+                    rules[i].name  = ssq_buf_copy_string_view(ref.name, &arena, &(rules[i].name_len));
+                    rules[i].value = ssq_buf_copy_string_view(ref.value, &arena, &(rules[i].value_len));
                 }
             } else {
                 ssq_error_set_from_errno(err);
             }
+        } else {
+            // The array is kept for the next responses.
+            rules       = reuse;
+            *rule_count = 0;
         }
     } else {
         ssq_error_set(err, SSQ_ERR_BADRES, "Invalid A2S_RULES response header");
@@ -60,42 +104,148 @@ A2S_RULES *ssq_rules_deserialize(
     return rules;
 }
 
-static uint8_t *ssq_rules_query(SSQ_QUERIER *const querier, size_t *const response_len) {
-    uint8_t payload[A2S_RULES_PAYLOAD_LEN];
-    ssq_rules_payload_init(payload);
+A2S_RULES_REF *ssq_rules_deserialize_view(
+    const uint8_t        response[],
+    const size_t         response_len,
+    A2S_RULES_REF *const storage,
+    const size_t         storage_count,
+    uint16_t      *const rule_count,
+    SSQ_ERROR     *const err
+) {
+    A2S_RULES_REF *rules = NULL;
+
+    SSQ_BUF buf = ssq_buf_init(response, response_len);
+
+    if (ssq_response_is_truncated(response, response_len))
+        ssq_buf_forward(&buf, 4);
+
+    const uint8_t response_header = ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1));
+
+    if (response_header == S2A_HEADER_RULES) {
+        *rule_count = ssq_buf_load_uint16(ssq_buf_reserve(&buf, sizeof (*rule_count)));
+
+        if (*rule_count != 0) {
+            rules = (*rule_count <= storage_count) ? storage : ssq_mem_alloc(*rule_count * sizeof (*rules));
+
+            if (rules != NULL) {
+                for (uint16_t i = 0; i < *rule_count; ++i)
+                    ssq_schema_decode(g_a2s_rules_fields, A2S_RULES_FIELD_COUNT, &buf, &(rules[i]));
+            } else {
+                ssq_error_set_from_errno(err);
+            }
+        }
+    } else {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid A2S_RULES response header");
+    }
+
+    return rules;
+}
+
+void ssq_rules_deserialize_foreach(
+    const uint8_t            response[],
+    const size_t             response_len,
+    const SSQ_RULES_CALLBACK callback,
+    void              *const user_data,
+    SSQ_ERROR         *const err
+) {
+    SSQ_BUF buf = ssq_buf_init(response, response_len);
 
-    uint8_t *response = ssq_query(querier, payload, A2S_RULES_PAYLOAD_LEN, response_len);
+    if (ssq_response_is_truncated(response, response_len))
+        ssq_buf_forward(&buf, 4);
 
-    while (ssq_ok(querier) && ssq_response_has_challenge(response, *response_len)) {
-        const int32_t chall = ssq_response_get_challenge(response, *response_len);
-        ssq_rules_payload_set_challenge(payload, chall);
+    const uint8_t response_header = ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1));
 
-        free(response);
-        response = ssq_query(querier, payload, A2S_RULES_PAYLOAD_LEN, response_len);
+    if (response_header != S2A_HEADER_RULES) {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid A2S_RULES response header");
+        return;
     }
 
-    return response;
+    const uint16_t rule_count = ssq_buf_load_uint16(ssq_buf_reserve(&buf, sizeof (rule_count)));
+
+    for (uint16_t i = 0; i < rule_count; ++i) {
+        A2S_RULES_REF rule;
+        ssq_schema_decode(g_a2s_rules_fields, A2S_RULES_FIELD_COUNT, &buf, &rule);
+
+        if (!callback(&rule, user_data))
+            break;
+    }
+}
+
+size_t ssq_rules_serialize(
+    const A2S_RULES_REF rules[],
+    const uint16_t      rule_count,
+    uint8_t             response[],
+    const size_t        response_size
+) {
+    uint8_t header[3] = { S2A_HEADER_RULES };
+    memcpy(header + 1, &rule_count, sizeof (rule_count));
+
+    size_t len = sizeof (header);
+
+    if (response_size >= len)
+        memcpy(response, header, len);
+
+    for (uint16_t i = 0; i < rule_count; ++i) {
+        len += ssq_schema_encode(
+            g_a2s_rules_fields,
+            A2S_RULES_FIELD_COUNT,
+            &(rules[i]),
+            (len <= response_size) ? response + len : NULL,
+            (len <= response_size) ? response_size - len : 0
+        );
+    }
+
+    return len;
 }
 
 A2S_RULES *ssq_rules(SSQ_QUERIER *const querier, uint16_t *const rule_count) {
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(querier->mem);
+
     A2S_RULES *rules = NULL;
 
     size_t         response_len;
-    uint8_t *const response = ssq_rules_query(querier, &response_len);
+    uint8_t *const response = ssq_query_challenge(querier, ssq_rules_payload, &response_len);
 
     if (ssq_ok(querier)) {
         rules = ssq_rules_deserialize(response, response_len, rule_count, &(querier->err));
-        free(response);
+        ssq_mem_free(response);
     }
 
+    ssq_mem_charge(charged);
+
     return rules;
 }
 
-void ssq_rules_free(A2S_RULES rules[], const uint16_t rule_count) {
-    for (uint16_t i = 0; i < rule_count; ++i) {
-        free(rules[i].name);
-        free(rules[i].value);
+A2S_RULES *ssq_rules_into(SSQ_QUERIER *const querier, A2S_RULES *const reuse, uint16_t *const rule_count) {
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(querier->mem);
+
+    A2S_RULES *rules = NULL;
+
+    size_t         response_len;
+    uint8_t *const response = ssq_query_challenge(querier, ssq_rules_payload, &response_len);
+
+    if (ssq_ok(querier)) {
+        rules = ssq_rules_deserialize_into(response, response_len, reuse, rule_count, &(querier->err));
+        ssq_mem_free(response);
     }
 
-    free(rules);
+    ssq_mem_charge(charged);
+
+    return rules;
+}
+
+void ssq_rules_foreach(SSQ_QUERIER *const querier, const SSQ_RULES_CALLBACK callback, void *const user_data) {
+    size_t         response_len;
+    uint8_t *const response = ssq_query_challenge(querier, ssq_rules_payload, &response_len);
+
+    if (ssq_ok(querier)) {
+        ssq_rules_deserialize_foreach(response, response_len, callback, user_data, &(querier->err));
+        ssq_mem_free(response);
+    }
+}
+
+void ssq_rules_free(A2S_RULES rules[], const uint16_t rule_count) {
+    (void)rule_count;
+
+    ssq_mem_free_sized(rules);
 }
@@ -0,0 +1,125 @@
+#define _GNU_SOURCE /* sendmmsg, recvmmsg */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "ssq/batch.h"
+#include "ssq/mem.h"
+
+void ssq_batch_init(SSQ_BATCH *const batch, const size_t capacity, SSQ_ERROR *const err) {
+    memset(batch, 0, sizeof (*batch));
+
+    batch->slots  = ssq_mem_alloc(capacity * sizeof (*(batch->slots)));
+    batch->lens   = ssq_mem_alloc(capacity * sizeof (*(batch->lens)));
+    batch->addrs  = ssq_mem_alloc(capacity * sizeof (*(batch->addrs)));
+    batch->msgs   = ssq_mem_alloc(capacity * sizeof (*(batch->msgs)));
+    batch->iovecs = ssq_mem_alloc(capacity * sizeof (*(batch->iovecs)));
+
+    if (batch->slots == NULL || batch->lens == NULL || batch->addrs == NULL || batch->msgs == NULL || batch->iovecs == NULL) {
+        ssq_error_set_from_errno(err);
+        ssq_batch_free(batch);
+        return;
+    }
+
+    batch->capacity = capacity;
+}
+
+void ssq_batch_free(SSQ_BATCH *const batch) {
+    ssq_mem_free(batch->slots);
+    ssq_mem_free(batch->lens);
+    ssq_mem_free(batch->addrs);
+    ssq_mem_free(batch->msgs);
+    ssq_mem_free(batch->iovecs);
+
+    memset(batch, 0, sizeof (*batch));
+}
+
+void ssq_batch_clear(SSQ_BATCH *const batch) {
+    batch->count = 0;
+}
+
+bool ssq_batch_push(
+    SSQ_BATCH             *const batch,
+    const uint8_t                datagram[],
+    const size_t                 datagram_len,
+    const struct sockaddr *const addr,
+    const socklen_t              addr_len
+) {
+    if (batch->count == batch->capacity || datagram_len > SSQ_PACKET_SIZE || addr_len > sizeof (*(batch->addrs)))
+        return false;
+
+    const size_t i = (batch->count)++;
+
+    memcpy(batch->slots[i], datagram, datagram_len);
+    batch->lens[i] = (uint16_t)datagram_len;
+
+    struct msghdr *const hdr = &(batch->msgs[i].msg_hdr);
+    memset(hdr, 0, sizeof (*hdr));
+
+    if (addr != NULL) {
+        memcpy(&(batch->addrs[i]), addr, addr_len);
+        hdr->msg_name    = &(batch->addrs[i]);
+        hdr->msg_namelen = addr_len;
+    }
+
+    batch->iovecs[i].iov_base = batch->slots[i];
+    batch->iovecs[i].iov_len  = datagram_len;
+    hdr->msg_iov              = &(batch->iovecs[i]);
+    hdr->msg_iovlen           = 1;
+
+    return true;
+}
+
+size_t ssq_batch_send(SSQ_BATCH *const batch, const int sockfd, SSQ_ERROR *const err) {
+    size_t next = 0;
+    size_t sent = 0;
+
+    while (next < batch->count) {
+        const int result = sendmmsg(sockfd, batch->msgs + next, (unsigned int)(batch->count - next), 0);
+
+        if (result != -1) {
+            next += (size_t)result;
+            sent += (size_t)result;
+        } else if (errno != EINTR) {
+            ssq_error_set_from_errno(err);
+            ++next;
+        }
+    }
+
+    batch->count = 0;
+
+    return sent;
+}
+
+size_t ssq_batch_recv(SSQ_BATCH *const batch, const int sockfd, SSQ_ERROR *const err) {
+    for (size_t i = 0; i < batch->capacity; ++i) {
+        batch->iovecs[i].iov_base = batch->slots[i];
+        batch->iovecs[i].iov_len  = SSQ_PACKET_SIZE;
+
+        struct msghdr *const hdr = &(batch->msgs[i].msg_hdr);
+        memset(hdr, 0, sizeof (*hdr));
+        hdr->msg_name    = &(batch->addrs[i]);
+        hdr->msg_namelen = sizeof (*(batch->addrs));
+        hdr->msg_iov     = &(batch->iovecs[i]);
+        hdr->msg_iovlen  = 1;
+    }
+
+    const int result = recvmmsg(sockfd, batch->msgs, (unsigned int)batch->capacity, MSG_DONTWAIT, NULL);
+
+    if (result == -1) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            ssq_error_set_from_errno(err);
+
+        batch->count = 0;
+        return 0;
+    }
+
+    batch->count = (size_t)result;
+
+    for (size_t i = 0; i < batch->count; ++i)
+        batch->lens[i] = (uint16_t)batch->msgs[i].msg_len;
+
+    return batch->count;
+}
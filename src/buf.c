@@ -2,6 +2,15 @@
 #include <string.h>
 #include "ssq/buf.h"
 #include "ssq/helper.h"
+#include "ssq/mem.h"
+
+/* SSE2 is part of x86-64, while AVX2 is looked up at runtime. */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+# define SSQ_BUF_HAVE_SSE2
+# include <immintrin.h>
+#endif
+
+const uint8_t ssq_buf_zeroes[SSQ_BUF_RESERVE_MAX] = { 0 };
 
 SSQ_BUF ssq_buf_init(const void *src, const size_t n) {
     SSQ_BUF buf;
@@ -98,27 +107,91 @@ bool ssq_buf_get_bool(SSQ_BUF *const buf) {
     return ssq_buf_get_uint8(buf) != 0;
 }
 
+static size_t ssq_buf_scan_nul_scalar(const uint8_t src[], const size_t n) {
+    size_t len = 0;
+
+    while (len < n && src[len] != '\0')
+        ++len;
+
+    return len;
+}
+
+#ifdef SSQ_BUF_HAVE_SSE2
+static size_t ssq_buf_scan_nul_sse2(const uint8_t src[], const size_t n) {
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t len = 0;
+
+    // Whole blocks only, so that nothing is read past the bound.
+    for (; n - len >= 16; len += 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *)(src + len));
+        const int     mask  = _mm_movemask_epi8(_mm_cmpeq_epi8(block, zero));
+
+        if (mask != 0)
+            return len + (size_t)__builtin_ctz((unsigned int)mask);
+    }
+
+    return len + ssq_buf_scan_nul_scalar(src + len, n - len);
+}
+
+__attribute__((target("avx2")))
+static size_t ssq_buf_scan_nul_avx2(const uint8_t src[], const size_t n) {
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t len = 0;
+
+    for (; n - len >= 32; len += 32) {
+        const __m256i block = _mm256_loadu_si256((const __m256i *)(src + len));
+        const int     mask  = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero));
+
+        if (mask != 0)
+            return len + (size_t)__builtin_ctz((unsigned int)mask);
+    }
+
+    return len + ssq_buf_scan_nul_sse2(src + len, n - len);
+}
+
 /**
- * Computes the length of a null-terminated string at a byte buffer's current position.
- * If there is no null terminator, the string is considered to end at the end of the byte buffer.
+ * Picks the fastest scanner the CPU supports, on the first scan.
  *
- * @param buf byte buffer
+ * @param src bytes to scan
+ * @param n   number of bytes to scan
  *
- * @returns length of the null-terminated string at the byte buffer's current position
+ * @return offset of the first null byte, or N if there is none
  */
-static size_t ssq_buf_get_string_len(const SSQ_BUF *const buf) {
-    size_t len = 0;
+static size_t ssq_buf_scan_nul_init(const uint8_t src[], size_t n);
 
-    while (len < ssq_buf_available(buf) && buf->payload[buf->cursor + len] != '\0')
-        ++len;
+/* Scanner in use, only accessed atomically since the threads making their first scan may race to pick it. */
+static size_t (*g_scan_nul)(const uint8_t *, size_t) = ssq_buf_scan_nul_init;
 
-    return len;
+static size_t ssq_buf_scan_nul_init(const uint8_t src[], const size_t n) {
+    __builtin_cpu_init();
+
+    size_t (*const scan_nul)(const uint8_t *, size_t) = __builtin_cpu_supports("avx2") ? ssq_buf_scan_nul_avx2 : ssq_buf_scan_nul_sse2;
+
+    // The pointer publishes no other data, hence the relaxed ordering.
+    __atomic_store_n(&g_scan_nul, scan_nul, __ATOMIC_RELAXED);
+
+    return scan_nul(src, n);
+}
+
+size_t ssq_buf_scan_nul(const uint8_t src[], const size_t n) {
+    return __atomic_load_n(&g_scan_nul, __ATOMIC_RELAXED)(src, n);
+}
+#else /* not SSQ_BUF_HAVE_SSE2 */
+size_t ssq_buf_scan_nul(const uint8_t src[], const size_t n) {
+    return ssq_buf_scan_nul_scalar(src, n);
+}
+#endif /* SSQ_BUF_HAVE_SSE2 */
+
+size_t ssq_buf_get_string_len(const SSQ_BUF *const buf) {
+    return ssq_buf_eof(buf) ? 0 : ssq_buf_scan_nul(buf->payload + buf->cursor, buf->payload_len - buf->cursor);
 }
 
 char *ssq_buf_get_string(SSQ_BUF *const buf, size_t *const len) {
     *len = ssq_buf_get_string_len(buf);
 
-    char *const dst = calloc(*len + 1, sizeof (*dst));
+    char *const dst = ssq_mem_calloc(*len + 1, sizeof (*dst));
 
     if (dst != NULL) {
         const char *const src = (const char *)(buf->payload + buf->cursor);
@@ -128,3 +201,34 @@ char *ssq_buf_get_string(SSQ_BUF *const buf, size_t *const len) {
 
     return dst;
 }
+
+size_t ssq_buf_strings_size(const SSQ_BUF *const buf, const size_t string_count) {
+    return ssq_buf_available(buf) + string_count;
+}
+
+char *ssq_buf_get_string_into(SSQ_BUF *const buf, char **const arena, size_t *const len) {
+    *len = ssq_buf_get_string_len(buf);
+
+    char *const dst = *arena;
+
+    if (*len != 0)
+        memcpy(dst, buf->payload + buf->cursor, *len);
+
+    dst[*len] = '\0';
+    ssq_buf_forward(buf, *len + 1);
+
+    *arena += *len + 1;
+
+    return dst;
+}
+
+SSQ_STRING_VIEW ssq_buf_get_string_view(SSQ_BUF *const buf) {
+    SSQ_STRING_VIEW view;
+
+    view.len = ssq_buf_get_string_len(buf);
+    view.str = ssq_buf_eof(buf) ? "" : (const char *)(buf->payload + buf->cursor);
+
+    ssq_buf_forward(buf, view.len + 1);
+
+    return view;
+}
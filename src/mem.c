@@ -0,0 +1,212 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ssq/mem.h"
+
+#ifdef _WIN32
+# define SSQ_THREAD_LOCAL __declspec(thread)
+#else /* not _WIN32 */
+# define SSQ_THREAD_LOCAL __thread
+#endif /* _WIN32 */
+
+/* Header of an accounted allocation, whose size keeps the memory past it aligned. */
+typedef struct ssq_mem_header {
+    size_t         size;  /** Number of bytes allocated past the header */
+    SSQ_MEM_STATS *stats; /** Statistics charged, or NULL               */
+} SSQ_MEM_HEADER;
+
+#define SSQ_MEM_HEADER_SIZE 16
+
+/* Offset of sized memory past the size it records, which keeps it aligned. */
+#define SSQ_MEM_SIZED_HEADER_SIZE 16
+
+static void *ssq_mem_libc_malloc(const size_t size, void *const user_data) {
+    (void)user_data;
+    return malloc(size);
+}
+
+static void *ssq_mem_libc_calloc(const size_t count, const size_t size, void *const user_data) {
+    (void)user_data;
+    return calloc(count, size);
+}
+
+static void ssq_mem_libc_free(void *const ptr, void *const user_data) {
+    (void)user_data;
+    free(ptr);
+}
+
+static SSQ_MALLOC_FN g_malloc_fn  = ssq_mem_libc_malloc;
+static SSQ_CALLOC_FN g_calloc_fn  = ssq_mem_libc_calloc;
+static SSQ_FREE_FN   g_free_fn    = ssq_mem_libc_free;
+static void         *g_user_data  = NULL;
+static bool          g_accounting = false;
+
+static SSQ_THREAD_LOCAL SSQ_MEM_STATS *g_charged = NULL;
+
+void ssq_set_allocator(
+    const SSQ_MALLOC_FN malloc_fn,
+    const SSQ_CALLOC_FN calloc_fn,
+    const SSQ_FREE_FN   free_fn,
+    void         *const user_data
+) {
+    if (malloc_fn != NULL && calloc_fn != NULL && free_fn != NULL) {
+        g_malloc_fn = malloc_fn;
+        g_calloc_fn = calloc_fn;
+        g_free_fn   = free_fn;
+        g_user_data = user_data;
+    } else {
+        g_malloc_fn = ssq_mem_libc_malloc;
+        g_calloc_fn = ssq_mem_libc_calloc;
+        g_free_fn   = ssq_mem_libc_free;
+        g_user_data = NULL;
+    }
+}
+
+void ssq_set_accounting(const bool enabled) {
+    g_accounting = enabled;
+}
+
+SSQ_MEM_STATS *ssq_mem_charge(SSQ_MEM_STATS *const stats) {
+    SSQ_MEM_STATS *const previous = g_charged;
+    g_charged = stats;
+    return previous;
+}
+
+/**
+ * Fills the header of an accounted allocation and charges it to the statistics of the calling thread.
+ *
+ * @param block allocated block, starting with its header
+ * @param size  number of bytes allocated past the header
+ *
+ * @return memory past the header
+ */
+static void *ssq_mem_account(void *const block, const size_t size) {
+    SSQ_MEM_HEADER *const header = block;
+
+    header->size  = size;
+    header->stats = g_charged;
+
+    if (header->stats != NULL) {
+        header->stats->current += size;
+        ++(header->stats->allocs);
+
+        if (header->stats->current > header->stats->peak)
+            header->stats->peak = header->stats->current;
+    }
+
+    return (uint8_t *)block + SSQ_MEM_HEADER_SIZE;
+}
+
+void *ssq_mem_alloc(const size_t size) {
+    void *block;
+
+    if (!g_accounting)
+        block = g_malloc_fn(size, g_user_data);
+    else if (size <= SIZE_MAX - SSQ_MEM_HEADER_SIZE)
+        block = g_malloc_fn(SSQ_MEM_HEADER_SIZE + size, g_user_data);
+    else
+        block = NULL;
+
+    if (block == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return g_accounting ? ssq_mem_account(block, size) : block;
+}
+
+void *ssq_mem_calloc(const size_t count, const size_t size) {
+    void *block;
+
+    if (!g_accounting)
+        block = g_calloc_fn(count, size, g_user_data);
+    else if (size == 0 || count <= (SIZE_MAX - SSQ_MEM_HEADER_SIZE) / size)
+        block = g_calloc_fn(1, SSQ_MEM_HEADER_SIZE + count * size, g_user_data);
+    else
+        block = NULL;
+
+    if (block == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return g_accounting ? ssq_mem_account(block, count * size) : block;
+}
+
+void *ssq_mem_realloc(void *const ptr, const size_t old_size, const size_t size) {
+    if (!g_accounting && g_malloc_fn == ssq_mem_libc_malloc) {
+        void *const resized = realloc(ptr, size);
+
+        if (resized == NULL)
+            errno = ENOMEM;
+
+        return resized;
+    }
+
+    void *const resized = ssq_mem_alloc(size);
+
+    if (resized != NULL && ptr != NULL) {
+        memcpy(resized, ptr, (old_size < size) ? old_size : size);
+        ssq_mem_free(ptr);
+    }
+
+    return resized;
+}
+
+void ssq_mem_free(void *const ptr) {
+    if (ptr == NULL)
+        return;
+
+    if (!g_accounting) {
+        g_free_fn(ptr, g_user_data);
+        return;
+    }
+
+    SSQ_MEM_HEADER *const header = (SSQ_MEM_HEADER *)((uint8_t *)ptr - SSQ_MEM_HEADER_SIZE);
+
+    if (header->stats != NULL) {
+        header->stats->current -= header->size;
+        ++(header->stats->frees);
+    }
+
+    g_free_fn(header, g_user_data);
+}
+
+void *ssq_mem_alloc_sized(const size_t size) {
+    if (size > SIZE_MAX - SSQ_MEM_SIZED_HEADER_SIZE) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    uint8_t *const block = ssq_mem_alloc(SSQ_MEM_SIZED_HEADER_SIZE + size);
+
+    if (block == NULL)
+        return NULL;
+
+    memcpy(block, &size, sizeof (size));
+
+    return block + SSQ_MEM_SIZED_HEADER_SIZE;
+}
+
+void *ssq_mem_reuse(void *const ptr, const size_t size) {
+    if (ptr != NULL) {
+        size_t capacity;
+        memcpy(&capacity, (uint8_t *)ptr - SSQ_MEM_SIZED_HEADER_SIZE, sizeof (capacity));
+
+        if (size <= capacity)
+            return ptr;
+    }
+
+    // Like `realloc', the memory is only given up once the larger one is allocated.
+    void *const larger = ssq_mem_alloc_sized(size);
+
+    if (larger != NULL)
+        ssq_mem_free_sized(ptr);
+
+    return larger;
+}
+
+void ssq_mem_free_sized(void *const ptr) {
+    if (ptr != NULL)
+        ssq_mem_free((uint8_t *)ptr - SSQ_MEM_SIZED_HEADER_SIZE);
+}
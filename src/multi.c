@@ -0,0 +1,1328 @@
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "ssq/buf.h"
+#include "ssq/helper.h"
+#include "ssq/mem.h"
+#include "ssq/multi.h"
+#include "ssq/packet.h"
+#include "ssq/resolve.h"
+#include "ssq/resolver.h"
+#include "ssq/response.h"
+#include "ssq/rtt.h"
+
+#define SSQ_MULTI_EVENTS_MAX   64
+#define SSQ_MULTI_PAYLOAD_SIZE A2S_INFO_PAYLOAD_LEN
+
+#define SSQ_MULTI_HEAP_NONE ((size_t)-1)
+
+#define SSQ_MULTI_TABLE_SIZE_MIN 64
+#define SSQ_MULTI_SHARED_RCVBUF  (4 * 1024 * 1024) // bytes
+
+typedef struct ssq_multi_request {
+    SSQ_MULTI_QUERY            query;
+    void                      *user_data;
+    char                      *hostname;
+    uint16_t                   port;
+    time_t                     timeout;          /** Timeout of the query in ms                  */
+    int                        sockfd;
+    int64_t                    deadline;         /** Monotonic time at which the query times out */
+    int64_t                    wake;             /** Next retransmission, or else the deadline   */
+    size_t                     heap_index;       /** Index in the in-flight min-heap             */
+    uint8_t                    payload[SSQ_MULTI_PAYLOAD_SIZE];
+    size_t                     payload_len;
+    int32_t                    chall;            /** Challenge the payload was built with        */
+    uint8_t                    max_challenges;   /** Maximum number of challenges to answer      */
+    uint8_t                    challenges;       /** Number of challenges answered so far        */
+    uint8_t                    max_attempts;     /** Maximum number of times a request is sent   */
+    uint8_t                    attempts;         /** Number of times the request was sent        */
+    int64_t                    sent_at;          /** Monotonic time the request was last sent    */
+    bool                       answered;         /** Whether a reply to the request came         */
+    SSQ_REASSEMBLY            *reassembly;       /** Reassembly of a multi-packet response       */
+    bool                       shared;           /** Whether the query uses the shared socket    */
+    struct addrinfo           *addr_list;        /** Addresses of the target, once resolved      */
+    struct sockaddr_storage    addr;             /** Address of the target                       */
+    socklen_t                  addr_len;         /** Length of the address of the target         */
+    uint64_t                   key;              /** Key in the table of the shared socket       */
+    struct ssq_multi_request  *waiting;          /** Next query waiting for this one to finish   */
+    struct ssq_multi_request  *next;             /** Next query waiting to be sent               */
+} SSQ_MULTI_REQUEST;
+
+typedef struct ssq_multi_entry {
+    uint64_t           key;
+    SSQ_MULTI_REQUEST *request; /** NULL if the entry is free */
+} SSQ_MULTI_ENTRY;
+
+/* Address of a target, zero-padded so that endpoints compare and hash bytewise. */
+typedef struct ssq_multi_endpoint {
+    uint16_t family;
+    uint16_t port;        /** Port in network byte order           */
+    uint8_t  address[16]; /** IPv4 address in its first four bytes */
+} SSQ_MULTI_ENDPOINT;
+
+typedef struct ssq_multi_target {
+    SSQ_MULTI_ENDPOINT endpoint;
+    SSQ_RTT            rtt;      /** Free entry if no round-trip time was measured */
+} SSQ_MULTI_TARGET;
+
+static const uint8_t g_response_headers[] = { S2A_HEADER_INFO, S2A_HEADER_PLAYER, S2A_HEADER_RULES };
+
+SSQ_MULTI *ssq_multi_init(void) {
+    SSQ_MULTI *multi = ssq_mem_alloc(sizeof (*multi));
+
+    if (multi != NULL) {
+        memset(multi, 0, sizeof (*multi));
+
+        multi->epollfd        = epoll_create1(EPOLL_CLOEXEC);
+        multi->sockfd         = -1;
+        multi->timeout        = SSQ_MULTI_TIMEOUT_DEFAULT_VALUE;
+        multi->max_challenges = SSQ_MAX_CHALLENGES_DEFAULT_VALUE;
+        multi->max_attempts   = SSQ_MAX_ATTEMPTS_DEFAULT_VALUE;
+        multi->max_inflight   = SSQ_MULTI_MAX_INFLIGHT_DEFAULT_VALUE;
+        ssq_multi_errclr(multi);
+        ssq_pool_init(&(multi->reassemblies), sizeof (SSQ_REASSEMBLY));
+        ssq_pool_init(&(multi->buffers), SSQ_MULTI_POOL_FRAGMENTS * SSQ_PACKET_SIZE);
+
+        if (multi->epollfd != -1)
+            ssq_batch_init(&(multi->batch), SSQ_BATCH_CAPACITY_DEFAULT_VALUE, &(multi->err));
+
+        if (multi->epollfd == -1 || !ssq_multi_ok(multi)) {
+            if (multi->epollfd != -1)
+                close(multi->epollfd);
+
+            ssq_mem_free(multi);
+            multi = NULL;
+        }
+    }
+
+    return multi;
+}
+
+/**
+ * Frees a query, along with the queries waiting for it to finish.
+ * @param request query to free
+ */
+static void ssq_multi_request_free(SSQ_MULTI_REQUEST *request) {
+    while (request != NULL) {
+        SSQ_MULTI_REQUEST *const waiting = request->waiting;
+
+        if (request->sockfd != -1)
+            close(request->sockfd);
+
+        ssq_resolve_free(request->addr_list);
+        ssq_mem_free(request->hostname);
+        ssq_mem_free(request);
+
+        request = waiting;
+    }
+}
+
+/**
+ * Ends the reassembly of the response to a query in flight, if any, and gives it back to the pools of a
+ * multi-target querier.
+ *
+ * @param multi   multi-target querier
+ * @param request query in flight
+ */
+static void ssq_multi_request_end_reassembly(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    if (request->reassembly != NULL) {
+        ssq_reassembly_free(request->reassembly);
+        ssq_pool_release(&(multi->reassemblies), request->reassembly);
+        request->reassembly = NULL;
+    }
+}
+
+static void ssq_multi_request_drop(void *const request) {
+    ssq_multi_request_free(request);
+}
+
+void ssq_multi_free(SSQ_MULTI *const multi) {
+    // Joins the worker threads of the resolver first, which hold the queries being resolved.
+    if (multi->resolver != NULL)
+        ssq_resolver_free(multi->resolver, ssq_multi_request_drop);
+
+    for (size_t i = 0; i < multi->inflight_count; ++i) {
+        ssq_multi_request_end_reassembly(multi, multi->inflight[i]);
+        ssq_multi_request_free(multi->inflight[i]);
+    }
+
+    while (multi->queue_head != NULL) {
+        SSQ_MULTI_REQUEST *const next = multi->queue_head->next;
+        ssq_multi_request_free(multi->queue_head);
+        multi->queue_head = next;
+    }
+
+    if (multi->sockfd != -1)
+        close(multi->sockfd);
+
+    close(multi->epollfd);
+    ssq_batch_free(&(multi->batch));
+    ssq_batch_free(&(multi->send_batch));
+    ssq_mem_free(multi->table);
+    ssq_mem_free(multi->targets);
+    ssq_mem_free(multi->inflight);
+    ssq_pool_free(&(multi->reassemblies));
+    ssq_pool_free(&(multi->buffers));
+    ssq_mem_free(multi);
+}
+
+void ssq_multi_set_callback(SSQ_MULTI *const multi, const SSQ_MULTI_CALLBACK callback) {
+    multi->callback = callback;
+}
+
+void ssq_multi_set_timeout(SSQ_MULTI *const multi, const time_t value_in_ms) {
+    multi->timeout = value_in_ms;
+}
+
+void ssq_multi_set_max_challenges(SSQ_MULTI *const multi, const uint8_t max_challenges) {
+    multi->max_challenges = max_challenges;
+}
+
+void ssq_multi_set_max_attempts(SSQ_MULTI *const multi, const uint8_t max_attempts) {
+    multi->max_attempts = (max_attempts != 0) ? max_attempts : 1;
+}
+
+void ssq_multi_set_max_inflight(SSQ_MULTI *const multi, const size_t max_inflight) {
+    // Without any query in flight, the queued ones would never start.
+    multi->max_inflight = (max_inflight != 0) ? max_inflight : 1;
+}
+
+void ssq_multi_set_shared_socket(SSQ_MULTI *const multi, const bool shared) {
+    multi->shared = shared;
+}
+
+void ssq_multi_set_mem_stats(SSQ_MULTI *const multi, SSQ_MEM_STATS *const stats) {
+    multi->mem = stats;
+}
+
+void ssq_multi_add(
+    SSQ_MULTI      *const multi,
+    const char            hostname[],
+    const uint16_t        port,
+    const SSQ_MULTI_QUERY query,
+    void           *const user_data
+) {
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(multi->mem);
+
+    SSQ_MULTI_REQUEST *const request = ssq_mem_alloc(sizeof (*request));
+
+    if (request == NULL) {
+        ssq_error_set_from_errno(&(multi->err));
+        ssq_mem_charge(charged);
+        return;
+    }
+
+    memset(request, 0, sizeof (*request));
+
+    const size_t hostname_size = strlen(hostname) + 1;
+    request->hostname = ssq_mem_alloc(hostname_size);
+
+    if (request->hostname == NULL) {
+        ssq_error_set_from_errno(&(multi->err));
+        ssq_mem_free(request);
+        ssq_mem_charge(charged);
+        return;
+    }
+
+    memcpy(request->hostname, hostname, hostname_size);
+
+    request->query          = query;
+    request->user_data      = user_data;
+    request->port           = port;
+    request->timeout        = multi->timeout;
+    request->max_challenges = multi->max_challenges;
+    request->max_attempts   = multi->max_attempts;
+    request->sockfd         = -1;
+    request->heap_index     = SSQ_MULTI_HEAP_NONE;
+    request->shared         = multi->shared;
+
+    if (multi->queue_tail != NULL)
+        multi->queue_tail->next = request;
+    else
+        multi->queue_head = request;
+
+    multi->queue_tail = request;
+    ++(multi->queue_len);
+
+    ssq_mem_charge(charged);
+}
+
+static inline bool ssq_multi_heap_less(const SSQ_MULTI *const multi, const size_t i, const size_t j) {
+    return multi->inflight[i]->wake < multi->inflight[j]->wake;
+}
+
+static void ssq_multi_heap_swap(SSQ_MULTI *const multi, const size_t i, const size_t j) {
+    SSQ_MULTI_REQUEST *const tmp = multi->inflight[i];
+
+    multi->inflight[i] = multi->inflight[j];
+    multi->inflight[j] = tmp;
+
+    multi->inflight[i]->heap_index = i;
+    multi->inflight[j]->heap_index = j;
+}
+
+static void ssq_multi_heap_sift_up(SSQ_MULTI *const multi, size_t i) {
+    while (i > 0 && ssq_multi_heap_less(multi, i, (i - 1) / 2)) {
+        ssq_multi_heap_swap(multi, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void ssq_multi_heap_sift_down(SSQ_MULTI *const multi, size_t i) {
+    for (;;) {
+        const size_t left  = 2 * i + 1;
+        const size_t right = left + 1;
+        size_t       min   = i;
+
+        if (left < multi->inflight_count && ssq_multi_heap_less(multi, left, min))
+            min = left;
+        if (right < multi->inflight_count && ssq_multi_heap_less(multi, right, min))
+            min = right;
+
+        if (min == i)
+            break;
+
+        ssq_multi_heap_swap(multi, i, min);
+        i = min;
+    }
+}
+
+static bool ssq_multi_heap_push(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    if (multi->inflight_count == multi->inflight_size) {
+        const size_t              size     = (multi->inflight_size != 0) ? (multi->inflight_size * 2) : 64;
+        SSQ_MULTI_REQUEST **const inflight = ssq_mem_realloc(multi->inflight, multi->inflight_size * sizeof (*inflight), size * sizeof (*inflight));
+
+        if (inflight == NULL)
+            return false;
+
+        multi->inflight      = inflight;
+        multi->inflight_size = size;
+    }
+
+    request->heap_index = multi->inflight_count;
+    multi->inflight[multi->inflight_count++] = request;
+    ssq_multi_heap_sift_up(multi, request->heap_index);
+
+    return true;
+}
+
+static void ssq_multi_heap_remove(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    const size_t i = request->heap_index;
+
+    --(multi->inflight_count);
+
+    if (i != multi->inflight_count) {
+        ssq_multi_heap_swap(multi, i, multi->inflight_count);
+        ssq_multi_heap_sift_down(multi, i);
+        ssq_multi_heap_sift_up(multi, i);
+    }
+
+    request->heap_index = SSQ_MULTI_HEAP_NONE;
+}
+
+static void ssq_multi_heap_update(SSQ_MULTI *const multi, const SSQ_MULTI_REQUEST *const request) {
+    ssq_multi_heap_sift_down(multi, request->heap_index);
+    ssq_multi_heap_sift_up(multi, request->heap_index);
+}
+
+/**
+ * Computes the key of a query on the shared socket from its target and the header of the response it expects.
+ *
+ * @param addr   target address
+ * @param header header of the expected response
+ *
+ * @return key of the query
+ */
+static inline uint64_t ssq_multi_key(const struct sockaddr_in *const addr, const uint8_t header) {
+    return ((uint64_t)ntohl(addr->sin_addr.s_addr) << 24) | ((uint64_t)ntohs(addr->sin_port) << 8) | header;
+}
+
+static inline size_t ssq_multi_hash(const uint64_t key, const size_t size) {
+    return (size_t)((key * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (size - 1);
+}
+
+static inline size_t ssq_multi_table_index(const SSQ_MULTI *const multi, const uint64_t key) {
+    return ssq_multi_hash(key, multi->table_size);
+}
+
+static SSQ_MULTI_REQUEST *ssq_multi_table_find(const SSQ_MULTI *const multi, const uint64_t key) {
+    if (multi->table_count == 0)
+        return NULL;
+
+    const size_t mask = multi->table_size - 1;
+
+    for (size_t i = ssq_multi_table_index(multi, key);; i = (i + 1) & mask) {
+        const SSQ_MULTI_ENTRY *const entry = &(multi->table[i]);
+
+        if (entry->request == NULL)
+            return NULL;
+        if (entry->key == key)
+            return entry->request;
+    }
+}
+
+static void ssq_multi_table_put(SSQ_MULTI *const multi, const uint64_t key, SSQ_MULTI_REQUEST *const request) {
+    const size_t mask = multi->table_size - 1;
+
+    size_t i = ssq_multi_table_index(multi, key);
+
+    while (multi->table[i].request != NULL)
+        i = (i + 1) & mask;
+
+    multi->table[i].key     = key;
+    multi->table[i].request = request;
+    ++(multi->table_count);
+}
+
+static bool ssq_multi_table_insert(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    // Keeps the table at most half full so that probe sequences stay short.
+    if ((multi->table_count + 1) * 2 > multi->table_size) {
+        const size_t           size  = (multi->table_size != 0) ? (multi->table_size * 2) : SSQ_MULTI_TABLE_SIZE_MIN;
+        SSQ_MULTI_ENTRY *const table = ssq_mem_calloc(size, sizeof (*table));
+
+        if (table == NULL)
+            return false;
+
+        SSQ_MULTI_ENTRY *const old_table = multi->table;
+        const size_t           old_size  = multi->table_size;
+
+        multi->table       = table;
+        multi->table_size  = size;
+        multi->table_count = 0;
+
+        for (size_t i = 0; i < old_size; ++i) {
+            if (old_table[i].request != NULL)
+                ssq_multi_table_put(multi, old_table[i].key, old_table[i].request);
+        }
+
+        ssq_mem_free(old_table);
+    }
+
+    ssq_multi_table_put(multi, request->key, request);
+
+    return true;
+}
+
+static void ssq_multi_table_remove(SSQ_MULTI *const multi, const SSQ_MULTI_REQUEST *const request) {
+    const size_t mask = multi->table_size - 1;
+
+    size_t i = ssq_multi_table_index(multi, request->key);
+
+    while (multi->table[i].request != request)
+        i = (i + 1) & mask;
+
+    // Shifts back the entries of the probe sequence which can fill the hole, instead of leaving a tombstone.
+    for (size_t j = (i + 1) & mask; multi->table[j].request != NULL; j = (j + 1) & mask) {
+        const size_t home = ssq_multi_table_index(multi, multi->table[j].key);
+
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            multi->table[i] = multi->table[j];
+            i = j;
+        }
+    }
+
+    multi->table[i].request = NULL;
+    --(multi->table_count);
+}
+
+/**
+ * Computes the endpoint of a target from its address, whatever its family.
+ *
+ * @param addr     target address
+ * @param endpoint where to store the endpoint of the target
+ */
+static void ssq_multi_endpoint_init(const struct sockaddr_storage *const addr, SSQ_MULTI_ENDPOINT *const endpoint) {
+    memset(endpoint, 0, sizeof (*endpoint));
+    endpoint->family = addr->ss_family;
+
+    if (addr->ss_family == AF_INET) {
+        const struct sockaddr_in *const in = (const struct sockaddr_in *)addr;
+        endpoint->port = in->sin_port;
+        memcpy(endpoint->address, &(in->sin_addr), sizeof (in->sin_addr));
+    } else if (addr->ss_family == AF_INET6) {
+        const struct sockaddr_in6 *const in6 = (const struct sockaddr_in6 *)addr;
+        endpoint->port = in6->sin6_port;
+        memcpy(endpoint->address, &(in6->sin6_addr), sizeof (in6->sin6_addr));
+    }
+}
+
+static inline size_t ssq_multi_endpoint_hash(const SSQ_MULTI_ENDPOINT *const endpoint, const size_t size) {
+    uint64_t high;
+    uint64_t low;
+    memcpy(&high, endpoint->address, sizeof (high));
+    memcpy(&low, endpoint->address + sizeof (high), sizeof (low));
+
+    const uint64_t key = (high * UINT64_C(0xC2B2AE3D27D4EB4F)) ^ low ^ ((uint64_t)endpoint->family << 16) ^ endpoint->port;
+
+    return ssq_multi_hash(key, size);
+}
+
+static SSQ_RTT *ssq_multi_target_find(const SSQ_MULTI *const multi, const SSQ_MULTI_ENDPOINT *const endpoint) {
+    if (multi->targets_count == 0)
+        return NULL;
+
+    const size_t mask = multi->targets_size - 1;
+
+    for (size_t i = ssq_multi_endpoint_hash(endpoint, multi->targets_size);; i = (i + 1) & mask) {
+        SSQ_MULTI_TARGET *const target = &(multi->targets[i]);
+
+        if (!target->rtt.measured)
+            return NULL;
+        if (memcmp(&(target->endpoint), endpoint, sizeof (*endpoint)) == 0)
+            return &(target->rtt);
+    }
+}
+
+/**
+ * Gets the round-trip time estimate of a target, and adds a blank one if it has none yet.
+ *
+ * @param multi    multi-target querier
+ * @param endpoint endpoint of the target
+ *
+ * @return round-trip time estimate of the target, or NULL in case of a memory allocation failure
+ */
+static SSQ_RTT *ssq_multi_target_get(SSQ_MULTI *const multi, const SSQ_MULTI_ENDPOINT *const endpoint) {
+    SSQ_RTT *const rtt = ssq_multi_target_find(multi, endpoint);
+
+    if (rtt != NULL)
+        return rtt;
+
+    if ((multi->targets_count + 1) * 2 > multi->targets_size) {
+        const size_t            size    = (multi->targets_size != 0) ? (multi->targets_size * 2) : SSQ_MULTI_TABLE_SIZE_MIN;
+        SSQ_MULTI_TARGET *const targets = ssq_mem_calloc(size, sizeof (*targets));
+
+        if (targets == NULL)
+            return NULL;
+
+        for (size_t i = 0; i < multi->targets_size; ++i) {
+            if (!multi->targets[i].rtt.measured)
+                continue;
+
+            size_t j = ssq_multi_endpoint_hash(&(multi->targets[i].endpoint), size);
+
+            while (targets[j].rtt.measured)
+                j = (j + 1) & (size - 1);
+
+            targets[j] = multi->targets[i];
+        }
+
+        ssq_mem_free(multi->targets);
+        multi->targets      = targets;
+        multi->targets_size = size;
+    }
+
+    size_t i = ssq_multi_endpoint_hash(endpoint, multi->targets_size);
+
+    while (multi->targets[i].rtt.measured)
+        i = (i + 1) & (multi->targets_size - 1);
+
+    ++(multi->targets_count);
+    multi->targets[i].endpoint = *endpoint;
+    ssq_rtt_init(&(multi->targets[i].rtt));
+
+    return &(multi->targets[i].rtt);
+}
+
+/**
+ * Schedules the next wake-up of a query: the retransmission of its request if the latter
+ * is not answered yet and may be sent again, or else its deadline.
+ *
+ * @param multi   multi-target querier
+ * @param request query
+ */
+static void ssq_multi_request_schedule(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    request->wake = request->deadline;
+
+    if (!request->answered && request->attempts < request->max_attempts) {
+        SSQ_MULTI_ENDPOINT endpoint;
+        ssq_multi_endpoint_init(&(request->addr), &endpoint);
+
+        const SSQ_RTT *rtt = ssq_multi_target_find(multi, &endpoint);
+
+        SSQ_RTT none;
+        if (rtt == NULL) {
+            ssq_rtt_init(&none);
+            rtt = &none;
+        }
+
+        const int64_t retransmit_at = request->sent_at + ssq_rtt_rto(rtt, request->attempts - 1);
+
+        if (retransmit_at < request->wake)
+            request->wake = retransmit_at;
+    }
+
+    if (request->heap_index != SSQ_MULTI_HEAP_NONE)
+        ssq_multi_heap_update(multi, request);
+}
+
+/**
+ * Handles the first reply to the request of a query: stops its retransmission and, following Karn's
+ * algorithm, measures the round-trip time to the target if the request was sent only once.
+ *
+ * @param multi   multi-target querier
+ * @param request query
+ */
+static void ssq_multi_request_on_answer(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    request->answered = true;
+
+    if (request->max_attempts > 1 && request->attempts == 1) {
+        SSQ_MULTI_ENDPOINT endpoint;
+        ssq_multi_endpoint_init(&(request->addr), &endpoint);
+
+        SSQ_RTT *const rtt = ssq_multi_target_get(multi, &endpoint);
+
+        // The estimate is only a hint, so it is not worth failing the query for.
+        if (rtt != NULL)
+            ssq_rtt_sample(rtt, ssq_helper_now_ms() - request->sent_at);
+    }
+
+    ssq_multi_request_schedule(multi, request);
+}
+
+static void ssq_multi_request_start(SSQ_MULTI *multi, SSQ_MULTI_REQUEST *request);
+
+/**
+ * Reports a finished query to the callback of a multi-target querier and frees it.
+ *
+ * @param multi   multi-target querier
+ * @param request finished query
+ * @param result  result of the query
+ */
+static void ssq_multi_request_finish(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request, SSQ_MULTI_RESULT *const result) {
+    if (request->heap_index != SSQ_MULTI_HEAP_NONE)
+        ssq_multi_heap_remove(multi, request);
+
+    if (request->shared && ssq_multi_table_find(multi, request->key) == request)
+        ssq_multi_table_remove(multi, request);
+
+    SSQ_MULTI_REQUEST *const waiting = request->waiting;
+    request->waiting = NULL;
+
+    result->query     = request->query;
+    result->user_data = request->user_data;
+
+    ssq_multi_request_end_reassembly(multi, request);
+    ssq_multi_request_free(request);
+
+    if (multi->callback != NULL) {
+        multi->callback(result);
+    } else {
+        if (result->info != NULL)
+            ssq_info_free(result->info);
+        if (result->players != NULL)
+            ssq_player_free(result->players, result->player_count);
+        if (result->rules != NULL)
+            ssq_rules_free(result->rules, result->rule_count);
+    }
+
+    if (waiting != NULL) {
+        --(multi->waiting_count);
+        ssq_multi_request_start(multi, waiting);
+    }
+}
+
+static void ssq_multi_request_fail(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request, const SSQ_ERROR *const err) {
+    SSQ_MULTI_RESULT result;
+    memset(&result, 0, sizeof (result));
+    result.err = *err;
+
+    ssq_multi_request_finish(multi, request, &result);
+}
+
+static void ssq_multi_request_fail_from_errno(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    SSQ_ERROR err;
+    ssq_error_set_from_errno(&err);
+
+    ssq_multi_request_fail(multi, request, &err);
+}
+
+static void ssq_multi_request_set_payload(SSQ_MULTI_REQUEST *const request, const int32_t chall) {
+    request->chall    = chall;
+    request->attempts = 0;
+    request->answered = false;
+
+    switch (request->query) {
+        case SSQ_MULTI_INFO:   request->payload_len = ssq_info_payload(request->payload, chall);   break;
+        case SSQ_MULTI_PLAYER: request->payload_len = ssq_player_payload(request->payload, chall); break;
+        case SSQ_MULTI_RULES:  request->payload_len = ssq_rules_payload(request->payload, chall);  break;
+    }
+}
+
+/**
+ * Sends the datagrams queued for the shared socket of a multi-target querier.
+ * @param multi multi-target querier
+ */
+static void ssq_multi_flush(SSQ_MULTI *const multi) {
+    if (multi->send_batch.count == 0)
+        return;
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    // The datagrams the kernel refuses are dropped like lost ones, and their query times out.
+    ssq_batch_send(&(multi->send_batch), multi->sockfd, &err);
+}
+
+/**
+ * Sends the payload of a query, or queues it to be sent in a batch if the query uses the shared socket,
+ * and counts the attempt.
+ *
+ * @param multi   multi-target querier
+ * @param request query
+ *
+ * @return true if the payload was sent or queued
+ */
+static bool ssq_multi_request_send(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    bool sent;
+
+    if (!request->shared) {
+        sent = (send(request->sockfd, request->payload, request->payload_len, 0) != -1);
+    } else {
+        if (multi->send_batch.count == multi->send_batch.capacity)
+            ssq_multi_flush(multi);
+
+        sent = ssq_batch_push(
+            &(multi->send_batch),
+            request->payload,
+            request->payload_len,
+            (const struct sockaddr *)&(request->addr),
+            request->addr_len
+        );
+    }
+
+    if (sent) {
+        ++(request->attempts);
+        request->sent_at = ssq_helper_now_ms();
+    }
+
+    return sent;
+}
+
+/**
+ * Creates the asynchronous resolver of a multi-target querier and registers it to the epoll instance.
+ *
+ * @param multi multi-target querier
+ * @param err   where to report potential errors
+ */
+static void ssq_multi_init_resolver(SSQ_MULTI *const multi, SSQ_ERROR *const err) {
+    multi->resolver = ssq_resolver_init(SSQ_RESOLVER_THREADS_DEFAULT_VALUE, err);
+    if (err->code != SSQ_OK) return;
+
+    struct epoll_event event;
+    event.events   = EPOLLIN;
+    event.data.ptr = multi->resolver;
+
+    if (epoll_ctl(multi->epollfd, EPOLL_CTL_ADD, ssq_resolver_fd(multi->resolver), &event) == -1) {
+        ssq_error_set_from_errno(err);
+        ssq_resolver_free(multi->resolver, NULL);
+        multi->resolver = NULL;
+    }
+}
+
+/**
+ * Resolves the target of a query without blocking. Numeric hosts and hostnames in the resolution cache
+ * are resolved at once, while the other hostnames are handed to the asynchronous resolver of the
+ * multi-target querier, and the query is started again once its target is resolved.
+ *
+ * @param multi   multi-target querier
+ * @param request query
+ * @param err     where to report potential errors
+ *
+ * @return true if the addresses of the target are known
+ */
+static bool ssq_multi_request_resolve(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request, SSQ_ERROR *const err) {
+    if (request->addr_list != NULL)
+        return true;
+
+    if (ssq_resolve_cached(request->hostname, request->port, &(request->addr_list), err))
+        return err->code == SSQ_OK;
+
+    if (multi->resolver == NULL) {
+        ssq_multi_init_resolver(multi, err);
+        if (err->code != SSQ_OK) return false;
+    }
+
+    ssq_resolver_submit(multi->resolver, request->hostname, request->port, request, err);
+
+    if (err->code == SSQ_OK)
+        ++(multi->lookup_count);
+
+    return false;
+}
+
+/**
+ * Creates the non-blocking socket of a query, connects it to the query's target
+ * and registers it to the epoll instance of a multi-target querier.
+ *
+ * @param multi   multi-target querier
+ * @param request query
+ * @param err     where to report potential errors
+ */
+static void ssq_multi_request_init_socket(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request, SSQ_ERROR *const err) {
+    for (struct addrinfo *addr = request->addr_list; addr != NULL; addr = addr->ai_next) {
+        request->sockfd = socket(addr->ai_family, addr->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, addr->ai_protocol);
+
+        if (request->sockfd == -1) {
+            continue;
+        } else if (connect(request->sockfd, addr->ai_addr, addr->ai_addrlen) != -1) {
+            // Keeps the address of the target, its round-trip time estimate being keyed by it.
+            if (addr->ai_addrlen <= sizeof (request->addr)) {
+                memcpy(&(request->addr), addr->ai_addr, addr->ai_addrlen);
+                request->addr_len = addr->ai_addrlen;
+            }
+
+            break;
+        } else {
+            close(request->sockfd);
+            request->sockfd = -1;
+        }
+    }
+
+    if (request->sockfd == -1) {
+        ssq_error_set(err, SSQ_ERR_NOENDPOINT, "No endpoints available to communicate with the target server");
+        return;
+    }
+
+    struct epoll_event event;
+    event.events   = EPOLLIN;
+    event.data.ptr = request;
+
+    if (epoll_ctl(multi->epollfd, EPOLL_CTL_ADD, request->sockfd, &event) == -1)
+        ssq_error_set_from_errno(err);
+}
+
+/**
+ * Creates the shared unconnected socket of a multi-target querier, along with the batch
+ * the datagrams are sent in, and registers it to the epoll instance.
+ *
+ * @param multi multi-target querier
+ * @param err   where to report potential errors
+ */
+static void ssq_multi_init_shared_socket(SSQ_MULTI *const multi, SSQ_ERROR *const err) {
+    ssq_batch_init(&(multi->send_batch), SSQ_BATCH_CAPACITY_DEFAULT_VALUE, err);
+    if (err->code != SSQ_OK) return;
+
+    multi->sockfd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (multi->sockfd == -1) {
+        ssq_error_set_from_errno(err);
+        ssq_batch_free(&(multi->send_batch));
+        return;
+    }
+
+    // The replies to thousands of queries may arrive at once.
+    const int rcvbuf = SSQ_MULTI_SHARED_RCVBUF;
+    setsockopt(multi->sockfd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof (rcvbuf));
+
+    struct epoll_event event;
+    event.events   = EPOLLIN;
+    event.data.ptr = NULL;
+
+    if (epoll_ctl(multi->epollfd, EPOLL_CTL_ADD, multi->sockfd, &event) == -1) {
+        ssq_error_set_from_errno(err);
+        ssq_batch_free(&(multi->send_batch));
+        close(multi->sockfd);
+        multi->sockfd = -1;
+    }
+}
+
+static inline uint8_t ssq_multi_response_header(const SSQ_MULTI_QUERY query) {
+    return g_response_headers[query];
+}
+
+/**
+ * Keys a query which uses the shared socket of a multi-target querier by the address of its target,
+ * and creates the shared socket if needed.
+ *
+ * @param multi   multi-target querier
+ * @param request query whose target is resolved
+ * @param err     where to report potential errors
+ */
+static void ssq_multi_request_init_shared(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request, SSQ_ERROR *const err) {
+    const struct addrinfo *addr = request->addr_list;
+
+    // The shared socket being an IPv4 one, the target is reached at its first IPv4 address.
+    while (addr != NULL && (addr->ai_family != AF_INET || addr->ai_addrlen != sizeof (struct sockaddr_in)))
+        addr = addr->ai_next;
+
+    if (addr == NULL) {
+        ssq_error_set(err, SSQ_ERR_NOENDPOINT, "No endpoints available to communicate with the target server");
+    } else {
+        memcpy(&(request->addr), addr->ai_addr, sizeof (struct sockaddr_in));
+        request->addr_len = sizeof (struct sockaddr_in);
+        request->key      = ssq_multi_key((const struct sockaddr_in *)&(request->addr), ssq_multi_response_header(request->query));
+    }
+
+    if (err->code == SSQ_OK && multi->sockfd == -1)
+        ssq_multi_init_shared_socket(multi, err);
+}
+
+/**
+ * Sends a queued query of a multi-target querier and puts it in flight. A query on the shared socket
+ * waits instead if another query of the same type to the same target is in flight.
+ *
+ * @param multi   multi-target querier
+ * @param request query to send
+ */
+static void ssq_multi_request_start(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    if (!ssq_multi_request_resolve(multi, request, &err)) {
+        // Either the resolution failed, or the query waits for the resolver.
+        if (err.code != SSQ_OK)
+            ssq_multi_request_fail(multi, request, &err);
+
+        return;
+    }
+
+    if (!request->shared)
+        ssq_multi_request_init_socket(multi, request, &err);
+    else if (request->key == 0) // not resolved yet, as opposed to a query which waited for another one
+        ssq_multi_request_init_shared(multi, request, &err);
+
+    if (err.code != SSQ_OK) {
+        ssq_multi_request_fail(multi, request, &err);
+        return;
+    }
+
+    if (request->shared) {
+        SSQ_MULTI_REQUEST *holder = ssq_multi_table_find(multi, request->key);
+
+        if (holder != NULL) {
+            while (holder->waiting != NULL)
+                holder = holder->waiting;
+
+            holder->waiting = request;
+            ++(multi->waiting_count);
+            return;
+        }
+
+        if (!ssq_multi_table_insert(multi, request)) {
+            ssq_multi_request_fail_from_errno(multi, request);
+            return;
+        }
+    }
+
+    ssq_multi_request_set_payload(request, A2S_CHALLENGE_NONE);
+
+    if (!ssq_multi_request_send(multi, request)) {
+        ssq_multi_request_fail_from_errno(multi, request);
+        return;
+    }
+
+    request->deadline = request->sent_at + request->timeout;
+    ssq_multi_request_schedule(multi, request);
+
+    if (!ssq_multi_heap_push(multi, request))
+        ssq_multi_request_fail_from_errno(multi, request);
+}
+
+/**
+ * Handles the complete response of a query in flight: either answers a challenge,
+ * or deserializes the response and finishes the query.
+ *
+ * @param multi        multi-target querier
+ * @param request      query in flight
+ * @param response     response buffer
+ * @param response_len length of the response
+ *
+ * @return true if the query finished
+ */
+static bool ssq_multi_request_on_response(
+    SSQ_MULTI         *const multi,
+    SSQ_MULTI_REQUEST *const request,
+    const uint8_t            response[],
+    const size_t             response_len
+) {
+    if (ssq_response_has_challenge(response, response_len)) {
+        if (request->challenges++ == request->max_challenges) {
+            SSQ_ERROR err;
+            ssq_error_set(&err, SSQ_ERR_BADRES, "Too many challenges");
+
+            ssq_multi_request_fail(multi, request, &err);
+            return true;
+        }
+
+        ssq_multi_request_set_payload(request, ssq_response_get_challenge(response, response_len));
+
+        if (ssq_multi_request_send(multi, request)) {
+            ssq_multi_request_schedule(multi, request);
+            return false;
+        }
+
+        ssq_multi_request_fail_from_errno(multi, request);
+        return true;
+    }
+
+    SSQ_MULTI_RESULT result;
+    memset(&result, 0, sizeof (result));
+    ssq_error_clear(&(result.err));
+
+    switch (request->query) {
+        case SSQ_MULTI_INFO:
+            result.info = ssq_info_deserialize(response, response_len, &(result.err));
+            break;
+        case SSQ_MULTI_PLAYER:
+            result.players = ssq_player_deserialize(response, response_len, &(result.player_count), &(result.err));
+            break;
+        case SSQ_MULTI_RULES:
+            result.rules = ssq_rules_deserialize(response, response_len, &(result.rule_count), &(result.err));
+            break;
+    }
+
+    ssq_multi_request_finish(multi, request, &result);
+
+    return true;
+}
+
+/**
+ * Handles a datagram received by a query in flight.
+ *
+ * @param multi        multi-target querier
+ * @param request      query in flight
+ * @param datagram     datagram received
+ * @param datagram_len length of the datagram
+ *
+ * @return true if the query finished
+ */
+static bool ssq_multi_request_on_datagram(
+    SSQ_MULTI         *const multi,
+    SSQ_MULTI_REQUEST *const request,
+    const uint8_t            datagram[],
+    const uint16_t           datagram_len
+) {
+    if (!request->answered)
+        ssq_multi_request_on_answer(multi, request);
+
+    if (request->reassembly == NULL && ssq_response_is_truncated(datagram, datagram_len))
+        return ssq_multi_request_on_response(multi, request, datagram, datagram_len);
+
+    if (request->reassembly == NULL) {
+        request->reassembly = ssq_pool_alloc(&(multi->reassemblies));
+
+        if (request->reassembly == NULL) {
+            ssq_multi_request_fail_from_errno(multi, request);
+            return true;
+        }
+
+        ssq_reassembly_init_pooled(request->reassembly, &(multi->buffers));
+    }
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    const bool complete = ssq_reassembly_add(request->reassembly, datagram, datagram_len, &err);
+
+    if (err.code != SSQ_OK) {
+        ssq_multi_request_fail(multi, request, &err);
+        return true;
+    }
+
+    if (!complete)
+        return false;
+
+    // The reassembly is detached from the query, which may be freed once its response is handled.
+    SSQ_REASSEMBLY *const reassembly = request->reassembly;
+    request->reassembly = NULL;
+
+    size_t         response_len;
+    uint8_t *const response = ssq_reassembly_release(reassembly, &response_len, &err);
+
+    bool finished = true;
+
+    if (err.code != SSQ_OK)
+        ssq_multi_request_fail(multi, request, &err);
+    else
+        finished = ssq_multi_request_on_response(multi, request, response, response_len);
+
+    ssq_reassembly_free_response(reassembly, response);
+    ssq_pool_release(&(multi->reassemblies), reassembly);
+
+    return finished;
+}
+
+/**
+ * Reads the datagrams queued on the socket of a query in flight, as many at once as the batch of
+ * the multi-target querier holds. They are handled in place from the slots of the batch.
+ *
+ * @param multi   multi-target querier
+ * @param request query in flight
+ */
+static void ssq_multi_request_on_readable(SSQ_MULTI *const multi, SSQ_MULTI_REQUEST *const request) {
+    SSQ_BATCH *const batch = &(multi->batch);
+
+    for (;;) {
+        SSQ_ERROR err;
+        ssq_error_clear(&err);
+
+        const size_t datagram_count = ssq_batch_recv(batch, request->sockfd, &err);
+
+        if (err.code != SSQ_OK) {
+            ssq_multi_request_fail(multi, request, &err);
+            return;
+        }
+
+        for (size_t i = 0; i < datagram_count; ++i) {
+            if (ssq_multi_request_on_datagram(multi, request, batch->slots[i], batch->lens[i]))
+                return;
+        }
+
+        // A partial batch means the socket was drained.
+        if (datagram_count < batch->capacity)
+            return;
+    }
+}
+
+/**
+ * Finds the query in flight on the shared socket of a multi-target querier which a datagram answers.
+ * A fragment which is not the first one of a multi-packet response is matched by its response ID, or
+ * else given to the only query to its source which is not reassembling another response yet.
+ *
+ * @param multi        multi-target querier
+ * @param source       source address of the datagram
+ * @param datagram     datagram received
+ * @param datagram_len length of the datagram
+ *
+ * @return query the datagram answers, or NULL if it matches none
+ */
+static SSQ_MULTI_REQUEST *ssq_multi_demux(
+    const SSQ_MULTI               *const multi,
+    const struct sockaddr_storage *const source,
+    const uint8_t                        datagram[],
+    const uint16_t                       datagram_len
+) {
+    if (source->ss_family != AF_INET)
+        return NULL;
+
+    const uint64_t base = ssq_multi_key((const struct sockaddr_in *)source, 0);
+
+    SSQ_MULTI_REQUEST *candidates[sizeof (g_response_headers)];
+
+    for (size_t i = 0; i < sizeof (g_response_headers); ++i)
+        candidates[i] = ssq_multi_table_find(multi, base | g_response_headers[i]);
+
+    SSQ_BUF datagram_buf = ssq_buf_init(datagram, datagram_len);
+
+    const int32_t header = ssq_buf_get_int32(&datagram_buf);
+
+    if (header == (int32_t)A2S_PACKET_HEADER_SINGLE) {
+        const uint8_t response_header = ssq_buf_get_uint8(&datagram_buf);
+
+        if (response_header == S2A_HEADER_CHALL) {
+            // The challenge of a server is the same for all of the queries from one address.
+            SSQ_MULTI_REQUEST *any = NULL;
+
+            for (size_t i = 0; i < sizeof (g_response_headers); ++i) {
+                if (candidates[i] != NULL && candidates[i]->chall == A2S_CHALLENGE_NONE)
+                    return candidates[i];
+                if (any == NULL)
+                    any = candidates[i];
+            }
+
+            return any;
+        }
+
+        SSQ_MULTI_REQUEST *const request = ssq_multi_table_find(multi, base | response_header);
+
+        return (request != NULL && request->reassembly == NULL) ? request : NULL;
+    }
+
+    if (header != (int32_t)A2S_PACKET_HEADER_MULTI)
+        return NULL;
+
+    const int32_t id = ssq_buf_get_int32(&datagram_buf);
+    ssq_buf_get_uint8(&datagram_buf); // total
+    const uint8_t number = ssq_buf_get_uint8(&datagram_buf);
+    ssq_buf_get_uint16(&datagram_buf); // size
+
+    SSQ_MULTI_REQUEST *unbound       = NULL;
+    size_t             unbound_count = 0;
+
+    for (size_t i = 0; i < sizeof (g_response_headers); ++i) {
+        if (candidates[i] == NULL)
+            continue;
+
+        if (candidates[i]->reassembly == NULL) {
+            unbound = candidates[i];
+            ++unbound_count;
+        } else if (candidates[i]->reassembly->id == id) {
+            return candidates[i];
+        }
+    }
+
+    // The first packet of an uncompressed response carries the header of the response.
+    if (number == 0 && !(id & A2S_PACKET_FLAG_COMPRESSION) && ssq_buf_get_int32(&datagram_buf) == (int32_t)A2S_PACKET_HEADER_SINGLE) {
+        SSQ_MULTI_REQUEST *const request = ssq_multi_table_find(multi, base | ssq_buf_get_uint8(&datagram_buf));
+
+        return (request != NULL && request->reassembly == NULL) ? request : NULL;
+    }
+
+    return (unbound_count == 1) ? unbound : NULL;
+}
+
+/**
+ * Reads the datagrams queued on the shared socket of a multi-target querier and routes
+ * each of them to the query it answers. The others are counted as strays and dropped.
+ *
+ * @param multi multi-target querier
+ */
+static void ssq_multi_on_shared_readable(SSQ_MULTI *const multi) {
+    SSQ_BATCH *const batch = &(multi->batch);
+
+    for (;;) {
+        const size_t datagram_count = ssq_batch_recv(batch, multi->sockfd, &(multi->err));
+        if (!ssq_multi_ok(multi)) return;
+
+        for (size_t i = 0; i < datagram_count; ++i) {
+            SSQ_MULTI_REQUEST *const request = ssq_multi_demux(multi, &(batch->addrs[i]), batch->slots[i], batch->lens[i]);
+
+            if (request != NULL)
+                ssq_multi_request_on_datagram(multi, request, batch->slots[i], batch->lens[i]);
+            else
+                ++(multi->stray_count);
+        }
+
+        if (datagram_count < batch->capacity)
+            return;
+    }
+}
+
+/**
+ * Starts the queries whose target the asynchronous resolver of a multi-target querier resolved,
+ * or fails them if the resolution failed.
+ *
+ * @param multi multi-target querier
+ */
+static void ssq_multi_on_resolved(SSQ_MULTI *const multi) {
+    SSQ_RESOLVER_RESULT result;
+
+    while (ssq_resolver_poll(multi->resolver, &result)) {
+        SSQ_MULTI_REQUEST *const request = result.user_data;
+        --(multi->lookup_count);
+
+        if (result.err.code != SSQ_OK) {
+            ssq_multi_request_fail(multi, request, &(result.err));
+            continue;
+        }
+
+        request->addr_list = result.addr_list;
+        ssq_multi_request_start(multi, request);
+    }
+}
+
+/**
+ * Finishes the queries in flight whose deadline passed, and sends again the requests
+ * whose retransmission timeout passed.
+ *
+ * @param multi multi-target querier
+ */
+static void ssq_multi_expire(SSQ_MULTI *const multi) {
+    const int64_t now = ssq_helper_now_ms();
+
+    SSQ_ERROR err;
+    ssq_error_set(&err, SSQ_ERR_TIMEOUT, "Query timed out");
+
+    while (multi->inflight_count != 0 && multi->inflight[0]->wake <= now) {
+        SSQ_MULTI_REQUEST *const request = multi->inflight[0];
+
+        if (request->deadline <= now)
+            ssq_multi_request_fail(multi, request, &err);
+        else if (ssq_multi_request_send(multi, request))
+            ssq_multi_request_schedule(multi, request);
+        else
+            ssq_multi_request_fail_from_errno(multi, request);
+    }
+}
+
+/**
+ * Computes how long a multi-target querier may wait for events.
+ *
+ * @param multi      multi-target querier
+ * @param timeout_ms maximum time to wait requested by the caller, or -1
+ *
+ * @return time to wait in milliseconds until the earliest wake-up or the caller's timeout
+ */
+static int ssq_multi_wait_time(const SSQ_MULTI *const multi, const int timeout_ms) {
+    // Only queries being resolved, which have no deadline until they are sent.
+    if (multi->inflight_count == 0)
+        return timeout_ms;
+
+    const int64_t until_wake = multi->inflight[0]->wake - ssq_helper_now_ms();
+
+    int64_t wait = (until_wake > 0) ? until_wake : 0;
+
+    if (timeout_ms >= 0 && timeout_ms < wait)
+        wait = timeout_ms;
+
+    return (int)wait;
+}
+
+size_t ssq_multi_perform(SSQ_MULTI *const multi, const int timeout_ms) {
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(multi->mem);
+
+    while (multi->queue_head != NULL && multi->inflight_count + multi->lookup_count < multi->max_inflight) {
+        SSQ_MULTI_REQUEST *const request = multi->queue_head;
+
+        multi->queue_head = request->next;
+        if (multi->queue_head == NULL)
+            multi->queue_tail = NULL;
+        --(multi->queue_len);
+
+        request->next = NULL;
+        ssq_multi_request_start(multi, request);
+    }
+
+    ssq_multi_flush(multi);
+
+    if (multi->inflight_count != 0 || multi->lookup_count != 0) {
+        struct epoll_event events[SSQ_MULTI_EVENTS_MAX];
+
+        const int event_count = epoll_wait(multi->epollfd, events, SSQ_MULTI_EVENTS_MAX, ssq_multi_wait_time(multi, timeout_ms));
+
+        if (event_count == -1 && errno != EINTR)
+            ssq_error_set_from_errno(&(multi->err));
+
+        for (int i = 0; i < event_count; ++i) {
+            if (events[i].data.ptr == NULL)
+                ssq_multi_on_shared_readable(multi);
+            else if (events[i].data.ptr == multi->resolver)
+                ssq_multi_on_resolved(multi);
+            else
+                ssq_multi_request_on_readable(multi, events[i].data.ptr);
+        }
+
+        ssq_multi_expire(multi);
+        ssq_multi_flush(multi);
+    }
+
+    ssq_mem_charge(charged);
+
+    return multi->queue_len + multi->lookup_count + multi->inflight_count + multi->waiting_count;
+}
+
+void ssq_multi_run(SSQ_MULTI *const multi) {
+    while (ssq_multi_perform(multi, -1) != 0 && ssq_multi_ok(multi))
+        continue;
+}
+
+SSQ_ERROR_CODE ssq_multi_errc(const SSQ_MULTI *const multi) {
+    return multi->err.code;
+}
+
+bool ssq_multi_ok(const SSQ_MULTI *const multi) {
+    return ssq_multi_errc(multi) == SSQ_OK;
+}
+
+const char *ssq_multi_errm(const SSQ_MULTI *const multi) {
+    return multi->err.message;
+}
+
+void ssq_multi_errclr(SSQ_MULTI *const multi) {
+    ssq_error_clear(&(multi->err));
+}
@@ -1,15 +1,22 @@
 #include <stdlib.h>
 #include <string.h>
+#ifdef SSQ_HAVE_BZIP2
+#include <bzlib.h>
+#include "ssq/crc32.h"
+#endif /* SSQ_HAVE_BZIP2 */
 #include "ssq/buf.h"
 #include "ssq/helper.h"
+#include "ssq/mem.h"
 #include "ssq/packet.h"
 
+#define A2S_PACKET_MULTI_FIELDS_SIZE 8 /* id, total, number and size of a multi-packet header */
+
 static void ssq_packet_init_payload(
     SSQ_PACKET *const dst,
     SSQ_BUF    *const src,
     SSQ_ERROR  *const err
 ) {
-    dst->payload = malloc(dst->payload_len);
+    dst->payload = ssq_mem_alloc(dst->payload_len);
 
     if (dst->payload != NULL)
         ssq_buf_get(dst->payload, src, dst->payload_len);
@@ -17,33 +24,35 @@ static void ssq_packet_init_payload(
         ssq_error_set_from_errno(err);
 }
 
-static void ssq_packet_init_single(
+/**
+ * Reads the header of a packet.
+ *
+ * @param dst packet to fill
+ * @param src byte buffer of the datagram, positioned at its start
+ * @param err where to report potential errors
+ */
+static void ssq_packet_init_header(
     SSQ_PACKET *const dst,
     SSQ_BUF    *const src,
     SSQ_ERROR  *const err
 ) {
-    dst->total       = 1;
-    dst->number      = 0;
-    dst->payload_len = src->payload_len - src->cursor;
+    dst->header = ssq_buf_load_int32(ssq_buf_reserve(src, sizeof (dst->header)));
 
-    ssq_packet_init_payload(dst, src, err);
-}
+    if (dst->header == A2S_PACKET_HEADER_SINGLE) {
+        dst->total       = 1;
+        dst->number      = 0;
+        dst->payload_len = ssq_buf_available(src);
+    } else if (dst->header == A2S_PACKET_HEADER_MULTI) {
+        const uint8_t *const fields = ssq_buf_reserve(src, A2S_PACKET_MULTI_FIELDS_SIZE);
 
-static void ssq_packet_init_multi(
-    SSQ_PACKET *const dst,
-    SSQ_BUF    *const src,
-    SSQ_ERROR  *const err
-) {
-    dst->id          = ssq_buf_get_int32(src);
-    dst->total       = ssq_buf_get_uint8(src);
-    dst->number      = ssq_buf_get_uint8(src);
-    dst->size        = ssq_buf_get_uint16(src);
-    dst->payload_len = ssq_helper_minz(dst->size, ssq_buf_available(src));
-
-    if (dst->id & A2S_PACKET_FLAG_COMPRESSION)
-        ssq_error_set(err, SSQ_ERR_UNSUPPORTED, "Compressed responses are not supported");
-    else
-        ssq_packet_init_payload(dst, src, err);
+        dst->id          = ssq_buf_load_int32(fields);
+        dst->total       = ssq_buf_load_uint8(fields + 4);
+        dst->number      = ssq_buf_load_uint8(fields + 5);
+        dst->size        = ssq_buf_load_uint16(fields + 6);
+        dst->payload_len = ssq_helper_minz(dst->size, ssq_buf_available(src));
+    } else {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid packet header");
+    }
 }
 
 SSQ_PACKET *ssq_packet_from_datagram(
@@ -51,25 +60,25 @@ SSQ_PACKET *ssq_packet_from_datagram(
     const uint16_t   datagram_len,
     SSQ_ERROR *const err
 ) {
-    SSQ_PACKET *packet = malloc(sizeof (*packet));
+    SSQ_PACKET *packet = ssq_mem_alloc(sizeof (*packet));
 
     if (packet != NULL) {
         memset(packet, 0, sizeof (*packet));
 
         SSQ_BUF datagram_buf = ssq_buf_init(datagram, datagram_len);
 
-        packet->header = ssq_buf_get_int32(&datagram_buf);
+        ssq_packet_init_header(packet, &datagram_buf, err);
+
+        // Packets are concatenated as they are by `ssq_packets_to_response', which leaves no room for decompression.
+        if (err->code == SSQ_OK && (packet->id & A2S_PACKET_FLAG_COMPRESSION))
+            ssq_error_set(err, SSQ_ERR_UNSUPPORTED, "Compressed responses are not supported");
 
-        if (packet->header == A2S_PACKET_HEADER_SINGLE)
-            ssq_packet_init_single(packet, &datagram_buf, err);
-        else if (packet->header == A2S_PACKET_HEADER_MULTI)
-            ssq_packet_init_multi(packet, &datagram_buf, err);
-        else
-            ssq_error_set(err, SSQ_ERR_BADRES, "Invalid packet header");
+        if (err->code == SSQ_OK)
+            ssq_packet_init_payload(packet, &datagram_buf, err);
 
         if (err->code != SSQ_OK) {
-            free(packet->payload);
-            free(packet);
+            ssq_mem_free(packet->payload);
+            ssq_mem_free(packet);
             packet = NULL;
         }
     } else {
@@ -114,7 +123,7 @@ uint8_t *ssq_packets_to_response(
 ) {
     *buf_len = ssq_packets_payload_len_sum(packets, packet_count);
 
-    uint8_t *const out = malloc(*buf_len);
+    uint8_t *const out = ssq_mem_alloc(*buf_len);
 
     if (out != NULL) {
         size_t copy_offset = 0;
@@ -130,9 +139,304 @@ uint8_t *ssq_packets_to_response(
     return out;
 }
 
+void ssq_reassembly_init(SSQ_REASSEMBLY *const reassembly) {
+    memset(reassembly, 0, sizeof (*reassembly));
+}
+
+void ssq_reassembly_init_pooled(SSQ_REASSEMBLY *const reassembly, SSQ_POOL *const pool) {
+    ssq_reassembly_init(reassembly);
+    reassembly->pool = pool;
+}
+
+static inline bool ssq_reassembly_has(const SSQ_REASSEMBLY *const reassembly, const uint8_t number) {
+    return (reassembly->bitmap[number >> 6] >> (number & 63)) & 1;
+}
+
+static inline void ssq_reassembly_mark(SSQ_REASSEMBLY *const reassembly, const uint8_t number) {
+    reassembly->bitmap[number >> 6] |= UINT64_C(1) << (number & 63);
+    ++(reassembly->received);
+}
+
+static inline void ssq_reassembly_unmark(SSQ_REASSEMBLY *const reassembly, const uint8_t number) {
+    reassembly->bitmap[number >> 6] &= ~(UINT64_C(1) << (number & 63));
+    --(reassembly->received);
+    reassembly->lens[number] = 0;
+}
+
+/**
+ * Resizes the buffer of a reassembly to hold more payloads or larger ones,
+ * and moves the payloads already received to their new offset.
+ *
+ * @param reassembly reassembly to resize
+ * @param slot_count number of payloads to hold, no less than the current one
+ * @param slot_size  offset between two consecutive payloads, no less than the current one
+ * @param err        where to report potential errors
+ */
+static void ssq_reassembly_resize(
+    SSQ_REASSEMBLY *const reassembly,
+    const uint16_t        slot_count,
+    const size_t          slot_size,
+    SSQ_ERROR      *const err
+) {
+    const size_t size = slot_count * slot_size;
+    const bool   fits = (reassembly->pool != NULL && size <= reassembly->pool->slot_size);
+
+    uint8_t *buf    = reassembly->buf;
+    bool     pooled = reassembly->pooled;
+
+    if (pooled && fits) {
+        // The slot already has room for the larger buffer.
+    } else if (buf == NULL && fits) {
+        buf    = ssq_pool_alloc(reassembly->pool);
+        pooled = true;
+    } else if (pooled) {
+        buf    = ssq_mem_alloc(size);
+        pooled = false;
+
+        if (buf != NULL) {
+            memcpy(buf, reassembly->buf, reassembly->slot_count * reassembly->slot_size);
+            ssq_pool_release(reassembly->pool, reassembly->buf);
+        }
+    } else {
+        buf = ssq_mem_realloc(buf, reassembly->slot_count * reassembly->slot_size, size);
+    }
+
+    if (buf == NULL) {
+        ssq_error_set_from_errno(err);
+        return;
+    }
+
+    // The slots only grow, so moving the payloads from the last one does not overwrite any.
+    if (slot_size != reassembly->slot_size) {
+        for (uint16_t i = reassembly->slot_count; i-- > 1;)
+            memmove(buf + i * slot_size, buf + i * reassembly->slot_size, reassembly->lens[i]);
+    }
+
+    reassembly->buf        = buf;
+    reassembly->pooled     = pooled;
+    reassembly->slot_count = slot_count;
+    reassembly->slot_size  = slot_size;
+}
+
+/**
+ * Sets the total number of packets of a reassembly once a packet announces it, and drops the
+ * packets received so far whose number is past it.
+ *
+ * @param reassembly reassembly
+ * @param total      total number of packets announced
+ */
+static void ssq_reassembly_set_total(SSQ_REASSEMBLY *const reassembly, const uint8_t total) {
+    reassembly->total = total;
+
+    for (uint16_t i = total; i < reassembly->slot_count; ++i) {
+        if (ssq_reassembly_has(reassembly, (uint8_t)i))
+            ssq_reassembly_unmark(reassembly, (uint8_t)i);
+    }
+}
+
+bool ssq_reassembly_add(
+    SSQ_REASSEMBLY *const reassembly,
+    const uint8_t         datagram[],
+    const uint16_t        datagram_len,
+    SSQ_ERROR      *const err
+) {
+    SSQ_PACKET packet;
+    memset(&packet, 0, sizeof (packet));
+
+    SSQ_BUF datagram_buf = ssq_buf_init(datagram, datagram_len);
+
+    ssq_packet_init_header(&packet, &datagram_buf, err);
+    if (err->code != SSQ_OK) return false;
+
+#ifndef SSQ_HAVE_BZIP2
+    if (packet.id & A2S_PACKET_FLAG_COMPRESSION) {
+        ssq_error_set(err, SSQ_ERR_UNSUPPORTED, "Compressed responses are not supported");
+        return false;
+    }
+#endif /* !SSQ_HAVE_BZIP2 */
+
+    // A packet of another response, such as a late one to a retransmitted query, does not spoil this one.
+    if (reassembly->buf != NULL && (packet.header != (int32_t)A2S_PACKET_HEADER_MULTI || packet.id != reassembly->id))
+        return false;
+
+    // Nor does a packet contradicting itself or the total announced by the others.
+    if (packet.total != 0 && packet.number >= packet.total)
+        return false;
+    if (reassembly->total != 0 && packet.total != 0 && packet.total != reassembly->total)
+        return false;
+    if (reassembly->total != 0 && packet.number >= reassembly->total)
+        return false;
+
+    if (ssq_reassembly_has(reassembly, packet.number))
+        return false;
+
+    const size_t payload_len = ssq_buf_available(&datagram_buf);
+
+    if (reassembly->buf == NULL) {
+        reassembly->id        = packet.id;
+        reassembly->slot_size = (packet.size != 0 && packet.size <= SSQ_PACKET_SIZE) ? packet.size : SSQ_PACKET_SIZE;
+    }
+
+    if (reassembly->total == 0 && packet.total != 0)
+        ssq_reassembly_set_total(reassembly, packet.total);
+
+    // The buffer holds all of the packets once their total is known, or else up to the highest number received.
+    uint16_t     slot_count = (reassembly->total != 0) ? reassembly->total : (uint16_t)(packet.number + 1);
+    const size_t slot_size  = (payload_len > reassembly->slot_size) ? ssq_helper_maxz(payload_len, SSQ_PACKET_SIZE) : reassembly->slot_size;
+
+    if (slot_count < reassembly->slot_count)
+        slot_count = reassembly->slot_count;
+
+    if (reassembly->buf == NULL || slot_count != reassembly->slot_count || slot_size != reassembly->slot_size) {
+        ssq_reassembly_resize(reassembly, slot_count, slot_size, err);
+        if (err->code != SSQ_OK) return false;
+    }
+
+    memcpy(reassembly->buf + packet.number * reassembly->slot_size, datagram + datagram_buf.cursor, payload_len);
+    reassembly->lens[packet.number] = (uint16_t)payload_len;
+    ssq_reassembly_mark(reassembly, packet.number);
+
+    return reassembly->total != 0 && reassembly->received == reassembly->total;
+}
+
+#ifdef SSQ_HAVE_BZIP2
+// The state of the decompressor goes through the allocator of the library, and is charged like the response.
+static void *ssq_reassembly_bzalloc(void *const opaque, const int count, const int size) {
+    (void)opaque;
+    return ssq_mem_alloc((size_t)count * (size_t)size);
+}
+
+static void ssq_reassembly_bzfree(void *const opaque, void *const ptr) {
+    (void)opaque;
+    ssq_mem_free(ptr);
+}
+
+/**
+ * Decompresses a reassembled compressed response. The payload of its first packet starts with the
+ * size and the CRC32 checksum of the decompressed response, followed by the bzip2-compressed data.
+ *
+ * @param compressed     reassembled compressed response
+ * @param compressed_len length of the compressed response
+ * @param response_len   where to store the length of the decompressed response
+ * @param err            where to report potential errors
+ *
+ * @return dynamically-allocated decompressed response
+ */
+static uint8_t *ssq_reassembly_decompress(
+    const uint8_t    compressed[],
+    const size_t     compressed_len,
+    size_t    *const response_len,
+    SSQ_ERROR *const err
+) {
+    SSQ_BUF compressed_buf = ssq_buf_init(compressed, compressed_len);
+
+    const int32_t  size = ssq_buf_get_int32(&compressed_buf);
+    const uint32_t crc  = ssq_buf_get_uint32(&compressed_buf);
+
+    if (size <= 0 || size > SSQ_PACKET_DECOMPRESSED_SIZE_MAX) {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid decompressed size");
+        return NULL;
+    }
+
+    uint8_t *const response = ssq_mem_alloc(size);
+
+    if (response == NULL) {
+        ssq_error_set_from_errno(err);
+        return NULL;
+    }
+
+    bz_stream stream;
+    memset(&stream, 0, sizeof (stream));
+    stream.bzalloc = ssq_reassembly_bzalloc;
+    stream.bzfree  = ssq_reassembly_bzfree;
+
+    int result = BZ2_bzDecompressInit(&stream, 0, 0);
+
+    if (result == BZ_OK) {
+        stream.next_in   = (char *)(compressed + compressed_buf.cursor);
+        stream.avail_in  = (unsigned int)ssq_buf_available(&compressed_buf);
+        stream.next_out  = (char *)response;
+        stream.avail_out = (unsigned int)size;
+
+        // All of the input and output being at hand, a single call decompresses the whole stream.
+        result = BZ2_bzDecompress(&stream);
+        BZ2_bzDecompressEnd(&stream);
+    }
+
+    const unsigned int decompressed_len = (unsigned int)size - stream.avail_out;
+
+    if (result == BZ_MEM_ERROR) {
+        ssq_error_set_from_errno(err);
+    } else if (result == BZ_OK && stream.avail_out == 0) {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Decompressed size mismatch");
+    } else if (result != BZ_STREAM_END) {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid compressed data");
+    } else if (decompressed_len != (unsigned int)size) {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Decompressed size mismatch");
+    } else if (ssq_crc32(response, decompressed_len) != crc) {
+        ssq_error_set(err, SSQ_ERR_BADRES, "CRC32 checksum mismatch");
+    }
+
+    if (err->code != SSQ_OK) {
+        ssq_mem_free(response);
+        return NULL;
+    }
+
+    *response_len = decompressed_len;
+
+    return response;
+}
+#endif /* SSQ_HAVE_BZIP2 */
+
+uint8_t *ssq_reassembly_release(SSQ_REASSEMBLY *const reassembly, size_t *const response_len, SSQ_ERROR *const err) {
+    uint8_t *buf = reassembly->buf;
+    size_t   len = 0;
+
+    // The payloads are only moved if a packet other than the last one is shorter than announced.
+    for (uint16_t i = 0; i < reassembly->total; ++i) {
+        const size_t offset = i * reassembly->slot_size;
+
+        if (offset != len)
+            memmove(buf + len, buf + offset, reassembly->lens[i]);
+
+        len += reassembly->lens[i];
+    }
+
+    reassembly->buf = NULL;
+
+#ifdef SSQ_HAVE_BZIP2
+    if (reassembly->id & A2S_PACKET_FLAG_COMPRESSION) {
+        uint8_t *const compressed = buf;
+
+        buf = ssq_reassembly_decompress(compressed, len, &len, err);
+        ssq_reassembly_free_response(reassembly, compressed);
+        reassembly->pooled = false;
+    }
+#else /* not SSQ_HAVE_BZIP2 */
+    (void)err;
+#endif /* SSQ_HAVE_BZIP2 */
+
+    *response_len = len;
+
+    return buf;
+}
+
+void ssq_reassembly_free(SSQ_REASSEMBLY *const reassembly) {
+    ssq_reassembly_free_response(reassembly, reassembly->buf);
+    reassembly->buf    = NULL;
+    reassembly->pooled = false;
+}
+
+void ssq_reassembly_free_response(SSQ_REASSEMBLY *const reassembly, uint8_t *const response) {
+    if (reassembly->pooled)
+        ssq_pool_release(reassembly->pool, response);
+    else
+        ssq_mem_free(response);
+}
+
 void ssq_packet_free(SSQ_PACKET *const packet) {
-    free(packet->payload);
-    free(packet);
+    ssq_mem_free(packet->payload);
+    ssq_mem_free(packet);
 }
 
 void ssq_packets_free(SSQ_PACKET *packets[], const uint8_t packet_count) {
@@ -142,5 +446,5 @@ void ssq_packets_free(SSQ_PACKET *packets[], const uint8_t packet_count) {
         }
     }
 
-    free(packets);
+    ssq_mem_free(packets);
 }
@@ -0,0 +1,79 @@
+#include <stdbool.h>
+#include "ssq/mem.h"
+#include "ssq/pool.h"
+
+/* Alignment of the slots, enough for any of the structures they hold. */
+#define SSQ_POOL_ALIGNMENT 16
+
+typedef struct ssq_pool_slab {
+    struct ssq_pool_slab *next; /** Slab allocated before this one */
+} SSQ_POOL_SLAB;
+
+/* Offset of the first slot of a slab, past its header. */
+#define SSQ_POOL_SLAB_HEADER_SIZE ((sizeof (SSQ_POOL_SLAB) + SSQ_POOL_ALIGNMENT - 1) / SSQ_POOL_ALIGNMENT * SSQ_POOL_ALIGNMENT)
+
+void ssq_pool_init(SSQ_POOL *const pool, const size_t slot_size) {
+    // A free slot holds the link to the next one.
+    const size_t size = (slot_size < sizeof (void *)) ? sizeof (void *) : slot_size;
+
+    pool->slot_size = (size + SSQ_POOL_ALIGNMENT - 1) / SSQ_POOL_ALIGNMENT * SSQ_POOL_ALIGNMENT;
+    pool->free_list = NULL;
+    pool->slabs     = NULL;
+    pool->hits      = 0;
+    pool->misses    = 0;
+}
+
+void ssq_pool_free(SSQ_POOL *const pool) {
+    while (pool->slabs != NULL) {
+        SSQ_POOL_SLAB *const next = pool->slabs->next;
+        ssq_mem_free(pool->slabs);
+        pool->slabs = next;
+    }
+
+    pool->free_list = NULL;
+}
+
+/**
+ * Allocates a new slab and puts its slots on the free list of a pool.
+ * @param pool pool
+ * @return false in case of a memory allocation failure
+ */
+static bool ssq_pool_grow(SSQ_POOL *const pool) {
+    SSQ_POOL_SLAB *const slab = ssq_mem_alloc(SSQ_POOL_SLAB_HEADER_SIZE + SSQ_POOL_SLAB_SLOTS * pool->slot_size);
+
+    if (slab == NULL)
+        return false;
+
+    slab->next  = pool->slabs;
+    pool->slabs = slab;
+
+    uint8_t *const slots = (uint8_t *)slab + SSQ_POOL_SLAB_HEADER_SIZE;
+
+    for (size_t i = SSQ_POOL_SLAB_SLOTS; i-- > 0;)
+        ssq_pool_release(pool, slots + i * pool->slot_size);
+
+    return true;
+}
+
+void *ssq_pool_alloc(SSQ_POOL *const pool) {
+    if (pool->free_list != NULL) {
+        ++(pool->hits);
+    } else if (ssq_pool_grow(pool)) {
+        ++(pool->misses);
+    } else {
+        return NULL;
+    }
+
+    void *const slot = pool->free_list;
+    pool->free_list  = *(void **)slot;
+
+    return slot;
+}
+
+void ssq_pool_release(SSQ_POOL *const pool, void *const slot) {
+    if (slot == NULL)
+        return;
+
+    *(void **)slot  = pool->free_list;
+    pool->free_list = slot;
+}
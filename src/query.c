@@ -1,8 +1,17 @@
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
+#include "ssq/a2s/info.h"
+#include "ssq/buf.h"
+#include "ssq/helper.h"
+#include "ssq/mem.h"
 #include "ssq/packet.h"
 #include "ssq/query.h"
+#include "ssq/response.h"
 
 #ifndef _WIN32
+# include <errno.h>
+# include <poll.h>
 # include <unistd.h>
 # define INVALID_SOCKET (-1)
 # define SOCKET_ERROR   (-1)
@@ -10,40 +19,97 @@
 typedef int SOCKET;
 #endif /* _WIN32 */
 
-#define SSQ_PACKET_SIZE 1400
+/* Size of the largest A2S payload. */
+#define SSQ_QUERY_PAYLOAD_SIZE A2S_INFO_PAYLOAD_LEN
 
-static SOCKET ssq_query_init_socket(SSQ_QUERIER *const querier) {
-    SOCKET sockfd = INVALID_SOCKET;
+/* Timeout or deadline of a wait with no limit. */
+#define SSQ_QUERY_TIMEOUT_NONE INT64_MAX
 
-    for (struct addrinfo *addr = querier->addr_list; addr != NULL; addr = addr->ai_next) {
-        sockfd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+/* Number of responses a pipeline reassembles at once, which leaves room for duplicate ones. */
+#define SSQ_QUERY_PIPELINE_REASSEMBLIES (2 * SSQ_QUERY_PIPELINE_MAX)
 
-        if (sockfd == INVALID_SOCKET) {
-            continue;
-        } else if (connect(sockfd, addr->ai_addr, (int)addr->ai_addrlen) != SOCKET_ERROR) {
-            break;
-        } else {
-            closesocket(sockfd);
-            sockfd = INVALID_SOCKET;
-        }
+/**
+ * Creates a socket connected to an address.
+ * @param addr address to connect to
+ * @return socket connected to the address, or `INVALID_SOCKET' if it could not be created or connected
+ */
+static SOCKET ssq_query_open(const struct addrinfo *const addr) {
+    SOCKET sockfd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+
+    if (sockfd != INVALID_SOCKET && connect(sockfd, addr->ai_addr, (int)addr->ai_addrlen) == SOCKET_ERROR) {
+        closesocket(sockfd);
+        sockfd = INVALID_SOCKET;
     }
 
+    return sockfd;
+}
+
+static void ssq_query_init_socket(SSQ_QUERIER *const querier) {
+    SOCKET sockfd = INVALID_SOCKET;
+
+    if (querier->addr_preferred != NULL)
+        sockfd = ssq_query_open(querier->addr_preferred);
+
+    for (struct addrinfo *addr = querier->addr_list; addr != NULL && sockfd == INVALID_SOCKET; addr = addr->ai_next)
+        sockfd = ssq_query_open(addr);
+
     if (sockfd != INVALID_SOCKET) {
-        if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, (const char *)(&(querier->timeout_recv)), sizeof (querier->timeout_recv)) == SOCKET_ERROR ||
-            setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, (const char *)(&(querier->timeout_send)), sizeof (querier->timeout_send)) == SOCKET_ERROR) {
+        querier->sockfd           = sockfd;
+        querier->timeouts_changed = true;
+    } else {
+        ssq_error_set(&(querier->err), SSQ_ERR_NOENDPOINT, "No endpoints available to communicate with the target server");
+    }
+}
+
+static void ssq_query_apply_timeouts(SSQ_QUERIER *const querier) {
+    const SOCKET sockfd = querier->sockfd;
+
+    if (setsockopt(sockfd, SOL_SOCKET, SO_SNDTIMEO, (const char *)(&(querier->timeout_send)), sizeof (querier->timeout_send)) == SOCKET_ERROR) {
 #ifdef _WIN32
-            ssq_error_set_from_wsa(&(querier->err));
+        ssq_error_set_from_wsa(&(querier->err));
 #else /* not _WIN32 */
-            ssq_error_set_from_errno(&(querier->err));
+        ssq_error_set_from_errno(&(querier->err));
 #endif /* _WIN32 */
-            closesocket(sockfd);
-            sockfd = INVALID_SOCKET;
-        }
     } else {
-        ssq_error_set(&(querier->err), SSQ_ERR_NOENDPOINT, "No endpoints available to communicate with the target server");
+        querier->timeouts_changed = false;
     }
+}
 
-    return sockfd;
+/**
+ * Creates and connects the socket of a Source server querier if it has none yet,
+ * and applies its timeouts if they changed.
+ *
+ * @param querier Source server querier
+ */
+static void ssq_query_prepare_socket(SSQ_QUERIER *const querier) {
+    if (querier->sockfd == INVALID_SOCKET) {
+        ssq_query_init_socket(querier);
+        if (!ssq_ok(querier)) return;
+    }
+
+    if (querier->timeouts_changed)
+        ssq_query_apply_timeouts(querier);
+}
+
+/**
+ * Discards the datagrams already queued on a socket, such as late
+ * responses to a previous query which timed out.
+ *
+ * @param sockfd socket to drain
+ */
+static void ssq_query_drain(const SOCKET sockfd) {
+    uint8_t datagram[SSQ_PACKET_SIZE];
+
+#ifdef _WIN32
+    u_long pending = 0;
+
+    while (ioctlsocket(sockfd, FIONREAD, &pending) != SOCKET_ERROR && pending != 0)
+        if (recv(sockfd, (char *)datagram, SSQ_PACKET_SIZE, 0) == SOCKET_ERROR)
+            break;
+#else /* not _WIN32 */
+    while (recv(sockfd, datagram, SSQ_PACKET_SIZE, MSG_DONTWAIT) != SOCKET_ERROR)
+        continue;
+#endif /* _WIN32 */
 }
 
 static void ssq_query_send(const SOCKET sockfd, const uint8_t payload[], const size_t payload_len, SSQ_ERROR *const err) {
@@ -56,52 +122,649 @@ static void ssq_query_send(const SOCKET sockfd, const uint8_t payload[], const s
 #endif /* _WIN32 */
 }
 
-static SSQ_PACKET **ssq_query_recv(const SOCKET sockfd, uint8_t *const packet_count, SSQ_ERROR *const err) {
-    *packet_count = 1;
+/**
+ * Gets the receive timeout of a Source server querier.
+ * @param querier Source server querier
+ * @return receive timeout in milliseconds, or `SSQ_QUERY_TIMEOUT_NONE'
+ */
+static inline int64_t ssq_query_timeout_recv_ms(const SSQ_QUERIER *const querier) {
+#ifdef _WIN32
+    const int64_t timeout_recv = (int64_t)querier->timeout_recv;
+#else /* not _WIN32 */
+    const int64_t timeout_recv = (int64_t)querier->timeout_recv.tv_sec * 1000 + querier->timeout_recv.tv_usec / 1000;
+#endif /* _WIN32 */
+
+    return (timeout_recv > 0) ? timeout_recv : SSQ_QUERY_TIMEOUT_NONE;
+}
+
+/**
+ * Computes the deadline of a query starting now.
+ * @param querier Source server querier
+ * @return monotonic time at which the query times out in ms, or `SSQ_QUERY_TIMEOUT_NONE'
+ */
+static inline int64_t ssq_query_deadline(const SSQ_QUERIER *const querier) {
+    return (querier->timeout_query > 0) ? ssq_helper_now_ms() + querier->timeout_query : SSQ_QUERY_TIMEOUT_NONE;
+}
 
-    SSQ_PACKET **packets = NULL;
+/**
+ * Computes how long a single poll may wait, which is bounded by both the time remaining and the receive timeout.
+ *
+ * @param remaining    time remaining before the deadline in ms
+ * @param timeout_recv receive timeout in ms
+ *
+ * @return time to wait in ms
+ */
+static inline int ssq_query_poll_wait(const int64_t remaining, const int64_t timeout_recv) {
+    const int64_t wait = (remaining < timeout_recv) ? remaining : timeout_recv;
+    return (int)((wait < INT_MAX) ? wait : INT_MAX);
+}
 
-    for (uint8_t packets_received = 0; packets_received < *packet_count; ++packets_received) {
-        uint8_t datagram[SSQ_PACKET_SIZE];
+/**
+ * Waits for a datagram to be received, at most until the deadline of the query or the end of the receive timeout.
+ *
+ * @param sockfd       socket to wait on
+ * @param deadline     monotonic time at which the query times out in ms
+ * @param timeout_recv receive timeout in ms
+ * @param err          where to report potential errors
+ */
+static void ssq_query_wait(const SOCKET sockfd, const int64_t deadline, const int64_t timeout_recv, SSQ_ERROR *const err) {
+    for (;;) {
+        const int64_t remaining = deadline - ssq_helper_now_ms();
+
+        if (remaining <= 0)
+            break;
+
+        const int wait = ssq_query_poll_wait(remaining, timeout_recv);
 
 #ifdef _WIN32
-        const int bytes_received = recv(sockfd, (char *)datagram, SSQ_PACKET_SIZE, 0);
+        WSAPOLLFD pollfd = { .fd = sockfd, .events = POLLRDNORM, .revents = 0 };
+        const int ready  = WSAPoll(&pollfd, 1, wait);
 #else /* not _WIN32 */
-        const ssize_t bytes_received = recv(sockfd, datagram, SSQ_PACKET_SIZE, 0);
+        struct pollfd pollfd = { .fd = sockfd, .events = POLLIN, .revents = 0 };
+        const int     ready  = poll(&pollfd, 1, wait);
+#endif /* _WIN32 */
+
+        if (ready > 0)
+            return;
+
+        if (ready == SOCKET_ERROR) {
+#ifdef _WIN32
+            ssq_error_set_from_wsa(err);
+            return;
+#else /* not _WIN32 */
+            if (errno == EINTR)
+                continue;
+
+            ssq_error_set_from_errno(err);
+            return;
+#endif /* _WIN32 */
+        }
+
+        if (wait == timeout_recv)
+            break;
+    }
+
+    ssq_error_set(err, SSQ_ERR_TIMEOUT, "Query timed out");
+}
+
+/**
+ * Reads a datagram from a socket which is readable.
+ *
+ * @param sockfd   socket to read from
+ * @param datagram where to store the datagram
+ * @param err      where to report potential errors
+ *
+ * @return length of the datagram read
+ */
+static size_t ssq_query_read_datagram(const SOCKET sockfd, uint8_t datagram[SSQ_PACKET_SIZE], SSQ_ERROR *const err) {
+#ifdef _WIN32
+    const int bytes_received = recv(sockfd, (char *)datagram, SSQ_PACKET_SIZE, 0);
+#else /* not _WIN32 */
+    const ssize_t bytes_received = recv(sockfd, datagram, SSQ_PACKET_SIZE, 0);
 #endif /* not _WIN32 */
 
-        if (bytes_received != SOCKET_ERROR) {
-            SSQ_PACKET *const packet = ssq_packet_from_datagram(datagram, bytes_received, err);
-            if (err->code != SSQ_OK) break;
+    if (bytes_received == SOCKET_ERROR) {
+#ifdef _WIN32
+        ssq_error_set_from_wsa(err);
+#else /* not _WIN32 */
+        ssq_error_set_from_errno(err);
+#endif /* _WIN32 */
+        return 0;
+    }
+
+    return (size_t)bytes_received;
+}
 
-            const bool is_first_packet = (packets == NULL);
-            if (is_first_packet) {
-                *packet_count = packet->total;
+/**
+ * Receives a datagram.
+ *
+ * @param sockfd       socket to receive from
+ * @param datagram     where to store the datagram
+ * @param deadline     monotonic time at which the query times out in ms
+ * @param timeout_recv receive timeout in ms
+ * @param err          where to report potential errors
+ *
+ * @return length of the datagram received
+ */
+static size_t ssq_query_recv_datagram(
+    const SOCKET     sockfd,
+    uint8_t          datagram[SSQ_PACKET_SIZE],
+    const int64_t    deadline,
+    const int64_t    timeout_recv,
+    SSQ_ERROR *const err
+) {
+    ssq_query_wait(sockfd, deadline, timeout_recv, err);
+    if (err->code != SSQ_OK) return 0;
 
-                packets = calloc(*packet_count, sizeof (SSQ_PACKET *));
-                if (packets == NULL) {
-                    ssq_error_set_from_errno(err);
-                    break;
-                }
+    return ssq_query_read_datagram(sockfd, datagram, err);
+}
+
+/**
+ * Receives the remaining packets of a multi-packet response and reassembles it.
+ *
+ * @param sockfd       socket to receive from
+ * @param datagram     first datagram of the response, already received
+ * @param datagram_len length of the first datagram
+ * @param deadline     monotonic time at which the query times out in ms
+ * @param timeout_recv receive timeout in ms
+ * @param response_len where to store the length of the response
+ * @param err          where to report potential errors
+ *
+ * @return dynamically-allocated buffer containing the reassembled response
+ */
+static uint8_t *ssq_query_recv_multi(
+    const SOCKET     sockfd,
+    const uint8_t    datagram[],
+    size_t           datagram_len,
+    const int64_t    deadline,
+    const int64_t    timeout_recv,
+    size_t    *const response_len,
+    SSQ_ERROR *const err
+) {
+    SSQ_REASSEMBLY reassembly;
+    ssq_reassembly_init(&reassembly);
+
+    uint8_t next_datagram[SSQ_PACKET_SIZE];
+
+    while (!ssq_reassembly_add(&reassembly, datagram, (uint16_t)datagram_len, err) && err->code == SSQ_OK) {
+        datagram_len = ssq_query_recv_datagram(sockfd, next_datagram, deadline, timeout_recv, err);
+        datagram     = next_datagram;
+        if (err->code != SSQ_OK) break;
+    }
+
+    if (err->code != SSQ_OK) {
+        ssq_reassembly_free(&reassembly);
+        return NULL;
+    }
+
+    return ssq_reassembly_release(&reassembly, response_len, err);
+}
+
+/**
+ * Receives the response to a query, once its first datagram is ready to be read.
+ * A single-packet response is handed out in the very buffer it was received in,
+ * starting with its single-packet response header.
+ *
+ * @param sockfd       readable socket to receive from
+ * @param deadline     monotonic time at which the query times out in ms
+ * @param timeout_recv receive timeout in ms
+ * @param response_len where to store the length of the response
+ * @param err          where to report potential errors
+ *
+ * @return dynamically-allocated buffer containing the response
+ */
+static uint8_t *ssq_query_recv(
+    const SOCKET     sockfd,
+    const int64_t    deadline,
+    const int64_t    timeout_recv,
+    size_t    *const response_len,
+    SSQ_ERROR *const err
+) {
+    uint8_t *const datagram = ssq_mem_alloc(SSQ_PACKET_SIZE);
+
+    if (datagram == NULL) {
+        ssq_error_set_from_errno(err);
+        return NULL;
+    }
+
+    const size_t datagram_len = ssq_query_read_datagram(sockfd, datagram, err);
+
+    if (err->code != SSQ_OK) {
+        ssq_mem_free(datagram);
+        return NULL;
+    }
+
+    if (ssq_response_is_truncated(datagram, datagram_len)) {
+        *response_len = datagram_len;
+        return datagram;
+    }
+
+    uint8_t *const response = ssq_query_recv_multi(sockfd, datagram, datagram_len, deadline, timeout_recv, response_len, err);
+    ssq_mem_free(datagram);
+
+    return response;
+}
+
+/**
+ * Sends a request to a Source server until it answers, as many times as the querier allows. Each attempt but
+ * the last one waits for the retransmission timeout of the target. The round-trip time of an exchange which
+ * was not retransmitted updates the estimate of the target.
+ *
+ * @param querier     Source server querier to use
+ * @param payload     request's payload
+ * @param payload_len length of the request's payload
+ * @param deadline    monotonic time at which the query times out in ms
+ */
+static void ssq_query_send_until_answered(
+    SSQ_QUERIER *const querier,
+    const uint8_t      payload[],
+    const size_t       payload_len,
+    const int64_t      deadline
+) {
+    const SOCKET  sockfd       = querier->sockfd;
+    const int64_t timeout_recv = ssq_query_timeout_recv_ms(querier);
+
+    for (uint8_t attempt = 1;; ++attempt) {
+        ssq_query_send(sockfd, payload, payload_len, &(querier->err));
+        if (!ssq_ok(querier)) return;
+
+        const int64_t sent_at = ssq_helper_now_ms();
+        const bool    last    = (attempt >= querier->max_attempts);
+
+        int64_t wait_until = deadline;
+
+        if (!last) {
+            const int64_t rto_at = sent_at + ssq_rtt_rto(&(querier->rtt), attempt - 1);
+
+            if (rto_at < wait_until)
+                wait_until = rto_at;
+        }
+
+        ssq_query_wait(sockfd, wait_until, timeout_recv, &(querier->err));
+
+        if (ssq_ok(querier)) {
+            // Karn's algorithm: the reply to a retransmitted request may answer any of its attempts.
+            if (attempt == 1)
+                ssq_rtt_sample(&(querier->rtt), ssq_helper_now_ms() - sent_at);
+
+            return;
+        }
+
+        if (last || ssq_errc(querier) != SSQ_ERR_TIMEOUT || ssq_helper_now_ms() >= deadline)
+            return;
+
+        ssq_errclr(querier);
+    }
+}
+
+typedef struct ssq_query_racer {
+    struct addrinfo *addr;    /** Address raced                                                   */
+    SOCKET           sockfd;  /** Socket connected to the address, or `INVALID_SOCKET' once it lost */
+    int64_t          sent_at; /** Monotonic time at which the request was last sent to the address  */
+} SSQ_QUERY_RACER;
+
+/**
+ * Gets the next address of a list which belongs, or not, to an address family.
+ *
+ * @param addr   address to start from
+ * @param family address family
+ * @param same   whether the address must belong to the family or to another one
+ *
+ * @return next address matching, or NULL
+ */
+static struct addrinfo *ssq_query_race_next(struct addrinfo *addr, const int family, const bool same) {
+    while (addr != NULL && (addr->ai_family == family) != same)
+        addr = addr->ai_next;
+
+    return addr;
+}
+
+/**
+ * Picks the addresses of the target of a Source server querier to race: the first address of each family,
+ * followed in `SSQ_RACE_ALL' mode by the other addresses, alternating between the families.
+ *
+ * @param querier    Source server querier
+ * @param candidates where to store the addresses to race
+ *
+ * @return number of addresses to race
+ */
+static size_t ssq_query_race_candidates(const SSQ_QUERIER *const querier, struct addrinfo *candidates[SSQ_RACE_MAX]) {
+    struct addrinfo *const first = querier->addr_list;
+
+    if (first == NULL)
+        return 0;
+
+    struct addrinfo *cursors[2] = { first, ssq_query_race_next(first, first->ai_family, false) };
+    size_t           count      = 0;
+
+    while (count < SSQ_RACE_MAX && (cursors[0] != NULL || cursors[1] != NULL)) {
+        for (size_t i = 0; i < 2 && count < SSQ_RACE_MAX; ++i) {
+            if (cursors[i] == NULL)
+                continue;
+
+            candidates[count++] = cursors[i];
+            cursors[i]          = (querier->race == SSQ_RACE_ALL) ? ssq_query_race_next(cursors[i]->ai_next, first->ai_family, i == 0) : NULL;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Checks the datagram ready to be read on the socket of a raced address, and discards it unless it starts with
+ * an A2S packet header.
+ *
+ * @param sockfd readable socket of a raced address
+ * @param err    where to report potential errors, such as the address being unreachable
+ *
+ * @return true if the datagram is left to be read as a valid reply
+ */
+static bool ssq_query_race_check(const SOCKET sockfd, SSQ_ERROR *const err) {
+    uint8_t header[4];
+
+#ifdef _WIN32
+    int received = recv(sockfd, (char *)header, sizeof (header), MSG_PEEK);
+
+    // A datagram longer than the buffer is reported as an error, although the buffer is filled.
+    if (received == SOCKET_ERROR && WSAGetLastError() == WSAEMSGSIZE)
+        received = sizeof (header);
+#else /* not _WIN32 */
+    const ssize_t received = recv(sockfd, header, sizeof (header), MSG_PEEK);
+#endif /* _WIN32 */
+
+    if (received == SOCKET_ERROR) {
+#ifdef _WIN32
+        ssq_error_set_from_wsa(err);
+#else /* not _WIN32 */
+        ssq_error_set_from_errno(err);
+#endif /* _WIN32 */
+        return false;
+    }
+
+    if ((size_t)received == sizeof (header)) {
+        SSQ_BUF        buf    = ssq_buf_init(header, sizeof (header));
+        const uint32_t packet = ssq_buf_get_uint32(&buf);
+
+        if (packet == A2S_PACKET_HEADER_SINGLE || packet == A2S_PACKET_HEADER_MULTI)
+            return true;
+    }
+
+#ifdef _WIN32
+    recv(sockfd, (char *)header, sizeof (header), 0);
+#else /* not _WIN32 */
+    recv(sockfd, header, sizeof (header), 0);
+#endif /* _WIN32 */
+
+    return false;
+}
+
+/**
+ * Puts a raced address out of the race.
+ * @param racer raced address
+ */
+static inline void ssq_query_race_drop(SSQ_QUERY_RACER *const racer) {
+    closesocket(racer->sockfd);
+    racer->sockfd = INVALID_SOCKET;
+}
+
+/**
+ * Makes one attempt of a race: sends the request to each address still in the race, waiting for the stagger
+ * of the querier in between unless an address turns out unreachable, then waits for the first valid reply.
+ * Each attempt but the last one ends after the retransmission timeout of the target.
+ *
+ * @param querier      Source server querier
+ * @param racers       raced addresses
+ * @param racer_count  number of raced addresses
+ * @param payload      request's payload
+ * @param payload_len  length of the request's payload
+ * @param attempt      number of the attempt, starting from 1
+ * @param deadline     monotonic time at which the query times out in ms
+ *
+ * @return raced address which replied first, or NULL in case of an error
+ */
+static SSQ_QUERY_RACER *ssq_query_race_attempt(
+    SSQ_QUERIER     *const querier,
+    SSQ_QUERY_RACER        racers[],
+    const size_t           racer_count,
+    const uint8_t          payload[],
+    const size_t           payload_len,
+    const uint8_t          attempt,
+    const int64_t          deadline
+) {
+    const int64_t timeout_recv = ssq_query_timeout_recv_ms(querier);
+    const bool    last         = (attempt >= querier->max_attempts);
+
+    SSQ_ERROR lost; // why the last address put out of the race lost
+    ssq_error_set(&lost, SSQ_ERR_NOENDPOINT, "No endpoints available to communicate with the target server");
+
+    size_t  next    = 0;                    // next address to send the request to
+    int64_t next_at = ssq_helper_now_ms(); // when the request is sent to the next address
+    int64_t sent_at = next_at;             // when the request was last sent
+
+    for (;;) {
+        int64_t now = ssq_helper_now_ms();
+
+        for (; next < racer_count && now >= next_at; ++next) {
+            SSQ_QUERY_RACER *const racer = &(racers[next]);
+
+            if (racer->sockfd == INVALID_SOCKET)
+                continue;
+
+            SSQ_ERROR err;
+            ssq_error_clear(&err);
+
+            ssq_query_send(racer->sockfd, payload, payload_len, &err);
+
+            if (err.code != SSQ_OK) {
+                ssq_query_race_drop(racer);
+                lost = err;
+                continue;
             }
 
-            packets[packet->number] = packet;
-        } else {
+            racer->sent_at = now;
+            sent_at        = now;
+            next_at        = now + querier->race_stagger;
+        }
+
 #ifdef _WIN32
-            ssq_error_set_from_wsa(err);
+        WSAPOLLFD        pollfds[SSQ_RACE_MAX];
 #else /* not _WIN32 */
-            ssq_error_set_from_errno(err);
+        struct pollfd    pollfds[SSQ_RACE_MAX];
 #endif /* _WIN32 */
+        SSQ_QUERY_RACER *polled[SSQ_RACE_MAX];
+        size_t           poll_count = 0;
+
+        for (size_t i = 0; i < next; ++i) {
+            if (racers[i].sockfd == INVALID_SOCKET)
+                continue;
+
+            pollfds[poll_count].fd      = racers[i].sockfd;
+#ifdef _WIN32
+            pollfds[poll_count].events  = POLLRDNORM;
+#else /* not _WIN32 */
+            pollfds[poll_count].events  = POLLIN;
+#endif /* _WIN32 */
+            pollfds[poll_count].revents = 0;
+            polled[poll_count++]        = &(racers[i]);
+        }
+
+        if (poll_count == 0 && next == racer_count) {
+            querier->err = lost;
+            return NULL;
+        }
+
+        int64_t wait_until = deadline;
+
+        if (next < racer_count) {
+            if (next_at < wait_until)
+                wait_until = next_at;
+        } else if (!last) {
+            const int64_t rto_at = sent_at + ssq_rtt_rto(&(querier->rtt), attempt - 1);
+
+            if (rto_at < wait_until)
+                wait_until = rto_at;
+        }
+
+        const int64_t remaining = wait_until - now;
+
+        if (remaining <= 0) {
+            if (next < racer_count && now < deadline)
+                continue;
+
+            ssq_error_set(&(querier->err), SSQ_ERR_TIMEOUT, "Query timed out");
+            return NULL;
+        }
+
+        const int wait = ssq_query_poll_wait(remaining, timeout_recv);
+
+#ifdef _WIN32
+        const int ready = WSAPoll(pollfds, (ULONG)poll_count, wait);
+#else /* not _WIN32 */
+        const int ready = poll(pollfds, (nfds_t)poll_count, wait);
+#endif /* _WIN32 */
+
+        if (ready == SOCKET_ERROR) {
+#ifdef _WIN32
+            ssq_error_set_from_wsa(&(querier->err));
+            return NULL;
+#else /* not _WIN32 */
+            if (errno == EINTR)
+                continue;
+
+            ssq_error_set_from_errno(&(querier->err));
+            return NULL;
+#endif /* _WIN32 */
+        }
+
+        if (ready == 0 && wait == timeout_recv) {
+            ssq_error_set(&(querier->err), SSQ_ERR_TIMEOUT, "Query timed out");
+            return NULL;
+        }
+
+        for (size_t i = 0; i < poll_count; ++i) {
+            if (pollfds[i].revents == 0)
+                continue;
+
+            SSQ_ERROR err;
+            ssq_error_clear(&err);
+
+            if (ssq_query_race_check(polled[i]->sockfd, &err))
+                return polled[i];
+
+            if (err.code != SSQ_OK) {
+                // The next address need not wait for the stagger once this one is out of the race.
+                ssq_query_race_drop(polled[i]);
+                lost    = err;
+                next_at = ssq_helper_now_ms();
+            }
+        }
+    }
+}
+
+/**
+ * Races the request of a query to the addresses of the target picked by the racing mode of a Source server
+ * querier, as many times as the querier allows. The socket of the address which replies first becomes the socket
+ * of the querier, with the reply left to be received on it, and the address is preferred from then on.
+ *
+ * @param querier     Source server querier
+ * @param payload     request's payload
+ * @param payload_len length of the request's payload
+ * @param deadline    monotonic time at which the query times out in ms
+ */
+static void ssq_query_race(
+    SSQ_QUERIER *const querier,
+    const uint8_t      payload[],
+    const size_t       payload_len,
+    const int64_t      deadline
+) {
+    struct addrinfo *candidates[SSQ_RACE_MAX];
+    const size_t     candidate_count = ssq_query_race_candidates(querier, candidates);
+
+    SSQ_QUERY_RACER racers[SSQ_RACE_MAX];
+    size_t          racer_count = 0;
+
+    for (size_t i = 0; i < candidate_count; ++i) {
+        const SOCKET sockfd = ssq_query_open(candidates[i]);
+
+        if (sockfd != INVALID_SOCKET) {
+            racers[racer_count].addr    = candidates[i];
+            racers[racer_count].sockfd  = sockfd;
+            racers[racer_count].sent_at = 0;
+            ++racer_count;
+        }
+    }
+
+    if (racer_count == 0) {
+        ssq_error_set(&(querier->err), SSQ_ERR_NOENDPOINT, "No endpoints available to communicate with the target server");
+        return;
+    }
+
+    SSQ_QUERY_RACER *winner = NULL;
+
+    for (uint8_t attempt = 1;; ++attempt) {
+        winner = ssq_query_race_attempt(querier, racers, racer_count, payload, payload_len, attempt, deadline);
+
+        if (winner != NULL) {
+            // Karn's algorithm: the reply to a retransmitted request may answer any of its attempts.
+            if (attempt == 1)
+                ssq_rtt_sample(&(querier->rtt), ssq_helper_now_ms() - winner->sent_at);
+
             break;
         }
+
+        if (attempt >= querier->max_attempts || ssq_errc(querier) != SSQ_ERR_TIMEOUT || ssq_helper_now_ms() >= deadline)
+            break;
+
+        ssq_errclr(querier);
+    }
+
+    for (size_t i = 0; i < racer_count; ++i)
+        if (&(racers[i]) != winner && racers[i].sockfd != INVALID_SOCKET)
+            closesocket(racers[i].sockfd);
+
+    if (winner != NULL) {
+        querier->sockfd           = winner->sockfd;
+        querier->addr_preferred   = winner->addr;
+        querier->timeouts_changed = true;
     }
+}
+
+/**
+ * Sends a query to a Source server and receives its response. As long as no address of the target
+ * replied yet, the query races the addresses picked by the racing mode of the querier, if any.
+ *
+ * @param querier      Source server querier to use
+ * @param payload      query's payload
+ * @param payload_len  length of the query's payload
+ * @param deadline     monotonic time at which the query times out in ms
+ * @param response_len where to store the length of the query's response
+ *
+ * @return dynamically-allocated buffer containing the query's response
+ */
+static uint8_t *ssq_query_exchange(
+    SSQ_QUERIER *const querier,
+    const uint8_t      payload[],
+    const size_t       payload_len,
+    const int64_t      deadline,
+    size_t      *const response_len
+) {
+    if (querier->sockfd == INVALID_SOCKET && querier->race != SSQ_RACE_OFF) {
+        ssq_query_race(querier, payload, payload_len, deadline);
+        if (!ssq_ok(querier)) return NULL;
+
+        ssq_query_prepare_socket(querier);
+    } else {
+        ssq_query_prepare_socket(querier);
+        if (!ssq_ok(querier)) return NULL;
+
+        ssq_query_drain(querier->sockfd);
 
-    if (err->code != SSQ_OK && packets != NULL) {
-        ssq_packets_free(packets, *packet_count);
-        packets = NULL;
+        ssq_query_send_until_answered(querier, payload, payload_len, deadline);
     }
 
-    return packets;
+    if (!ssq_ok(querier)) return NULL;
+
+    return ssq_query_recv(querier->sockfd, deadline, ssq_query_timeout_recv_ms(querier), response_len, &(querier->err));
 }
 
 uint8_t *ssq_query(
@@ -110,29 +773,299 @@ uint8_t *ssq_query(
     const size_t       payload_len,
     size_t      *const response_len
 ) {
-    uint8_t *response = NULL;
+    const int64_t deadline = ssq_query_deadline(querier);
 
-    const SOCKET sockfd = ssq_query_init_socket(querier);
-    if (!ssq_ok(querier)) return NULL;
+    SSQ_MEM_STATS *const charged  = ssq_mem_charge(querier->mem);
+    uint8_t       *const response = ssq_query_exchange(querier, payload, payload_len, deadline, response_len);
+    ssq_mem_charge(charged);
 
-    ssq_query_send(sockfd, payload, payload_len, &(querier->err));
-    if (!ssq_ok(querier)) goto end;
+    return response;
+}
 
-    uint8_t            packet_count = 0;
-    SSQ_PACKET **const packets      = ssq_query_recv(sockfd, &packet_count, &(querier->err));
-    if (!ssq_ok(querier)) goto end;
+uint8_t *ssq_query_challenge(
+    SSQ_QUERIER        *const querier,
+    const SSQ_PAYLOAD_BUILDER build_payload,
+    size_t             *const response_len
+) {
+    const int64_t deadline = ssq_query_deadline(querier);
+
+    uint8_t payload[SSQ_QUERY_PAYLOAD_SIZE];
+    size_t  payload_len = build_payload(payload, querier->chall);
+
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(querier->mem);
 
-    const SSQ_PACKET *const *const packets_readonly = (const SSQ_PACKET *const *)packets;
+    uint8_t *response = ssq_query_exchange(querier, payload, payload_len, deadline, response_len);
 
-    if (ssq_packets_verify_integrity(packets_readonly, packet_count))
-        response = ssq_packets_to_response(packets_readonly, packet_count, response_len, &(querier->err));
-    else
-        ssq_error_set(&(querier->err), SSQ_ERR_BADRES, "Packet IDs mismatch");
+    for (uint8_t challenges = 0; ssq_ok(querier) && ssq_response_has_challenge(response, *response_len); ++challenges) {
+        querier->chall = ssq_response_get_challenge(response, *response_len);
+        ssq_mem_free(response);
+        response = NULL;
+
+        if (challenges == querier->max_challenges) {
+            ssq_error_set(&(querier->err), SSQ_ERR_BADRES, "Too many challenges");
+            break;
+        }
 
-    ssq_packets_free(packets, packet_count);
+        payload_len = build_payload(payload, querier->chall);
+        response    = ssq_query_exchange(querier, payload, payload_len, deadline, response_len);
+    }
 
-end:
-    closesocket(sockfd);
+    ssq_mem_charge(charged);
 
     return response;
 }
+
+/**
+ * Finds the reassembly a packet of a multi-packet response goes to in a pipeline, from its response ID.
+ *
+ * @param reassemblies reassemblies of the pipeline
+ * @param id           response ID of the packet
+ *
+ * @return reassembly of the response, a free one if the response is new, or NULL if none is free
+ */
+static SSQ_REASSEMBLY *ssq_query_pipeline_reassembly(SSQ_REASSEMBLY reassemblies[SSQ_QUERY_PIPELINE_REASSEMBLIES], const int32_t id) {
+    SSQ_REASSEMBLY *free_reassembly = NULL;
+
+    for (size_t i = 0; i < SSQ_QUERY_PIPELINE_REASSEMBLIES; ++i) {
+        if (reassemblies[i].buf == NULL) {
+            if (free_reassembly == NULL)
+                free_reassembly = &(reassemblies[i]);
+        } else if (reassemblies[i].id == id) {
+            return &(reassemblies[i]);
+        }
+    }
+
+    return free_reassembly;
+}
+
+/**
+ * Handles a datagram received in a pipeline. A single-packet response is returned as is, while a packet
+ * of a multi-packet response is added to the reassembly of its response ID, which is returned once complete.
+ *
+ * @param reassemblies reassemblies of the pipeline
+ * @param datagram     datagram received
+ * @param datagram_len length of the datagram
+ * @param response_len where to store the length of the response
+ * @param err          where to report potential errors
+ *
+ * @return dynamically-allocated response if the datagram completes one, or else NULL
+ */
+static uint8_t *ssq_query_pipeline_on_datagram(
+    SSQ_REASSEMBLY   reassemblies[SSQ_QUERY_PIPELINE_REASSEMBLIES],
+    const uint8_t    datagram[],
+    const size_t     datagram_len,
+    size_t    *const response_len,
+    SSQ_ERROR *const err
+) {
+    if (ssq_response_is_truncated(datagram, datagram_len)) {
+        uint8_t *const response = ssq_mem_alloc(datagram_len);
+
+        if (response == NULL) {
+            ssq_error_set_from_errno(err);
+            return NULL;
+        }
+
+        memcpy(response, datagram, datagram_len);
+        *response_len = datagram_len;
+
+        return response;
+    }
+
+    SSQ_BUF datagram_buf = ssq_buf_init(datagram, datagram_len);
+
+    if (ssq_buf_get_int32(&datagram_buf) != (int32_t)A2S_PACKET_HEADER_MULTI) {
+        ssq_error_set(err, SSQ_ERR_BADRES, "Invalid packet header");
+        return NULL;
+    }
+
+    // The packets of a response which has no free reassembly left, such as a duplicate one, are dropped.
+    SSQ_REASSEMBLY *const reassembly = ssq_query_pipeline_reassembly(reassemblies, ssq_buf_get_int32(&datagram_buf));
+
+    if (reassembly == NULL || !ssq_reassembly_add(reassembly, datagram, (uint16_t)datagram_len, err))
+        return NULL;
+
+    uint8_t *const response = ssq_reassembly_release(reassembly, response_len, err);
+    ssq_reassembly_init(reassembly);
+
+    return response;
+}
+
+/**
+ * Sends the queries of a pipeline which were not answered yet along with the last challenge of the querier,
+ * unless they were already sent with it.
+ *
+ * @param querier        Source server querier to use
+ * @param build_payloads functions building the payload of each query from a challenge
+ * @param responses      response to each query, NULL if not received yet
+ * @param challs         challenge each query was last sent with, updated
+ * @param query_count    number of queries
+ * @param resend         whether to send again the queries already sent with the last challenge
+ *
+ * @return true if any query was sent
+ */
+static bool ssq_query_pipeline_send(
+    SSQ_QUERIER        *const querier,
+    const SSQ_PAYLOAD_BUILDER build_payloads[],
+    uint8_t            *const responses[],
+    int32_t                   challs[],
+    const size_t              query_count,
+    const bool                resend
+) {
+    bool sent = false;
+
+    for (size_t i = 0; i < query_count && ssq_ok(querier); ++i) {
+        if (responses[i] != NULL || (challs[i] == querier->chall && !resend))
+            continue;
+
+        uint8_t      payload[SSQ_QUERY_PAYLOAD_SIZE];
+        const size_t payload_len = build_payloads[i](payload, querier->chall);
+
+        ssq_query_send(querier->sockfd, payload, payload_len, &(querier->err));
+
+        challs[i] = querier->chall;
+        sent      = true;
+    }
+
+    return sent;
+}
+
+void ssq_query_pipeline(
+    SSQ_QUERIER        *const querier,
+    const SSQ_PAYLOAD_BUILDER build_payloads[],
+    const uint8_t             response_headers[],
+    const size_t              query_count,
+    uint8_t                  *responses[],
+    size_t                    response_lens[]
+) {
+    const int64_t deadline     = ssq_query_deadline(querier);
+    const int64_t timeout_recv = ssq_query_timeout_recv_ms(querier);
+
+    int32_t        challs[SSQ_QUERY_PIPELINE_MAX];
+    SSQ_REASSEMBLY reassemblies[SSQ_QUERY_PIPELINE_REASSEMBLIES];
+
+    for (size_t i = 0; i < query_count; ++i) {
+        responses[i] = NULL;
+        challs[i]    = A2S_CHALLENGE_NONE;
+    }
+
+    for (size_t i = 0; i < SSQ_QUERY_PIPELINE_REASSEMBLIES; ++i)
+        ssq_reassembly_init(&(reassemblies[i]));
+
+    ssq_query_prepare_socket(querier);
+    if (!ssq_ok(querier)) return;
+
+    const SOCKET         sockfd  = querier->sockfd;
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(querier->mem);
+
+    ssq_query_drain(sockfd);
+
+    ssq_query_pipeline_send(querier, build_payloads, responses, challs, query_count, true);
+
+    size_t  pending    = query_count;
+    uint8_t attempt    = 1;
+    uint8_t challenges = 0;
+    int64_t sent_at    = ssq_helper_now_ms(); // when the queries were last sent
+    int64_t heard_at   = sent_at;             // when the queries were last sent or a datagram last came
+    bool    measured   = false;               // whether the round trip of the queries last sent was measured
+
+    while (pending != 0 && ssq_ok(querier)) {
+        int64_t wait_until = deadline;
+
+        // The queries still pending are sent again once the server stays silent for the retransmission timeout.
+        if (attempt < querier->max_attempts) {
+            const int64_t rto_at = heard_at + ssq_rtt_rto(&(querier->rtt), attempt - 1);
+
+            if (rto_at < wait_until)
+                wait_until = rto_at;
+        }
+
+        ssq_query_wait(sockfd, wait_until, timeout_recv, &(querier->err));
+
+        if (!ssq_ok(querier)) {
+            if (attempt >= querier->max_attempts || ssq_errc(querier) != SSQ_ERR_TIMEOUT || ssq_helper_now_ms() >= deadline)
+                break;
+
+            ssq_errclr(querier);
+            ssq_query_pipeline_send(querier, build_payloads, responses, challs, query_count, true);
+
+            ++attempt;
+            sent_at  = ssq_helper_now_ms();
+            heard_at = sent_at;
+            continue;
+        }
+
+        heard_at = ssq_helper_now_ms();
+
+        // Karn's algorithm: the reply to a retransmitted query may answer any of its attempts.
+        if (!measured && attempt == 1)
+            ssq_rtt_sample(&(querier->rtt), heard_at - sent_at);
+
+        measured = true;
+
+        uint8_t      datagram[SSQ_PACKET_SIZE];
+        const size_t datagram_len = ssq_query_read_datagram(sockfd, datagram, &(querier->err));
+        if (!ssq_ok(querier)) break;
+
+        if (ssq_response_is_truncated(datagram, datagram_len) && ssq_response_has_challenge(datagram, datagram_len)) {
+            // The challenge is the same for all of the queries, so each of them is sent again once at most per new challenge.
+            const int32_t chall = ssq_response_get_challenge(datagram, datagram_len);
+
+            if (chall != querier->chall) {
+                if (challenges++ == querier->max_challenges) {
+                    ssq_error_set(&(querier->err), SSQ_ERR_BADRES, "Too many challenges");
+                    break;
+                }
+
+                querier->chall = chall;
+            }
+
+            if (ssq_query_pipeline_send(querier, build_payloads, responses, challs, query_count, false)) {
+                attempt  = 1;
+                sent_at  = ssq_helper_now_ms();
+                heard_at = sent_at;
+                measured = false;
+            }
+
+            continue;
+        }
+
+        size_t   response_len = 0;
+        uint8_t *response     = ssq_query_pipeline_on_datagram(reassemblies, datagram, datagram_len, &response_len, &(querier->err));
+
+        if (response == NULL)
+            continue;
+
+        const uint8_t header = ssq_response_get_header(response, response_len);
+
+        for (size_t i = 0; i < query_count && response != NULL; ++i) {
+            if (responses[i] == NULL && response_headers[i] == header) {
+                responses[i]     = response;
+                response_lens[i] = response_len;
+                response         = NULL;
+                --pending;
+            }
+        }
+
+        // A response to no pending query, such as a duplicate one.
+        ssq_mem_free(response);
+    }
+
+    for (size_t i = 0; i < SSQ_QUERY_PIPELINE_REASSEMBLIES; ++i)
+        ssq_reassembly_free(&(reassemblies[i]));
+
+    if (!ssq_ok(querier)) {
+        for (size_t i = 0; i < query_count; ++i) {
+            ssq_mem_free(responses[i]);
+            responses[i] = NULL;
+        }
+    }
+
+    ssq_mem_charge(charged);
+}
+
+void ssq_query_close(SSQ_QUERIER *const querier) {
+    if (querier->sockfd != INVALID_SOCKET) {
+        closesocket(querier->sockfd);
+        querier->sockfd = INVALID_SOCKET;
+    }
+}
@@ -0,0 +1,284 @@
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+# include <windows.h>
+#else /* not _WIN32 */
+# include <arpa/inet.h>
+# include <netinet/in.h>
+# include <pthread.h>
+#endif /* _WIN32 */
+
+#include "ssq/helper.h"
+#include "ssq/mem.h"
+#include "ssq/resolve.h"
+
+typedef struct ssq_resolve_entry {
+    char            *hostname;   /** Hostname, or NULL if the entry is free         */
+    struct addrinfo *addr_list;  /** Addresses of the hostname, with no port number */
+    int64_t          expires_at; /** Monotonic time at which the addresses go stale */
+} SSQ_RESOLVE_ENTRY;
+
+// The entries outlive the queriers, so they are allocated with libc rather than with the allocator of the library,
+// which may be replaced or start accounting once no querier is left.
+static SSQ_RESOLVE_ENTRY g_cache[SSQ_RESOLVE_CACHE_SIZE];
+static int64_t           g_cache_ttl = SSQ_RESOLVE_CACHE_TTL_DEFAULT_VALUE;
+
+#ifdef _WIN32
+static SRWLOCK g_cache_lock = SRWLOCK_INIT;
+
+static inline void ssq_resolve_lock(void) { AcquireSRWLockExclusive(&g_cache_lock); }
+static inline void ssq_resolve_unlock(void) { ReleaseSRWLockExclusive(&g_cache_lock); }
+#else /* not _WIN32 */
+static pthread_mutex_t g_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline void ssq_resolve_lock(void) { pthread_mutex_lock(&g_cache_lock); }
+static inline void ssq_resolve_unlock(void) { pthread_mutex_unlock(&g_cache_lock); }
+#endif /* _WIN32 */
+
+/**
+ * Sets the port number of an address.
+ *
+ * @param addr address
+ * @param port port number
+ */
+static void ssq_resolve_set_port(struct addrinfo *const addr, const uint16_t port) {
+    if (addr->ai_family == AF_INET)
+        ((struct sockaddr_in *)addr->ai_addr)->sin_port = htons(port);
+    else if (addr->ai_family == AF_INET6)
+        ((struct sockaddr_in6 *)addr->ai_addr)->sin6_port = htons(port);
+}
+
+/**
+ * Copies a list of addresses and sets their port number.
+ * The nodes of the copy and their addresses are held by a single allocation.
+ *
+ * @param src    list of addresses to copy
+ * @param port   port number to set
+ * @param cached true to allocate the copy with libc, for the cache
+ *
+ * @return dynamically-allocated copy of the list, or NULL if it is empty or in case of a memory allocation failure
+ */
+static struct addrinfo *ssq_resolve_copy(const struct addrinfo *const src, const uint16_t port, const bool cached) {
+    size_t count = 0;
+
+    for (const struct addrinfo *addr = src; addr != NULL; addr = addr->ai_next)
+        if (addr->ai_addrlen <= sizeof (struct sockaddr_storage))
+            ++count;
+
+    if (count == 0)
+        return NULL;
+
+    const size_t           size = count * (sizeof (struct addrinfo) + sizeof (struct sockaddr_storage));
+    struct addrinfo *const dst  = cached ? malloc(size) : ssq_mem_alloc(size);
+
+    if (dst == NULL)
+        return NULL;
+
+    struct sockaddr_storage *const storage = (struct sockaddr_storage *)(dst + count);
+
+    size_t i = 0;
+
+    for (const struct addrinfo *addr = src; addr != NULL; addr = addr->ai_next) {
+        if (addr->ai_addrlen > sizeof (struct sockaddr_storage))
+            continue;
+
+        struct addrinfo *const node = &(dst[i]);
+        memset(node, 0, sizeof (*node));
+
+        memcpy(&(storage[i]), addr->ai_addr, addr->ai_addrlen);
+
+        node->ai_family   = addr->ai_family;
+        node->ai_socktype = addr->ai_socktype;
+        node->ai_protocol = addr->ai_protocol;
+        node->ai_addrlen  = addr->ai_addrlen;
+        node->ai_addr     = (struct sockaddr *)&(storage[i]);
+        node->ai_next     = (i + 1 < count) ? &(dst[i + 1]) : NULL;
+
+        ssq_resolve_set_port(node, port);
+        ++i;
+    }
+
+    return dst;
+}
+
+/**
+ * Parses a numeric host, without calling the resolver.
+ *
+ * @param hostname  target hostname
+ * @param port      target port number
+ * @param addr_list where to store the dynamically-allocated list holding the address of the host
+ *
+ * @return true if the host is numeric
+ */
+static bool ssq_resolve_numeric(const char hostname[], const uint16_t port, struct addrinfo **const addr_list) {
+    struct sockaddr_storage addr;
+    memset(&addr, 0, sizeof (addr));
+
+    struct addrinfo node;
+    memset(&node, 0, sizeof (node));
+
+    struct sockaddr_in  *const addr4 = (struct sockaddr_in *)&addr;
+    struct sockaddr_in6 *const addr6 = (struct sockaddr_in6 *)&addr;
+
+    if (inet_pton(AF_INET, hostname, &(addr4->sin_addr)) == 1) {
+        addr4->sin_family = AF_INET;
+        node.ai_family    = AF_INET;
+        node.ai_addrlen   = sizeof (*addr4);
+    } else if (inet_pton(AF_INET6, hostname, &(addr6->sin6_addr)) == 1) {
+        addr6->sin6_family = AF_INET6;
+        node.ai_family     = AF_INET6;
+        node.ai_addrlen    = sizeof (*addr6);
+    } else {
+        return false;
+    }
+
+    node.ai_socktype = SOCK_DGRAM;
+    node.ai_protocol = IPPROTO_UDP;
+    node.ai_addr     = (struct sockaddr *)&addr;
+
+    *addr_list = ssq_resolve_copy(&node, port, false);
+
+    return true;
+}
+
+/**
+ * FNV-1a hash of a hostname.
+ * @param hostname hostname
+ * @return index of the hostname's entry in the cache
+ */
+static size_t ssq_resolve_cache_index(const char hostname[]) {
+    uint32_t hash = 2166136261U;
+
+    for (const char *c = hostname; *c != '\0'; ++c)
+        hash = (hash ^ (uint8_t)*c) * 16777619U;
+
+    return hash % SSQ_RESOLVE_CACHE_SIZE;
+}
+
+static void ssq_resolve_entry_clear(SSQ_RESOLVE_ENTRY *const entry) {
+    free(entry->hostname);
+    free(entry->addr_list);
+    memset(entry, 0, sizeof (*entry));
+}
+
+/**
+ * Looks up the addresses of a hostname in the cache.
+ *
+ * @param hostname  target hostname
+ * @param port      target port number
+ * @param addr_list where to store the dynamically-allocated list of the addresses of the target
+ *
+ * @return true if the addresses of the hostname were in the cache
+ */
+static bool ssq_resolve_cache_get(const char hostname[], const uint16_t port, struct addrinfo **const addr_list) {
+    bool found = false;
+
+    ssq_resolve_lock();
+
+    SSQ_RESOLVE_ENTRY *const entry = &(g_cache[ssq_resolve_cache_index(hostname)]);
+
+    if (entry->hostname != NULL && strcmp(entry->hostname, hostname) == 0) {
+        if (entry->expires_at > ssq_helper_now_ms()) {
+            *addr_list = ssq_resolve_copy(entry->addr_list, port, false);
+            found      = true;
+        } else {
+            ssq_resolve_entry_clear(entry);
+        }
+    }
+
+    ssq_resolve_unlock();
+
+    return found;
+}
+
+/**
+ * Keeps the addresses of a hostname in the cache, in place of the hostname sharing its entry if any.
+ * Nothing is kept if the cache is disabled or short of memory.
+ *
+ * @param hostname  hostname
+ * @param addr_list addresses of the hostname
+ */
+static void ssq_resolve_cache_put(const char hostname[], const struct addrinfo *const addr_list) {
+    ssq_resolve_lock();
+
+    if (g_cache_ttl > 0) {
+        SSQ_RESOLVE_ENTRY *const entry = &(g_cache[ssq_resolve_cache_index(hostname)]);
+        ssq_resolve_entry_clear(entry);
+
+        const size_t hostname_size = strlen(hostname) + 1;
+
+        entry->hostname  = malloc(hostname_size);
+        entry->addr_list = ssq_resolve_copy(addr_list, 0, true);
+
+        if (entry->hostname != NULL && entry->addr_list != NULL) {
+            memcpy(entry->hostname, hostname, hostname_size);
+            entry->expires_at = ssq_helper_now_ms() + g_cache_ttl;
+        } else {
+            ssq_resolve_entry_clear(entry);
+        }
+    }
+
+    ssq_resolve_unlock();
+}
+
+bool ssq_resolve_cached(const char hostname[], const uint16_t port, struct addrinfo **const addr_list, SSQ_ERROR *const err) {
+    *addr_list = NULL;
+
+    if (!ssq_resolve_numeric(hostname, port, addr_list) && !ssq_resolve_cache_get(hostname, port, addr_list))
+        return false;
+
+    if (*addr_list == NULL)
+        ssq_error_set_from_errno(err);
+
+    return true;
+}
+
+struct addrinfo *ssq_resolve(const char hostname[], const uint16_t port, SSQ_ERROR *const err) {
+    struct addrinfo *addr_list = NULL;
+
+    if (ssq_resolve_cached(hostname, port, &addr_list, err))
+        return addr_list;
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof (hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    struct addrinfo *result     = NULL;
+    const int        gai_errnum = getaddrinfo(hostname, NULL, &hints, &result);
+
+    if (gai_errnum != 0) {
+        ssq_error_set(err, SSQ_ERR_SYS, gai_strerror(gai_errnum));
+        return NULL;
+    }
+
+    ssq_resolve_cache_put(hostname, result);
+
+    addr_list = ssq_resolve_copy(result, port, false);
+    freeaddrinfo(result);
+
+    if (addr_list == NULL)
+        ssq_error_set_from_errno(err);
+
+    return addr_list;
+}
+
+void ssq_resolve_free(struct addrinfo *const addr_list) {
+    ssq_mem_free(addr_list);
+}
+
+void ssq_resolve_set_cache_ttl(const int64_t ttl_ms) {
+    ssq_resolve_lock();
+    g_cache_ttl = ttl_ms;
+    ssq_resolve_unlock();
+}
+
+void ssq_resolve_clear_cache(void) {
+    ssq_resolve_lock();
+
+    for (size_t i = 0; i < SSQ_RESOLVE_CACHE_SIZE; ++i)
+        ssq_resolve_entry_clear(&(g_cache[i]));
+
+    ssq_resolve_unlock();
+}
@@ -0,0 +1,225 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "ssq/mem.h"
+#include "ssq/resolver.h"
+
+typedef struct ssq_resolver_job {
+    char                    *hostname;
+    uint16_t                 port;
+    SSQ_RESOLVER_RESULT      result;
+    struct ssq_resolver_job *next;
+} SSQ_RESOLVER_JOB;
+
+typedef struct ssq_resolver_queue {
+    SSQ_RESOLVER_JOB *head;
+    SSQ_RESOLVER_JOB *tail;
+} SSQ_RESOLVER_QUEUE;
+
+struct ssq_resolver {
+    pthread_mutex_t    lock;
+    pthread_cond_t     submitted;    /** Signaled when a target is submitted or the resolver stops */
+    pthread_t         *threads;
+    size_t             thread_count; /** Number of worker threads running                          */
+    bool               stopping;     /** Whether the worker threads must stop                      */
+    SSQ_RESOLVER_QUEUE pending;      /** Targets waiting for a worker thread                       */
+    SSQ_RESOLVER_QUEUE done;         /** Resolutions waiting to be polled                          */
+    int                eventfd;      /** Readable while resolutions wait to be polled              */
+};
+
+static void ssq_resolver_queue_push(SSQ_RESOLVER_QUEUE *const queue, SSQ_RESOLVER_JOB *const job) {
+    job->next = NULL;
+
+    if (queue->tail != NULL)
+        queue->tail->next = job;
+    else
+        queue->head = job;
+
+    queue->tail = job;
+}
+
+static SSQ_RESOLVER_JOB *ssq_resolver_queue_pop(SSQ_RESOLVER_QUEUE *const queue) {
+    SSQ_RESOLVER_JOB *const job = queue->head;
+
+    if (job != NULL) {
+        queue->head = job->next;
+
+        if (queue->head == NULL)
+            queue->tail = NULL;
+    }
+
+    return job;
+}
+
+static void ssq_resolver_job_free(SSQ_RESOLVER_JOB *const job) {
+    ssq_mem_free(job->hostname);
+    ssq_mem_free(job);
+}
+
+static void *ssq_resolver_run(void *const arg) {
+    SSQ_RESOLVER *const resolver = arg;
+
+    pthread_mutex_lock(&(resolver->lock));
+
+    for (;;) {
+        while (!resolver->stopping && resolver->pending.head == NULL)
+            pthread_cond_wait(&(resolver->submitted), &(resolver->lock));
+
+        if (resolver->stopping)
+            break;
+
+        SSQ_RESOLVER_JOB *const job = ssq_resolver_queue_pop(&(resolver->pending));
+
+        // The resolver may block for long, other targets being resolved meanwhile.
+        pthread_mutex_unlock(&(resolver->lock));
+
+        ssq_error_clear(&(job->result.err));
+        job->result.addr_list = ssq_resolve(job->hostname, job->port, &(job->result.err));
+
+        pthread_mutex_lock(&(resolver->lock));
+
+        ssq_resolver_queue_push(&(resolver->done), job);
+
+        const uint64_t one = 1;
+        while (write(resolver->eventfd, &one, sizeof (one)) == -1 && errno == EINTR)
+            continue;
+    }
+
+    pthread_mutex_unlock(&(resolver->lock));
+
+    return NULL;
+}
+
+SSQ_RESOLVER *ssq_resolver_init(const size_t thread_count, SSQ_ERROR *const err) {
+    SSQ_RESOLVER *const resolver = ssq_mem_calloc(1, sizeof (*resolver));
+
+    if (resolver == NULL) {
+        ssq_error_set_from_errno(err);
+        return NULL;
+    }
+
+    pthread_mutex_init(&(resolver->lock), NULL);
+    pthread_cond_init(&(resolver->submitted), NULL);
+
+    resolver->eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    resolver->threads = ssq_mem_alloc(thread_count * sizeof (*(resolver->threads)));
+
+    if (resolver->eventfd == -1 || resolver->threads == NULL) {
+        ssq_error_set_from_errno(err);
+        ssq_resolver_free(resolver, NULL);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        const int errnum = pthread_create(&(resolver->threads[i]), NULL, ssq_resolver_run, resolver);
+
+        if (errnum != 0) {
+            ssq_error_set(err, SSQ_ERR_SYS, strerror(errnum));
+            ssq_resolver_free(resolver, NULL);
+            return NULL;
+        }
+
+        ++(resolver->thread_count);
+    }
+
+    return resolver;
+}
+
+void ssq_resolver_free(SSQ_RESOLVER *const resolver, void (*const drop)(void *user_data)) {
+    pthread_mutex_lock(&(resolver->lock));
+    resolver->stopping = true;
+    pthread_cond_broadcast(&(resolver->submitted));
+    pthread_mutex_unlock(&(resolver->lock));
+
+    for (size_t i = 0; i < resolver->thread_count; ++i)
+        pthread_join(resolver->threads[i], NULL);
+
+    SSQ_RESOLVER_JOB *job;
+
+    while ((job = ssq_resolver_queue_pop(&(resolver->pending))) != NULL) {
+        if (drop != NULL)
+            drop(job->result.user_data);
+
+        ssq_resolver_job_free(job);
+    }
+
+    while ((job = ssq_resolver_queue_pop(&(resolver->done))) != NULL) {
+        if (drop != NULL)
+            drop(job->result.user_data);
+
+        ssq_resolve_free(job->result.addr_list);
+        ssq_resolver_job_free(job);
+    }
+
+    if (resolver->eventfd != -1)
+        close(resolver->eventfd);
+
+    pthread_cond_destroy(&(resolver->submitted));
+    pthread_mutex_destroy(&(resolver->lock));
+    ssq_mem_free(resolver->threads);
+    ssq_mem_free(resolver);
+}
+
+void ssq_resolver_submit(
+    SSQ_RESOLVER *const resolver,
+    const char          hostname[],
+    const uint16_t      port,
+    void         *const user_data,
+    SSQ_ERROR    *const err
+) {
+    SSQ_RESOLVER_JOB *const job = ssq_mem_calloc(1, sizeof (*job));
+
+    if (job == NULL) {
+        ssq_error_set_from_errno(err);
+        return;
+    }
+
+    const size_t hostname_size = strlen(hostname) + 1;
+    job->hostname = ssq_mem_alloc(hostname_size);
+
+    if (job->hostname == NULL) {
+        ssq_error_set_from_errno(err);
+        ssq_mem_free(job);
+        return;
+    }
+
+    memcpy(job->hostname, hostname, hostname_size);
+
+    job->port             = port;
+    job->result.user_data = user_data;
+
+    pthread_mutex_lock(&(resolver->lock));
+    ssq_resolver_queue_push(&(resolver->pending), job);
+    pthread_cond_signal(&(resolver->submitted));
+    pthread_mutex_unlock(&(resolver->lock));
+}
+
+int ssq_resolver_fd(const SSQ_RESOLVER *const resolver) {
+    return resolver->eventfd;
+}
+
+bool ssq_resolver_poll(SSQ_RESOLVER *const resolver, SSQ_RESOLVER_RESULT *const result) {
+    pthread_mutex_lock(&(resolver->lock));
+
+    SSQ_RESOLVER_JOB *const job = ssq_resolver_queue_pop(&(resolver->done));
+
+    // Resets the event once the last resolution is taken, the worker threads signaling under the lock.
+    if (job != NULL && resolver->done.head == NULL) {
+        uint64_t count;
+        while (read(resolver->eventfd, &count, sizeof (count)) == -1 && errno == EINTR)
+            continue;
+    }
+
+    pthread_mutex_unlock(&(resolver->lock));
+
+    if (job == NULL)
+        return false;
+
+    *result = job->result;
+    ssq_resolver_job_free(job);
+
+    return true;
+}
@@ -2,15 +2,25 @@
 #include "ssq/packet.h"
 #include "ssq/response.h"
 
+uint8_t ssq_response_get_header(const uint8_t response[], size_t response_len) {
+    SSQ_BUF buf = ssq_buf_init(response, response_len);
+
+    if (ssq_response_is_truncated(response, response_len))
+        ssq_buf_forward(&buf, 4);
+
+    return ssq_buf_get_uint8(&buf);
+}
+
 bool ssq_response_has_challenge(const uint8_t response[], size_t response_len) {
-    SSQ_BUF       buf    = ssq_buf_init(response, response_len);
-    const uint8_t header = ssq_buf_get_uint8(&buf);
-    return header == S2A_HEADER_CHALL;
+    return ssq_response_get_header(response, response_len) == S2A_HEADER_CHALL;
 }
 
 int32_t ssq_response_get_challenge(const uint8_t response[], size_t response_len) {
     SSQ_BUF buf = ssq_buf_init(response, response_len);
 
+    if (ssq_response_is_truncated(response, response_len))
+        ssq_buf_forward(&buf, 4);
+
     ssq_buf_forward(&buf, 1); // skip header
     const int32_t chall = ssq_buf_get_int32(&buf);
 
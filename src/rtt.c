@@ -0,0 +1,46 @@
+#include "ssq/rtt.h"
+
+void ssq_rtt_init(SSQ_RTT *const rtt) {
+    rtt->srtt     = 0;
+    rtt->rttvar   = 0;
+    rtt->measured = false;
+}
+
+void ssq_rtt_sample(SSQ_RTT *const rtt, int64_t sample_ms) {
+    if (sample_ms < 0)
+        sample_ms = 0;
+
+    if (!rtt->measured) {
+        rtt->srtt     = sample_ms << 3;
+        rtt->rttvar   = sample_ms << 1; // half of the first sample
+        rtt->measured = true;
+        return;
+    }
+
+    // srtt += (sample - srtt) / 8, rttvar += (|sample - srtt| - rttvar) / 4, in their own scales.
+    int64_t delta = sample_ms - (rtt->srtt >> 3);
+    rtt->srtt += delta;
+
+    if (delta < 0)
+        delta = -delta;
+
+    rtt->rttvar += delta - (rtt->rttvar >> 2);
+}
+
+int64_t ssq_rtt_rto(const SSQ_RTT *const rtt, const uint8_t attempt) {
+    int64_t rto = SSQ_RTT_RTO_INITIAL;
+
+    if (rtt->measured)
+        rto = (rtt->srtt >> 3) + ((rtt->rttvar > 1) ? rtt->rttvar : 1);
+
+    if (rto < SSQ_RTT_RTO_MIN)
+        rto = SSQ_RTT_RTO_MIN;
+
+    for (uint8_t i = 0; i < attempt && rto < SSQ_RTT_RTO_MAX; ++i)
+        rto *= 2;
+
+    if (rto > SSQ_RTT_RTO_MAX)
+        rto = SSQ_RTT_RTO_MAX;
+
+    return rto;
+}
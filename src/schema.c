@@ -0,0 +1,98 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "ssq/schema.h"
+
+/**
+ * Finds the character read for a value stored in an `SSQ_FIELD_CHAR' field.
+ *
+ * @param map   value stored for each character read
+ * @param value value stored
+ *
+ * @return first character read for the value, or `SSQ_FIELD_CHAR_UNKNOWN'
+ */
+static uint8_t ssq_schema_char_encode(const char map[], const int value) {
+    for (unsigned c = 1; c <= UINT8_MAX; ++c) {
+        if (map[c] == value)
+            return (uint8_t)c;
+    }
+
+    return SSQ_FIELD_CHAR_UNKNOWN;
+}
+
+/**
+ * Appends bytes to an encoding, cutting them at the end of the buffer holding it.
+ *
+ * @param dst      encoding, or NULL
+ * @param dst_size number of bytes the encoding can hold
+ * @param len      length of the encoding so far, increased by N
+ * @param src      bytes to append
+ * @param n        number of bytes to append
+ */
+static void ssq_schema_put(uint8_t dst[], const size_t dst_size, size_t *const len, const void *const src, const size_t n) {
+    if (dst != NULL && *len < dst_size && n != 0)
+        memcpy(dst + *len, src, (n <= dst_size - *len) ? n : dst_size - *len);
+
+    *len += n;
+}
+
+size_t ssq_schema_encode(
+    const SSQ_FIELD fields[],
+    const size_t    field_count,
+    const void     *src,
+    uint8_t         dst[],
+    const size_t    dst_size
+) {
+    const uint8_t *const base = src;
+
+    size_t  len = 0;
+    uint8_t edf = 0;
+
+    for (size_t i = 0; i < field_count; ++i) {
+        const SSQ_FIELD *const field = &(fields[i]);
+        const uint8_t   *const value = base + field->offset;
+
+        if (field->flag != 0 && !(edf & field->flag))
+            continue;
+
+        switch (field->type) {
+            case SSQ_FIELD_STRING: {
+                const SSQ_STRING_VIEW *const view = (const SSQ_STRING_VIEW *)value;
+                const uint8_t nul = '\0';
+
+                if (view->str != NULL)
+                    ssq_schema_put(dst, dst_size, &len, view->str, view->len);
+
+                ssq_schema_put(dst, dst_size, &len, &nul, sizeof (nul));
+                break;
+            }
+
+            // Without any flag, the EDF is left out as old servers do.
+            case SSQ_FIELD_EDF:
+                edf = *value;
+                if (edf == 0)
+                    return len;
+
+                ssq_schema_put(dst, dst_size, &len, &edf, sizeof (edf));
+                break;
+
+            case SSQ_FIELD_BOOL: {
+                const uint8_t b = *(const bool *)value ? 1 : 0;
+                ssq_schema_put(dst, dst_size, &len, &b, sizeof (b));
+                break;
+            }
+
+            case SSQ_FIELD_CHAR: {
+                const uint8_t c = ssq_schema_char_encode(field->map, *(const int *)value);
+                ssq_schema_put(dst, dst_size, &len, &c, sizeof (c));
+                break;
+            }
+
+            default:
+                ssq_schema_put(dst, dst_size, &len, value, ssq_schema_wire_size(field->type));
+                break;
+        }
+    }
+
+    return len;
+}
@@ -0,0 +1,87 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ssq/mem.h"
+#include "ssq/query.h"
+#include "ssq/snapshot.h"
+
+#define SSQ_SNAPSHOT_INFO        0
+#define SSQ_SNAPSHOT_PLAYER      1
+#define SSQ_SNAPSHOT_RULES       2
+#define SSQ_SNAPSHOT_QUERY_COUNT 3
+
+static const SSQ_PAYLOAD_BUILDER g_snapshot_payloads[SSQ_SNAPSHOT_QUERY_COUNT] = {
+    ssq_info_payload,
+    ssq_player_payload,
+    ssq_rules_payload
+};
+
+static const uint8_t g_snapshot_headers[SSQ_SNAPSHOT_QUERY_COUNT] = {
+    S2A_HEADER_INFO,
+    S2A_HEADER_PLAYER,
+    S2A_HEADER_RULES
+};
+
+SSQ_SNAPSHOT *ssq_snapshot(SSQ_QUERIER *const querier) {
+    uint8_t *responses[SSQ_SNAPSHOT_QUERY_COUNT];
+    size_t   response_lens[SSQ_SNAPSHOT_QUERY_COUNT];
+
+    ssq_query_pipeline(querier, g_snapshot_payloads, g_snapshot_headers, SSQ_SNAPSHOT_QUERY_COUNT, responses, response_lens);
+    if (!ssq_ok(querier)) return NULL;
+
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(querier->mem);
+
+    SSQ_SNAPSHOT *snapshot = ssq_mem_alloc(sizeof (*snapshot));
+
+    if (snapshot != NULL) {
+        memset(snapshot, 0, sizeof (*snapshot));
+
+        snapshot->info = ssq_info_deserialize(
+            responses[SSQ_SNAPSHOT_INFO],
+            response_lens[SSQ_SNAPSHOT_INFO],
+            &(querier->err)
+        );
+
+        if (ssq_ok(querier)) {
+            snapshot->players = ssq_player_deserialize(
+                responses[SSQ_SNAPSHOT_PLAYER],
+                response_lens[SSQ_SNAPSHOT_PLAYER],
+                &(snapshot->player_count),
+                &(querier->err)
+            );
+        }
+
+        if (ssq_ok(querier)) {
+            snapshot->rules = ssq_rules_deserialize(
+                responses[SSQ_SNAPSHOT_RULES],
+                response_lens[SSQ_SNAPSHOT_RULES],
+                &(snapshot->rule_count),
+                &(querier->err)
+            );
+        }
+
+        if (!ssq_ok(querier)) {
+            ssq_snapshot_free(snapshot);
+            snapshot = NULL;
+        }
+    } else {
+        ssq_error_set_from_errno(&(querier->err));
+    }
+
+    for (size_t i = 0; i < SSQ_SNAPSHOT_QUERY_COUNT; ++i)
+        ssq_mem_free(responses[i]);
+
+    ssq_mem_charge(charged);
+
+    return snapshot;
+}
+
+void ssq_snapshot_free(SSQ_SNAPSHOT *const snapshot) {
+    if (snapshot->info != NULL)
+        ssq_info_free(snapshot->info);
+    if (snapshot->players != NULL)
+        ssq_player_free(snapshot->players, snapshot->player_count);
+    if (snapshot->rules != NULL)
+        ssq_rules_free(snapshot->rules, snapshot->rule_count);
+
+    ssq_mem_free(snapshot);
+}
@@ -1,42 +1,51 @@
 #include <stdlib.h>
-#include <string.h>
 #include "ssq/ssq.h"
 #include "ssq/helper.h"
+#include "ssq/query.h"
+#include "ssq/resolve.h"
+#include "ssq/response.h"
 
 SSQ_QUERIER *ssq_init(void) {
-    SSQ_QUERIER *const querier = malloc(sizeof (*querier));
+    SSQ_QUERIER *const querier = ssq_mem_alloc(sizeof (*querier));
 
     if (querier != NULL) {
-        querier->addr_list = NULL;
+        querier->addr_list      = NULL;
+        querier->addr_preferred = NULL;
+        querier->sockfd         = SSQ_SOCKET_INVALID;
+        querier->chall          = A2S_CHALLENGE_NONE;
+        querier->mem            = NULL;
         ssq_errclr(querier);
         ssq_set_timeout(querier, SSQ_TIMEOUT_RECV, SSQ_TIMEOUT_RECV_DEFAULT_VALUE);
         ssq_set_timeout(querier, SSQ_TIMEOUT_SEND, SSQ_TIMEOUT_SEND_DEFAULT_VALUE);
+        ssq_set_timeout(querier, SSQ_TIMEOUT_QUERY, SSQ_TIMEOUT_QUERY_DEFAULT_VALUE);
+        ssq_set_max_challenges(querier, SSQ_MAX_CHALLENGES_DEFAULT_VALUE);
+        ssq_set_max_attempts(querier, SSQ_MAX_ATTEMPTS_DEFAULT_VALUE);
+        ssq_set_race(querier, SSQ_RACE_OFF, SSQ_RACE_STAGGER_DEFAULT_VALUE);
+        ssq_rtt_init(&(querier->rtt));
     }
 
     return querier;
 }
 
 void ssq_free(SSQ_QUERIER *const querier) {
-    freeaddrinfo(querier->addr_list);
-    free(querier);
+    ssq_query_close(querier);
+    ssq_resolve_free(querier->addr_list);
+    ssq_mem_free(querier);
 }
 
 void ssq_set_target(SSQ_QUERIER *const querier, const char hostname[], const uint16_t port) {
-    freeaddrinfo(querier->addr_list);
+    ssq_query_close(querier);
+    ssq_resolve_free(querier->addr_list);
 
-    char port_str[SSQ_PORT_SIZE] = { '\0' };
-    ssq_helper_port_to_str(port, port_str);
+    querier->addr_preferred = NULL;
+    querier->chall          = A2S_CHALLENGE_NONE;
+    ssq_rtt_init(&(querier->rtt));
 
-    struct addrinfo hints;
-    memset(&hints, 0, sizeof (hints));
-    hints.ai_family   = AF_INET;
-    hints.ai_socktype = SOCK_DGRAM;
+    SSQ_MEM_STATS *const charged = ssq_mem_charge(querier->mem);
 
-    const int gai_errnum = getaddrinfo(hostname, port_str, &hints, &(querier->addr_list));
-    if (gai_errnum != 0) {
-        querier->addr_list = NULL;
-        ssq_error_set(&(querier->err), SSQ_ERR_SYS, gai_strerror(gai_errnum));
-    }
+    querier->addr_list = ssq_resolve(hostname, port, &(querier->err));
+
+    ssq_mem_charge(charged);
 }
 
 void ssq_set_timeout(
@@ -53,12 +62,42 @@ void ssq_set_timeout(
         querier->timeout_recv = value_in_ms;
     if (which & SSQ_TIMEOUT_SEND)
         querier->timeout_send = value_in_ms;
+
+    if (which & SSQ_TIMEOUT_QUERY)
+        querier->timeout_query = (int64_t)value_in_ms;
 #else /* not _WIN32 */
+    // A negative timeout would make the socket fail, it is rather disabled like a timeout of 0.
+    const time_t value = (value_in_ms > 0) ? value_in_ms : 0;
+
     if (which & SSQ_TIMEOUT_RECV)
-        ssq_helper_ms_to_tv(value_in_ms, &(querier->timeout_recv));
+        ssq_helper_ms_to_tv(value, &(querier->timeout_recv));
     if (which & SSQ_TIMEOUT_SEND)
-        ssq_helper_ms_to_tv(value_in_ms, &(querier->timeout_send));
+        ssq_helper_ms_to_tv(value, &(querier->timeout_send));
+
+    if (which & SSQ_TIMEOUT_QUERY)
+        querier->timeout_query = (int64_t)value;
 #endif /* _WIN32 */
+
+    // Only the send timeout is applied to the socket, the waits for datagrams being bounded by `poll'.
+    if (which & SSQ_TIMEOUT_SEND)
+        querier->timeouts_changed = true;
+}
+
+void ssq_set_max_challenges(SSQ_QUERIER *const querier, const uint8_t max_challenges) {
+    querier->max_challenges = max_challenges;
+}
+
+void ssq_set_max_attempts(SSQ_QUERIER *const querier, const uint8_t max_attempts) {
+    querier->max_attempts = (max_attempts != 0) ? max_attempts : 1;
+}
+
+void ssq_set_race(SSQ_QUERIER *const querier, const SSQ_RACE race, const int64_t stagger_ms) {
+    querier->race         = race;
+    querier->race_stagger = (stagger_ms > 0) ? stagger_ms : 0;
+}
+
+void ssq_set_mem_stats(SSQ_QUERIER *const querier, SSQ_MEM_STATS *const stats) {
+    querier->mem = stats;
 }
 
 SSQ_ERROR_CODE ssq_errc(const SSQ_QUERIER *const querier) {
@@ -1,9 +1,36 @@
 #ifndef TEST_HELPER_H
 #define TEST_HELPER_H
 
+#include <pthread.h>
 #include <stddef.h>
 #include <stdint.h>
 
+#define RESPONDER_STEP_MAX    16
+#define RESPONDER_REQUEST_MAX 64
+
 uint8_t *read_datagram(const char *filename, size_t *datagram_len);
 
+/*
+ * UDP server listening on the loopback interface which answers the N-th request it
+ * receives with the datagrams of the N-th step (a NULL-terminated list of datagram
+ * files). A step with no datagram drops the request.
+ */
+typedef struct responder {
+    int                      sockfd;
+    uint16_t                 port;
+    pthread_t                thread;
+    const char *const       *steps[RESPONDER_STEP_MAX];
+    size_t                   step_count;
+    uint8_t                  requests[RESPONDER_STEP_MAX][RESPONDER_REQUEST_MAX];
+    size_t                   request_lens[RESPONDER_STEP_MAX];
+    size_t                   request_count;
+} RESPONDER;
+
+void responder_start(RESPONDER *responder, const char *const *const *steps, size_t step_count);
+
+/* Same as `responder_start', listening on the IPv6 loopback interface. */
+void responder_start6(RESPONDER *responder, const char *const *const *steps, size_t step_count);
+
+void responder_join(RESPONDER *responder);
+
 #endif /* TEST_HELPER_H */
@@ -1,4 +1,5 @@
 #include <criterion/criterion.h>
+#include <string.h>
 #include "helper.h"
 #include "ssq/a2s/info.h"
 #include "ssq/packet.h"
@@ -149,3 +150,238 @@ Test(a2s_info, bad_header) {
     ssq_packet_free(packet);
     free(response);
 }
+
+Test(a2s_info, view) {
+    size_t   datagram_len;
+    uint8_t *datagram = read_datagram("dgram/info/tf2.bin", &datagram_len);
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_PACKET *packet = ssq_packet_from_datagram(datagram, datagram_len, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(packet, NULL);
+
+    size_t   response_len;
+    uint8_t *response = ssq_packets_to_response((const SSQ_PACKET *const *)(&packet), 1, &response_len, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(response, NULL);
+
+    A2S_INFO_REF info;
+    cr_assert(ssq_info_deserialize_view(response, response_len, &info, &err));
+    cr_assert_eq(err.code, SSQ_OK);
+
+    // Borrowed from the response, where the strings are null-terminated.
+    cr_expect_geq((const uint8_t *)info.map.str, response);
+    cr_expect_lt((const uint8_t *)info.map.str, response + response_len);
+    cr_expect_str_eq(info.map.str, "pl_badwater_pro_v12_skial");
+    cr_expect_eq(info.map.len, 25);
+    cr_expect_str_eq(info.folder.str, "tf");
+    cr_expect_eq(info.id, 440);
+    cr_expect_eq(info.players, 32);
+    cr_expect_eq(info.vac, true);
+    cr_expect_str_eq(info.version.str, "7182415");
+    cr_expect_eq(info.edf, 0xB1);
+    cr_expect_eq(info.steamid, 85568392920040218);
+    cr_expect_eq(info.stv_name.str, NULL);
+    cr_expect_eq(info.keywords.len, 95);
+    cr_expect_eq(info.gameid, 440);
+
+    free(datagram);
+    ssq_packet_free(packet);
+    free(response);
+}
+
+Test(a2s_info, lazy_view) {
+    size_t   datagram_len;
+    uint8_t *datagram = read_datagram("dgram/info/tf2.bin", &datagram_len);
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    A2S_INFO_VIEW view;
+    cr_assert(ssq_info_view_open(datagram + 4, datagram_len - 4, &view, &err));
+    cr_assert_eq(err.code, SSQ_OK);
+
+    // Borrowed from the response, where the strings are null-terminated.
+    const SSQ_STRING_VIEW map = ssq_info_view_map(&view);
+    cr_expect_geq((const uint8_t *)map.str, datagram);
+    cr_expect_lt((const uint8_t *)map.str, datagram + datagram_len);
+    cr_expect_str_eq(map.str, "pl_badwater_pro_v12_skial");
+    cr_expect_eq(map.len, 25);
+
+    cr_expect_eq(ssq_info_view_protocol(&view), 17);
+    cr_expect_eq(ssq_info_view_name(&view).len, 62);
+    cr_expect_str_eq(ssq_info_view_folder(&view).str, "tf");
+    cr_expect_eq(ssq_info_view_game(&view).len, 19);
+    cr_expect_eq(ssq_info_view_id(&view), 440);
+    cr_expect_eq(ssq_info_view_players(&view), 32);
+    cr_expect_eq(ssq_info_view_max_players(&view), 32);
+    cr_expect_eq(ssq_info_view_bots(&view), 0);
+    cr_expect_eq(ssq_info_view_server_type(&view), A2S_SERVER_TYPE_DEDICATED);
+    cr_expect_eq(ssq_info_view_environment(&view), A2S_ENVIRONMENT_LINUX);
+    cr_expect_eq(ssq_info_view_visibility(&view), false);
+    cr_expect_eq(ssq_info_view_vac(&view), true);
+    cr_expect_str_eq(ssq_info_view_version(&view).str, "7182415");
+
+    // The EDF trailer is left alone until one of its fields is asked for.
+    cr_expect(!view.edf_decoded);
+    cr_expect_eq(ssq_info_view_keywords(&view).len, 95);
+    cr_expect(view.edf_decoded);
+    cr_expect_eq(ssq_info_view_edf(&view), 0xB1);
+    cr_expect_eq(ssq_info_view_port(&view), 27015);
+    cr_expect_eq(ssq_info_view_steamid(&view), 85568392920040218);
+    cr_expect_eq(ssq_info_view_stv_port(&view), 0);
+    cr_expect_eq(ssq_info_view_stv_name(&view).str, NULL);
+    cr_expect_eq(ssq_info_view_gameid(&view), 440);
+
+    // A response cut in its strings leaves the fields following them empty.
+    cr_assert(ssq_info_view_open(datagram + 4, 12, &view, &err));
+    cr_expect_eq(ssq_info_view_map(&view).len, 0);
+    cr_expect_eq(ssq_info_view_players(&view), 0);
+    cr_expect_eq(ssq_info_view_edf(&view), 0);
+    cr_expect_eq(ssq_info_view_keywords(&view).str, NULL);
+
+    const uint8_t bad_header[] = { S2A_HEADER_INFO + 1, 17 };
+    cr_expect(!ssq_info_view_open(bad_header, sizeof (bad_header), &view, &err));
+    cr_expect_eq(err.code, SSQ_ERR_BADRES);
+
+    free(datagram);
+}
+
+Test(a2s_info, into) {
+    size_t   css_len;
+    uint8_t *css = read_datagram("dgram/info/css.bin", &css_len);
+    size_t   tf2_len;
+    uint8_t *tf2 = read_datagram("dgram/info/tf2.bin", &tf2_len);
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    // The datagrams are single-packet responses, whose header comes right after the packet header.
+    A2S_INFO *info = ssq_info_deserialize_into(css + 4, css_len - 4, NULL, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(info, NULL);
+    cr_expect_str_eq(info->map, "de_dust");
+
+    info = ssq_info_deserialize_into(tf2 + 4, tf2_len - 4, info, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(info, NULL);
+    cr_expect_str_eq(info->map, "pl_badwater_pro_v12_skial");
+    cr_expect_eq(info->keywords_len, 95);
+
+    // The shorter strings fit in the memory of the previous result.
+    A2S_INFO *const reused = ssq_info_deserialize_into(css + 4, css_len - 4, info, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(reused, info);
+    cr_expect_str_eq(reused->name, "game2xs.com Counter-Strike Source #1");
+    cr_expect_str_eq(reused->version, "1.0.0.22");
+    cr_expect_eq(reused->edf, 0);
+    cr_expect_eq(reused->keywords, NULL);
+    cr_expect_eq(reused->keywords_len, 0);
+
+    // An invalid response leaves the previous result to the caller.
+    const uint8_t bad_header[] = { S2A_HEADER_INFO + 1, 17 };
+    cr_expect_eq(ssq_info_deserialize_into(bad_header, sizeof (bad_header), reused, &err), NULL);
+    cr_expect_eq(err.code, SSQ_ERR_BADRES);
+    cr_expect_str_eq(reused->map, "de_dust");
+
+    ssq_info_free(reused);
+    free(css);
+    free(tf2);
+}
+
+Test(a2s_info, ex) {
+    size_t   datagram_len;
+    uint8_t *datagram = read_datagram("dgram/info/tf2.bin", &datagram_len);
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    const uint32_t fields = A2S_INFO_FIELD_MAP | A2S_INFO_FIELD_PLAYERS | A2S_INFO_FIELD_MAX_PLAYERS | A2S_INFO_FIELD_STEAMID;
+
+    A2S_INFO *info = ssq_info_deserialize_ex(datagram + 4, datagram_len - 4, fields, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(info, NULL);
+
+    // The EDF comes along with the SteamID it flags.
+    cr_expect_eq(info->fields, fields | A2S_INFO_FIELD_EDF);
+    cr_expect_eq(info->edf, 0xB1);
+    cr_expect(ssq_info_has_steamid(info));
+
+    cr_expect_str_eq(info->map, "pl_badwater_pro_v12_skial");
+    cr_expect_eq(info->map_len, 25);
+    cr_expect_eq(info->players, 32);
+    cr_expect_eq(info->max_players, 32);
+    cr_expect_eq(info->steamid, 85568392920040218);
+
+    // The fields left out are skipped.
+    cr_expect_eq(info->protocol, 0);
+    cr_expect_eq(info->name, NULL);
+    cr_expect_eq(info->name_len, 0);
+    cr_expect_eq(info->id, 0);
+    cr_expect_eq(info->version, NULL);
+    cr_expect_eq(info->port, 0);
+    cr_expect_eq(info->keywords, NULL);
+    cr_expect_eq(info->gameid, 0);
+
+    ssq_info_free(info);
+
+    info = ssq_info_deserialize_ex(datagram + 4, datagram_len - 4, A2S_INFO_FIELD_KEYWORDS, &err);
+    cr_assert_neq(info, NULL);
+    cr_expect_eq(info->fields, A2S_INFO_FIELD_KEYWORDS | A2S_INFO_FIELD_EDF);
+    cr_expect(ssq_info_has_keywords(info));
+    cr_expect_eq(info->keywords_len, 95);
+    cr_expect_eq(info->steamid, 0);
+
+    ssq_info_free(info);
+
+    // Without any of the fields it flags, the EDF is left out as well.
+    info = ssq_info_deserialize_ex(datagram + 4, datagram_len - 4, A2S_INFO_FIELD_MAP, &err);
+    cr_assert_neq(info, NULL);
+    cr_expect_eq(info->fields, A2S_INFO_FIELD_MAP);
+    cr_expect_eq(info->edf, 0);
+
+    ssq_info_free(info);
+
+    info = ssq_info_deserialize(datagram + 4, datagram_len - 4, &err);
+    cr_assert_neq(info, NULL);
+    cr_expect_eq(info->fields, A2S_INFO_FIELD_ALL);
+
+    ssq_info_free(info);
+    free(datagram);
+}
+
+Test(a2s_info, serialize) {
+    static const char *const filenames[] = { "dgram/info/css.bin", "dgram/info/tf2.bin" };
+
+    for (size_t i = 0; i < sizeof (filenames) / sizeof (*filenames); ++i) {
+        size_t   datagram_len;
+        uint8_t *datagram = read_datagram(filenames[i], &datagram_len);
+
+        SSQ_ERROR err;
+        ssq_error_clear(&err);
+
+        // The datagrams are single-packet responses, whose header comes right after the packet header.
+        A2S_INFO_REF info;
+        cr_assert(ssq_info_deserialize_view(datagram + 4, datagram_len - 4, &info, &err));
+
+        uint8_t      response[1400];
+        const size_t response_len = ssq_info_serialize(&info, response, sizeof (response));
+
+        cr_assert_eq(response_len, datagram_len - 4);
+        cr_expect_arr_eq(response, datagram + 4, response_len);
+        cr_expect_eq(ssq_info_serialize(&info, NULL, 0), response_len);
+
+        // Nothing is written past the end of too small a buffer.
+        memset(response, 0xAA, sizeof (response));
+        cr_expect_eq(ssq_info_serialize(&info, response, 8), response_len);
+        cr_expect_arr_eq(response, datagram + 4, 8);
+        cr_expect_eq(response[8], 0xAA);
+
+        free(datagram);
+    }
+}
@@ -77,3 +77,114 @@ Test(a2s_player, bad_header) {
     ssq_packet_free(packet);
     free(response);
 }
+
+Test(a2s_player, view) {
+    size_t   datagram_len;
+    uint8_t *datagram = read_datagram("dgram/player/example_0.bin", &datagram_len);
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_PACKET *packet = ssq_packet_from_datagram(datagram, datagram_len, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(packet, NULL);
+
+    size_t   response_len;
+    uint8_t *response = ssq_packets_to_response((const SSQ_PACKET *const *)(&packet), 1, &response_len, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(response, NULL);
+
+    A2S_PLAYER_REF  storage[UINT8_MAX];
+    uint8_t         player_count = 0;
+    A2S_PLAYER_REF *players      = ssq_player_deserialize_view(response, response_len, storage, UINT8_MAX, &player_count, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_eq(players, storage);
+    cr_assert_eq(player_count, 2);
+
+    cr_expect_eq(players[0].index, 1);
+    cr_expect_str_eq(players[0].name.str, "[D]---->T.N.W<----");
+    cr_expect_eq(players[0].name.len, 18);
+    cr_expect_eq(players[0].score, 14);
+    cr_expect_float_eq(players[0].duration, 514.370361F, 1e-6);
+    cr_expect_str_eq(players[1].name.str, "Killer !!!");
+
+    // Too small a storage falls back to an allocation.
+    players = ssq_player_deserialize_view(response, response_len, storage, 1, &player_count, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(players, NULL);
+    cr_assert_neq(players, storage);
+    cr_expect_str_eq(players[1].name.str, "Killer !!!");
+    free(players);
+
+    free(datagram);
+    ssq_packet_free(packet);
+    free(response);
+}
+
+Test(a2s_player, into) {
+    static const uint8_t empty[] = { S2A_HEADER_PLAYER, 0x00 };
+
+    size_t   datagram_len;
+    uint8_t *datagram = read_datagram("dgram/player/example_0.bin", &datagram_len);
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    uint8_t     player_count = 0;
+    A2S_PLAYER *players      = ssq_player_deserialize_into(datagram + 4, datagram_len - 4, NULL, &player_count, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(players, NULL);
+    cr_assert_eq(player_count, 2);
+
+    // The array is kept while the server is empty, and reused once the players are back.
+    A2S_PLAYER *const kept = ssq_player_deserialize_into(empty, sizeof (empty), players, &player_count, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(kept, players);
+    cr_expect_eq(player_count, 0);
+
+    A2S_PLAYER *const reused = ssq_player_deserialize_into(datagram + 4, datagram_len - 4, kept, &player_count, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(reused, players);
+    cr_assert_eq(player_count, 2);
+    cr_expect_str_eq(reused[1].name, "Killer !!!");
+    cr_expect_eq(reused[1].score, 5);
+
+    // An invalid response leaves the previous result to the caller.
+    const uint8_t bad_header[] = { S2A_HEADER_PLAYER + 1, 0x00 };
+    cr_expect_eq(ssq_player_deserialize_into(bad_header, sizeof (bad_header), reused, &player_count, &err), NULL);
+    cr_expect_eq(err.code, SSQ_ERR_BADRES);
+    cr_expect_eq(player_count, 2);
+    cr_expect_str_eq(reused[1].name, "Killer !!!");
+
+    ssq_player_free(reused, player_count);
+    free(datagram);
+}
+
+Test(a2s_player, serialize) {
+    size_t   datagram_len;
+    uint8_t *datagram = read_datagram("dgram/player/example_0.bin", &datagram_len);
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    A2S_PLAYER_REF  storage[UINT8_MAX];
+    uint8_t         player_count = 0;
+    A2S_PLAYER_REF *players      = ssq_player_deserialize_view(datagram + 4, datagram_len - 4, storage, UINT8_MAX, &player_count, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_eq(player_count, 2);
+
+    uint8_t      response[1400];
+    const size_t response_len = ssq_player_serialize(players, player_count, response, sizeof (response));
+
+    cr_assert_eq(response_len, datagram_len - 4);
+    cr_expect_arr_eq(response, datagram + 4, response_len);
+    cr_expect_eq(ssq_player_serialize(players, player_count, NULL, 0), response_len);
+
+    free(datagram);
+}
@@ -1,5 +1,7 @@
 #include <criterion/criterion.h>
+#include <string.h>
 #include "helper.h"
+#include "ssq/a2s/info.h"
 #include "ssq/a2s/rules.h"
 #include "ssq/packet.h"
 
@@ -89,3 +91,184 @@ Test(a2s_rules, bad_header) {
     ssq_packet_free(packet);
     free(response);
 }
+
+Test(a2s_rules, truncated) {
+    // Claims three rules, but holds one and a half.
+    const uint8_t response[] = {
+        0xFF, 0xFF, 0xFF, 0xFF, S2A_HEADER_RULES, 0x03, 0x00,
+        'm', 'p', '_', 't', 'i', 'm', 'e', 'l', 'i', 'm', 'i', 't', '\0', '3', '0', '\0',
+        'n', 'e', 'x', 't'
+    };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    uint16_t   rule_count = 0;
+    A2S_RULES *rules      = ssq_rules_deserialize(response, sizeof (response), &rule_count, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(rules, NULL);
+    cr_assert_eq(rule_count, 3);
+
+    cr_expect_str_eq(rules[0].name, "mp_timelimit");
+    cr_expect_str_eq(rules[0].value, "30");
+    cr_expect_str_eq(rules[1].name, "next");
+    cr_expect_str_eq(rules[1].value, "");
+    cr_expect_str_eq(rules[2].name, "");
+    cr_expect_eq(rules[2].value_len, 0);
+
+    ssq_rules_free(rules, rule_count);
+}
+
+Test(a2s_rules, view) {
+    const uint8_t response[] = {
+        0xFF, 0xFF, 0xFF, 0xFF, S2A_HEADER_RULES, 0x02, 0x00,
+        'm', 'p', '_', 't', 'i', 'm', 'e', 'l', 'i', 'm', 'i', 't', '\0', '3', '0', '\0',
+        's', 'v', '_', 't', 'a', 'g', 's', '\0', 'c', 't', 'f'
+    };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    uint16_t       rule_count = 0;
+    A2S_RULES_REF *rules      = ssq_rules_deserialize_view(response, sizeof (response), NULL, 0, &rule_count, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(rules, NULL);
+    cr_assert_eq(rule_count, 2);
+
+    cr_expect_eq((const uint8_t *)rules[0].name.str, response + 7);
+    cr_expect_eq(rules[0].name.len, 12);
+    cr_expect_str_eq(rules[0].value.str, "30");
+    cr_expect_str_eq(rules[1].name.str, "sv_tags");
+
+    // The last string is cut by the end of the response, hence not null-terminated.
+    cr_expect_eq(rules[1].value.len, 3);
+    cr_expect_arr_eq(rules[1].value.str, "ctf", 3);
+
+    free(rules);
+}
+
+typedef struct find_rule {
+    const char     *name;
+    SSQ_STRING_VIEW value;
+    size_t          visited;
+} FIND_RULE;
+
+static bool find_rule(const A2S_RULES_REF *const rule, void *const user_data) {
+    FIND_RULE *const find = user_data;
+
+    ++(find->visited);
+
+    if (strcmp(rule->name.str, find->name) != 0)
+        return true;
+
+    find->value = rule->value;
+    return false;
+}
+
+Test(a2s_rules, foreach_stops_early) {
+    const uint8_t response[] = {
+        0xFF, 0xFF, 0xFF, 0xFF, S2A_HEADER_RULES, 0x03, 0x00,
+        'm', 'p', '_', 't', 'i', 'm', 'e', 'l', 'i', 'm', 'i', 't', '\0', '3', '0', '\0',
+        's', 'v', '_', 't', 'a', 'g', 's', '\0', 'c', 't', 'f', '\0',
+        'n', 'e', 'x', 't', 'l', 'e', 'v', 'e', 'l', '\0', '\0'
+    };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    FIND_RULE find = { "sv_tags", { NULL, 0 }, 0 };
+    ssq_rules_deserialize_foreach(response, sizeof (response), find_rule, &find, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(find.visited, 2);
+    cr_expect_str_eq(find.value.str, "ctf");
+    cr_expect_eq(find.value.len, 3);
+}
+
+Test(a2s_rules, foreach_bad_header) {
+    const uint8_t response[] = { 0xFF, 0xFF, 0xFF, 0xFF, S2A_HEADER_INFO, 0x01, 0x00 };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    FIND_RULE find = { "sv_tags", { NULL, 0 }, 0 };
+    ssq_rules_deserialize_foreach(response, sizeof (response), find_rule, &find, &err);
+
+    cr_expect_eq(err.code, SSQ_ERR_BADRES);
+    cr_expect_eq(find.visited, 0);
+}
+
+Test(a2s_rules, into) {
+    static const uint8_t two_rules[] = { S2A_HEADER_RULES, 0x02, 0x00, 'a', 0, '1', 0, 'b', 0, '2', 0 };
+    static const uint8_t one_rule[]  = { S2A_HEADER_RULES, 0x01, 0x00, 'c', 0, '3', 0 };
+
+    uint8_t long_rule[3 + 2 * 64];
+    memset(long_rule, 'x', sizeof (long_rule));
+    memcpy(long_rule, one_rule, 3);
+    long_rule[3 + 63]                 = '\0';
+    long_rule[sizeof (long_rule) - 1] = '\0';
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    uint16_t   rule_count = 0;
+    A2S_RULES *rules      = ssq_rules_deserialize_into(two_rules, sizeof (two_rules), NULL, &rule_count, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(rules, NULL);
+    cr_assert_eq(rule_count, 2);
+
+    A2S_RULES *const reused = ssq_rules_deserialize_into(one_rule, sizeof (one_rule), rules, &rule_count, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(reused, rules);
+    cr_assert_eq(rule_count, 1);
+    cr_expect_str_eq(reused[0].name, "c");
+    cr_expect_str_eq(reused[0].value, "3");
+
+    // Strings too long for the previous result need a larger one.
+    A2S_RULES *const grown = ssq_rules_deserialize_into(long_rule, sizeof (long_rule), reused, &rule_count, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(grown, NULL);
+    cr_assert_eq(rule_count, 1);
+    cr_expect_eq(grown[0].name_len, 63);
+    cr_expect_eq(grown[0].value_len, 63);
+
+    ssq_rules_free(grown, rule_count);
+}
+
+Test(a2s_rules, serialize) {
+    const uint8_t expected[] = {
+        S2A_HEADER_RULES, 0x02, 0x00,
+        'm', 'p', '_', 't', 'i', 'm', 'e', 'l', 'i', 'm', 'i', 't', '\0', '3', '0', '\0',
+        's', 'v', '_', 't', 'a', 'g', 's', '\0', '\0'
+    };
+
+    const A2S_RULES_REF rules[] = {
+        { { "mp_timelimit", 12 }, { "30", 2 } },
+        { { "sv_tags", 7 },       { "", 0 } }
+    };
+
+    uint8_t      response[64];
+    const size_t response_len = ssq_rules_serialize(rules, 2, response, sizeof (response));
+
+    cr_assert_eq(response_len, sizeof (expected));
+    cr_expect_arr_eq(response, expected, sizeof (expected));
+    cr_expect_eq(ssq_rules_serialize(rules, 2, NULL, 0), response_len);
+
+    // The rules read back are the ones written.
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    A2S_RULES_REF  storage[2];
+    uint16_t       rule_count = 0;
+    A2S_RULES_REF *read       = ssq_rules_deserialize_view(response, response_len, storage, 2, &rule_count, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_eq(rule_count, 2);
+    cr_expect_str_eq(read[0].name.str, "mp_timelimit");
+    cr_expect_str_eq(read[0].value.str, "30");
+    cr_expect_str_eq(read[1].name.str, "sv_tags");
+    cr_expect_eq(read[1].value.len, 0);
+}
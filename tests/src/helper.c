@@ -1,9 +1,14 @@
+#include <arpa/inet.h>
 #include <err.h>
 #include <fcntl.h>
+#include <netinet/in.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <unistd.h>
+#include "helper.h"
 
 uint8_t *read_datagram(const char filename[], size_t *const datagram_len) {
     struct stat stat_buf;
@@ -25,3 +30,97 @@ uint8_t *read_datagram(const char filename[], size_t *const datagram_len) {
 
     return datagram;
 }
+
+static void *responder_run(void *const arg) {
+    RESPONDER *const responder = arg;
+
+    for (size_t step = 0; step < responder->step_count; ++step) {
+        struct sockaddr_storage peer;
+        socklen_t               peer_len = sizeof (peer);
+
+        const ssize_t request_len = recvfrom(
+            responder->sockfd,
+            responder->requests[step],
+            RESPONDER_REQUEST_MAX,
+            0,
+            (struct sockaddr *)&peer,
+            &peer_len
+        );
+
+        if (request_len == -1)
+            break;
+
+        responder->request_lens[step] = request_len;
+        responder->request_count      = step + 1;
+
+        for (const char *const *filename = responder->steps[step]; *filename != NULL; ++filename) {
+            size_t   datagram_len;
+            uint8_t *datagram = read_datagram(*filename, &datagram_len);
+
+            sendto(responder->sockfd, datagram, datagram_len, 0, (struct sockaddr *)&peer, peer_len);
+
+            free(datagram);
+        }
+    }
+
+    return NULL;
+}
+
+static void responder_start_family(
+    RESPONDER *const         responder,
+    const int                family,
+    const char *const *const steps[],
+    const size_t             step_count
+) {
+    responder->sockfd = socket(family, SOCK_DGRAM, 0);
+    if (responder->sockfd == -1)
+        err(EXIT_FAILURE, "socket");
+
+    struct sockaddr_storage addr = { 0 };
+    socklen_t               addr_len;
+
+    if (family == AF_INET6) {
+        struct sockaddr_in6 *const in6 = (struct sockaddr_in6 *)&addr;
+        in6->sin6_family = AF_INET6;
+        in6->sin6_addr   = in6addr_loopback;
+        addr_len         = sizeof (*in6);
+    } else {
+        struct sockaddr_in *const in = (struct sockaddr_in *)&addr;
+        in->sin_family      = AF_INET;
+        in->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr_len            = sizeof (*in);
+    }
+
+    if (bind(responder->sockfd, (struct sockaddr *)&addr, addr_len) == -1)
+        err(EXIT_FAILURE, "bind");
+
+    if (getsockname(responder->sockfd, (struct sockaddr *)&addr, &addr_len) == -1)
+        err(EXIT_FAILURE, "getsockname");
+
+    // Bounds the lifetime of the responder thread should a test give up early.
+    struct timeval timeout = { .tv_sec = 2, .tv_usec = 0 };
+    setsockopt(responder->sockfd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof (timeout));
+
+    responder->port          = ntohs((family == AF_INET6) ? ((struct sockaddr_in6 *)&addr)->sin6_port : ((struct sockaddr_in *)&addr)->sin_port);
+    responder->step_count    = step_count;
+    responder->request_count = 0;
+
+    for (size_t i = 0; i < step_count; ++i)
+        responder->steps[i] = steps[i];
+
+    if (pthread_create(&(responder->thread), NULL, responder_run, responder) != 0)
+        errx(EXIT_FAILURE, "pthread_create");
+}
+
+void responder_start(RESPONDER *const responder, const char *const *const steps[], const size_t step_count) {
+    responder_start_family(responder, AF_INET, steps, step_count);
+}
+
+void responder_start6(RESPONDER *const responder, const char *const *const steps[], const size_t step_count) {
+    responder_start_family(responder, AF_INET6, steps, step_count);
+}
+
+void responder_join(RESPONDER *const responder) {
+    pthread_join(responder->thread, NULL);
+    close(responder->sockfd);
+}
@@ -0,0 +1,97 @@
+#include <criterion/criterion.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include "ssq/batch.h"
+
+static int helper_bind_loopback(struct sockaddr_in *const addr) {
+    const int sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    cr_assert_neq(sockfd, -1);
+
+    memset(addr, 0, sizeof (*addr));
+    addr->sin_family      = AF_INET;
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    socklen_t addr_len = sizeof (*addr);
+    cr_assert_neq(bind(sockfd, (struct sockaddr *)addr, addr_len), -1);
+    cr_assert_neq(getsockname(sockfd, (struct sockaddr *)addr, &addr_len), -1);
+
+    return sockfd;
+}
+
+Test(batch, init) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_BATCH batch;
+    ssq_batch_init(&batch, 4, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(batch.capacity, 4);
+    cr_expect_eq(batch.count, 0);
+
+    ssq_batch_free(&batch);
+    cr_expect_eq(batch.slots, NULL);
+}
+
+Test(batch, push_full) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_BATCH batch;
+    ssq_batch_init(&batch, 2, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+
+    const uint8_t datagram[SSQ_PACKET_SIZE + 1] = { 0 };
+
+    cr_expect(!ssq_batch_push(&batch, datagram, sizeof (datagram), NULL, 0));
+    cr_expect(ssq_batch_push(&batch, datagram, 1, NULL, 0));
+    cr_expect(ssq_batch_push(&batch, datagram, 1, NULL, 0));
+    cr_expect(!ssq_batch_push(&batch, datagram, 1, NULL, 0));
+    cr_expect_eq(batch.count, 2);
+
+    ssq_batch_clear(&batch);
+    cr_expect_eq(batch.count, 0);
+
+    ssq_batch_free(&batch);
+}
+
+Test(batch, send_recv) {
+    struct sockaddr_in sender_addr, receiver_addr;
+
+    const int sender   = helper_bind_loopback(&sender_addr);
+    const int receiver = helper_bind_loopback(&receiver_addr);
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_BATCH batch;
+    ssq_batch_init(&batch, 2, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+
+    cr_assert(ssq_batch_push(&batch, (const uint8_t *)"abc", 3, (struct sockaddr *)&receiver_addr, sizeof (receiver_addr)));
+    cr_assert(ssq_batch_push(&batch, (const uint8_t *)"defgh", 5, (struct sockaddr *)&receiver_addr, sizeof (receiver_addr)));
+
+    cr_expect_eq(ssq_batch_send(&batch, sender, &err), 2);
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(batch.count, 0);
+
+    cr_assert_eq(ssq_batch_recv(&batch, receiver, &err), 2);
+    cr_assert_eq(err.code, SSQ_OK);
+
+    cr_expect_eq(batch.lens[0], 3);
+    cr_expect_arr_eq(batch.slots[0], "abc", 3);
+    cr_expect_eq(batch.lens[1], 5);
+    cr_expect_arr_eq(batch.slots[1], "defgh", 5);
+
+    const struct sockaddr_in *const source = (const struct sockaddr_in *)&(batch.addrs[0]);
+    cr_expect_eq(source->sin_port, sender_addr.sin_port);
+
+    // The socket is drained.
+    cr_expect_eq(ssq_batch_recv(&batch, receiver, &err), 0);
+    cr_expect_eq(err.code, SSQ_OK);
+
+    ssq_batch_free(&batch);
+    close(sender);
+    close(receiver);
+}
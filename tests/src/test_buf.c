@@ -362,3 +362,111 @@ Test(buf, get_string) {
     free(s1);
     free(s2);
 }
+
+Test(buf, get_string_into) {
+    const uint8_t payload[] = {
+        'H', 'e', 'l', 'l', 'o', '\0',
+        'W', 'o', 'r', 'l', 'd', 0xFF
+    };
+
+    SSQ_BUF buf = ssq_buf_init(payload, sizeof (payload));
+
+    // Two strings in the payload, plus one past its end.
+    const size_t arena_size = ssq_buf_strings_size(&buf, 3);
+    cr_expect_eq(arena_size, sizeof (payload) + 3);
+
+    char  arena[sizeof (payload) + 3];
+    char *cursor = arena;
+
+    size_t      s1_len = 0;
+    const char *s1     = ssq_buf_get_string_into(&buf, &cursor, &s1_len);
+
+    cr_expect_eq(s1, arena);
+    cr_expect_eq(s1_len, 5);
+    cr_expect_str_eq(s1, "Hello");
+    cr_expect_eq(buf.cursor, 6);
+
+    size_t      s2_len = 0;
+    const char *s2     = ssq_buf_get_string_into(&buf, &cursor, &s2_len);
+
+    cr_expect_eq(s2, arena + 6);
+    cr_expect_eq(s2_len, 6);
+    cr_expect_str_eq(s2, "World\xFF");
+    cr_expect(ssq_buf_eof(&buf));
+
+    size_t      s3_len = 1;
+    const char *s3     = ssq_buf_get_string_into(&buf, &cursor, &s3_len);
+
+    cr_expect_eq(s3_len, 0);
+    cr_expect_str_eq(s3, "");
+    cr_expect_leq((size_t)(cursor - arena), arena_size);
+}
+
+Test(buf, reserve) {
+    const uint8_t payload[] = {
+        0x01, 0x00,
+        0x00, 0x00, 0x00, 0x80,
+        0x00, 0x00, 0x80, 0x3F,
+        0xCA, 0xFE, 0x42
+    };
+
+    SSQ_BUF buf = ssq_buf_init(payload, sizeof (payload));
+
+    const uint8_t *const block = ssq_buf_reserve(&buf, 10);
+
+    cr_expect_eq(block, payload);
+    cr_expect_eq(buf.cursor, 10);
+    cr_expect_eq(ssq_buf_load_uint16(block), 1);
+    cr_expect_eq(ssq_buf_load_int32(block + 2), INT32_MIN);
+    cr_expect_float_eq(ssq_buf_load_float(block + 6), 1.0F, FLT_EPSILON);
+
+    // A block past the end reads as zeroes, and leaves nothing more to read.
+    const uint8_t *const cut = ssq_buf_reserve(&buf, 4);
+
+    cr_expect_eq(ssq_buf_load_uint32(cut), 0);
+    cr_expect(ssq_buf_eof(&buf));
+    cr_expect_eq(ssq_buf_load_uint8(ssq_buf_reserve(&buf, 1)), 0);
+    cr_expect_eq(buf.cursor, sizeof (payload));
+}
+
+Test(buf, scan_nul) {
+    uint8_t bytes[100];
+
+    // Every length and position of the terminator, across the blocks of each scanner and their tails.
+    for (size_t n = 0; n <= sizeof (bytes); ++n) {
+        memset(bytes, 'x', sizeof (bytes));
+        cr_expect_eq(ssq_buf_scan_nul(bytes, n), n);
+
+        for (size_t nul = 0; nul < n; ++nul) {
+            memset(bytes, 'x', sizeof (bytes));
+            bytes[nul] = '\0';
+            cr_expect_eq(ssq_buf_scan_nul(bytes, n), nul);
+
+            // A later null byte does not matter.
+            if (nul + 1 < n)
+                bytes[n - 1] = '\0';
+            cr_expect_eq(ssq_buf_scan_nul(bytes, n), nul);
+        }
+
+        // Nor does a null byte past the bound.
+        if (n < sizeof (bytes)) {
+            memset(bytes, 'x', sizeof (bytes));
+            bytes[n] = '\0';
+            cr_expect_eq(ssq_buf_scan_nul(bytes, n), n);
+        }
+    }
+}
+
+Test(buf, get_string_len) {
+    const char payload[] = "Hello\0World";
+
+    SSQ_BUF buf = ssq_buf_init(payload, sizeof (payload) - 1);
+
+    cr_expect_eq(ssq_buf_get_string_len(&buf), 5);
+
+    ssq_buf_forward(&buf, 6);
+    cr_expect_eq(ssq_buf_get_string_len(&buf), 5);
+
+    ssq_buf_forward(&buf, 999);
+    cr_expect_eq(ssq_buf_get_string_len(&buf), 0);
+}
@@ -0,0 +1,225 @@
+#include <criterion/criterion.h>
+#include <stdlib.h>
+#include "helper.h"
+#include "ssq/a2s/info.h"
+#include "ssq/mem.h"
+#include "ssq/resolve.h"
+#include "ssq/snapshot.h"
+#include "ssq/ssq.h"
+
+typedef struct counting_allocator {
+    size_t mallocs;
+    size_t callocs;
+    size_t frees;
+} COUNTING_ALLOCATOR;
+
+static void *counting_malloc(const size_t size, void *const user_data) {
+    ++(((COUNTING_ALLOCATOR *)user_data)->mallocs);
+    return malloc(size);
+}
+
+static void *counting_calloc(const size_t count, const size_t size, void *const user_data) {
+    ++(((COUNTING_ALLOCATOR *)user_data)->callocs);
+    return calloc(count, size);
+}
+
+static void counting_free(void *const ptr, void *const user_data) {
+    ++(((COUNTING_ALLOCATOR *)user_data)->frees);
+    free(ptr);
+}
+
+static void mem_reset(void) {
+    ssq_set_accounting(false);
+    ssq_set_allocator(NULL, NULL, NULL, NULL);
+    ssq_mem_charge(NULL);
+}
+
+Test(mem, custom_allocator, .fini = mem_reset) {
+    COUNTING_ALLOCATOR allocator = { 0 };
+    ssq_set_allocator(counting_malloc, counting_calloc, counting_free, &allocator);
+
+    uint8_t *const block = ssq_mem_alloc(32);
+    cr_assert_neq(block, NULL);
+    cr_expect_eq(allocator.mallocs, 1);
+
+    uint8_t *const zeroed = ssq_mem_calloc(4, 8);
+    cr_assert_neq(zeroed, NULL);
+    cr_expect_eq(allocator.callocs, 1);
+    cr_expect_eq(zeroed[31], 0);
+
+    // Resizing goes through the allocator as well, keeping the contents.
+    memset(block, 0xAB, 32);
+    uint8_t *const resized = ssq_mem_realloc(block, 32, 64);
+    cr_assert_neq(resized, NULL);
+    cr_expect_eq(allocator.mallocs, 2);
+    cr_expect_eq(allocator.frees, 1);
+    cr_expect_eq(resized[31], 0xAB);
+
+    ssq_mem_free(resized);
+    ssq_mem_free(zeroed);
+    ssq_mem_free(NULL);
+    cr_expect_eq(allocator.frees, 3);
+
+    ssq_set_allocator(NULL, NULL, NULL, NULL);
+
+    SSQ_QUERIER *const querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+    ssq_free(querier);
+
+    cr_expect_eq(allocator.mallocs, 2);
+}
+
+Test(mem, accounting, .fini = mem_reset) {
+    ssq_set_accounting(true);
+
+    SSQ_MEM_STATS stats = { 0 };
+    cr_expect_eq(ssq_mem_charge(&stats), NULL);
+
+    uint8_t *const block = ssq_mem_alloc(100);
+    cr_assert_neq(block, NULL);
+    cr_expect_eq((uintptr_t)block % 16, 0);
+
+    uint8_t *const zeroed = ssq_mem_calloc(10, 5);
+    cr_assert_neq(zeroed, NULL);
+    cr_expect_eq(stats.current, 150);
+    cr_expect_eq(stats.allocs, 2);
+
+    uint8_t *const resized = ssq_mem_realloc(block, 100, 300);
+    cr_assert_neq(resized, NULL);
+    cr_expect_eq(stats.current, 350);
+    cr_expect_eq(stats.peak, 450);
+
+    // Memory freed under another charge is still discharged from the statistics it was allocated under.
+    cr_expect_eq(ssq_mem_charge(NULL), &stats);
+    ssq_mem_free(resized);
+    ssq_mem_free(zeroed);
+
+    cr_expect_eq(stats.current, 0);
+    cr_expect_eq(stats.peak, 450);
+    cr_expect_eq(stats.allocs, 3);
+    cr_expect_eq(stats.frees, 3);
+}
+
+Test(mem, resolve_cache_hooks, .fini = mem_reset) {
+    ssq_resolve_clear_cache();
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "localhost", 27015);
+    cr_assert(ssq_ok(querier));
+    ssq_free(querier);
+
+    // The cached addresses of the hostname outlive the querier, and are freed once accounting is enabled.
+    ssq_set_accounting(true);
+
+    SSQ_MEM_STATS stats = { 0 };
+    ssq_mem_charge(&stats);
+
+    struct addrinfo *addr_list = NULL;
+    SSQ_ERROR        err;
+    ssq_error_clear(&err);
+
+    cr_assert(ssq_resolve_cached("localhost", 27016, &addr_list, &err));
+    cr_assert_neq(addr_list, NULL);
+    cr_expect_eq(stats.allocs, 1);
+
+    ssq_resolve_free(addr_list);
+    ssq_resolve_clear_cache();
+
+    cr_expect_eq(stats.current, 0);
+    cr_expect_eq(stats.frees, 1);
+}
+
+Test(mem, querier_stats, .fini = mem_reset) {
+    static const char *const css[] = { "dgram/info/css.bin", NULL };
+    static const char *const player[] = { "dgram/player/example_0.bin", NULL };
+    static const char *const rules[] = {
+        "dgram/rules/tf2_0.bin",
+        "dgram/rules/tf2_1.bin",
+        "dgram/rules/tf2_2.bin",
+        "dgram/rules/tf2_3.bin",
+        "dgram/rules/tf2_4.bin",
+        NULL
+    };
+
+    ssq_set_accounting(true);
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ css, player, rules }, 3);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    SSQ_MEM_STATS stats = { 0 };
+    ssq_set_mem_stats(querier, &stats);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    const size_t target_size = stats.current;
+    cr_expect_gt(target_size, 0);
+
+    SSQ_SNAPSHOT *snapshot = ssq_snapshot(querier);
+    cr_assert(ssq_ok(querier));
+    cr_assert_neq(snapshot, NULL);
+    cr_expect_gt(stats.current, target_size);
+
+    ssq_snapshot_free(snapshot);
+    cr_expect_eq(stats.current, target_size);
+
+    ssq_free(querier);
+    responder_join(&responder);
+
+    cr_expect_eq(stats.current, 0);
+    cr_expect_eq(stats.allocs, stats.frees);
+    cr_expect_gt(stats.peak, target_size);
+}
+
+Test(mem, info_into_steady, .fini = mem_reset) {
+    static const char *const css[] = { "dgram/info/css.bin", NULL };
+
+    ssq_set_accounting(true);
+
+    RESPONDER responder;
+    static const char *const drop[] = { NULL };
+
+    responder_start(&responder, (const char *const *const []){ css, css, drop }, 3);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    SSQ_MEM_STATS stats = { 0 };
+    ssq_set_mem_stats(querier, &stats);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    A2S_INFO *info = ssq_info_into(querier, NULL);
+    cr_assert(ssq_ok(querier));
+    cr_assert_neq(info, NULL);
+
+    const size_t   held   = stats.current;
+    const uint64_t allocs = stats.allocs;
+
+    // Polling again only allocates the response buffer, which is freed before returning.
+    A2S_INFO *const reused = ssq_info_into(querier, info);
+    cr_assert(ssq_ok(querier));
+    cr_expect_eq(reused, info);
+    cr_expect_str_eq(reused->map, "de_dust");
+    cr_expect_eq(stats.current, held);
+    cr_expect_eq(stats.allocs - allocs, 1);
+
+    // A lost response fails the poll, but the previous result is kept for the next one.
+    ssq_set_timeout(querier, SSQ_TIMEOUT_QUERY, 200);
+    cr_expect_eq(ssq_info_into(querier, reused), NULL);
+    cr_expect_eq(ssq_errc(querier), SSQ_ERR_TIMEOUT);
+    cr_expect_str_eq(reused->map, "de_dust");
+    cr_expect_eq(stats.current, held);
+
+    ssq_info_free(reused);
+    ssq_free(querier);
+    responder_join(&responder);
+
+    cr_expect_eq(stats.current, 0);
+}
@@ -0,0 +1,442 @@
+#include <criterion/criterion.h>
+#include "helper.h"
+#include "ssq/helper.h"
+#include "ssq/multi.h"
+#include "ssq/resolve.h"
+
+typedef struct results {
+    size_t           count;
+    SSQ_MULTI_RESULT last;
+} RESULTS;
+
+static void helper_record_result(SSQ_MULTI_RESULT *const result) {
+    RESULTS *const results = result->user_data;
+
+    ++(results->count);
+    results->last = *result;
+}
+
+static const char *const g_chall[] = { "dgram/chall/example_0.bin", NULL };
+static const char *const g_css[]   = { "dgram/info/css.bin", NULL };
+static const char *const g_drop[]  = { NULL };
+static const char *const g_rules[] = {
+    "dgram/rules/tf2_0.bin",
+    "dgram/rules/tf2_1.bin",
+    "dgram/rules/tf2_2.bin",
+    "dgram/rules/tf2_3.bin",
+    "dgram/rules/tf2_4.bin",
+    NULL
+};
+
+Test(multi, init) {
+    SSQ_MULTI *multi = ssq_multi_init();
+
+    cr_assert_neq(multi, NULL);
+
+    cr_expect_neq(multi->epollfd, -1);
+    cr_expect_eq(multi->callback, NULL);
+    cr_expect_eq(multi->timeout, SSQ_MULTI_TIMEOUT_DEFAULT_VALUE);
+    cr_expect_eq(multi->max_inflight, SSQ_MULTI_MAX_INFLIGHT_DEFAULT_VALUE);
+    cr_expect_eq(multi->queue_len, 0);
+    cr_expect_eq(multi->inflight_count, 0);
+    cr_expect(ssq_multi_ok(multi));
+
+    ssq_multi_free(multi);
+}
+
+Test(multi, info_with_challenge) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_chall, g_css }, 2);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &results);
+    ssq_multi_run(multi);
+
+    cr_assert(ssq_multi_ok(multi));
+    cr_assert_eq(results.count, 1);
+    cr_assert_eq(results.last.err.code, SSQ_OK);
+    cr_assert_eq(results.last.query, SSQ_MULTI_INFO);
+    cr_assert_neq(results.last.info, NULL);
+    cr_expect_str_eq(results.last.info->map, "de_dust");
+
+    responder_join(&responder);
+
+    cr_assert_eq(responder.request_count, 2);
+    cr_expect_eq(responder.request_lens[1], A2S_INFO_PAYLOAD_LEN);
+    cr_expect_arr_eq(responder.requests[1] + A2S_INFO_PAYLOAD_LEN - 4, "\x4B\xA1\xD5\x22", 4);
+
+    ssq_info_free(results.last.info);
+    ssq_multi_free(multi);
+}
+
+Test(multi, rules_multi_packet) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_rules }, 1);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_RULES, &results);
+    ssq_multi_run(multi);
+
+    cr_assert_eq(results.count, 1);
+    cr_assert_eq(results.last.err.code, SSQ_OK);
+    cr_assert_neq(results.last.rules, NULL);
+    cr_expect_eq(results.last.rule_count, 224);
+    cr_expect_str_eq(results.last.rules[223].name, "tv_relaypassword");
+
+    ssq_rules_free(results.last.rules, results.last.rule_count);
+    ssq_multi_free(multi);
+    responder_join(&responder);
+}
+
+Test(multi, pools_reused) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_rules, g_rules }, 2);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+
+    for (size_t i = 0; i < 2; ++i) {
+        ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_RULES, &results);
+        ssq_multi_run(multi);
+
+        cr_assert_eq(results.count, i + 1);
+        cr_assert_eq(results.last.err.code, SSQ_OK);
+        cr_expect_eq(results.last.rule_count, 224);
+        ssq_rules_free(results.last.rules, results.last.rule_count);
+    }
+
+    // The second response is reassembled in the slots the first one gave back.
+    cr_expect_eq(multi->reassemblies.misses, 1);
+    cr_expect_eq(multi->reassemblies.hits, 1);
+    cr_expect_eq(multi->buffers.misses, 1);
+    cr_expect_eq(multi->buffers.hits, 1);
+
+    ssq_multi_free(multi);
+    responder_join(&responder);
+}
+
+Test(multi, timeout) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_drop }, 1);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_set_timeout(multi, 100);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_PLAYER, &results);
+    ssq_multi_run(multi);
+
+    cr_assert_eq(results.count, 1);
+    cr_expect_eq(results.last.err.code, SSQ_ERR_TIMEOUT);
+    cr_expect_eq(results.last.players, NULL);
+
+    ssq_multi_free(multi);
+    responder_join(&responder);
+}
+
+Test(multi, max_challenges) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_chall, g_chall }, 2);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_set_max_challenges(multi, 1);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &results);
+    ssq_multi_run(multi);
+
+    cr_assert_eq(results.count, 1);
+    cr_expect_eq(results.last.err.code, SSQ_ERR_BADRES);
+    cr_expect_str_eq(results.last.err.message, "Too many challenges");
+
+    ssq_multi_free(multi);
+    responder_join(&responder);
+}
+
+Test(multi, retransmit) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css, g_drop, g_css }, 3);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_set_max_attempts(multi, 2);
+
+    // The first query measures the round-trip time, which sets the retransmission timeout of the second one.
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &results);
+    ssq_multi_run(multi);
+    cr_assert_eq(results.last.err.code, SSQ_OK);
+    ssq_info_free(results.last.info);
+    cr_expect_eq(multi->targets_count, 1);
+
+    const int64_t start = ssq_helper_now_ms();
+
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &results);
+    ssq_multi_run(multi);
+
+    const int64_t elapsed = ssq_helper_now_ms() - start;
+
+    cr_assert_eq(results.count, 2);
+    cr_assert_eq(results.last.err.code, SSQ_OK);
+    cr_expect_str_eq(results.last.info->map, "de_dust");
+    cr_expect_geq(elapsed, SSQ_RTT_RTO_MIN);
+    cr_expect_lt(elapsed, SSQ_RTT_RTO_INITIAL);
+
+    ssq_info_free(results.last.info);
+    ssq_multi_free(multi);
+    responder_join(&responder);
+
+    cr_expect_eq(responder.request_count, 3);
+}
+
+Test(multi, retransmit_ipv6_targets) {
+    RESPONDER responders[2];
+    responder_start6(&(responders[0]), (const char *const *const []){ g_css }, 1);
+    responder_start6(&(responders[1]), (const char *const *const []){ g_css }, 1);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_set_max_attempts(multi, 2);
+
+    // Each IPv6 target gets a round-trip time estimate of its own, as IPv4 ones do.
+    for (size_t i = 0; i < 2; ++i) {
+        ssq_multi_add(multi, "::1", responders[i].port, SSQ_MULTI_INFO, &results);
+        ssq_multi_run(multi);
+
+        cr_assert_eq(results.count, i + 1);
+        cr_assert_eq(results.last.err.code, SSQ_OK);
+        cr_expect_str_eq(results.last.info->map, "de_dust");
+        ssq_info_free(results.last.info);
+
+        cr_expect_eq(multi->targets_count, i + 1);
+    }
+
+    ssq_multi_free(multi);
+    responder_join(&(responders[0]));
+    responder_join(&(responders[1]));
+}
+
+Test(multi, max_inflight_zero) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css }, 1);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    // The queued queries still start one at a time instead of waiting forever.
+    ssq_multi_set_max_inflight(multi, 0);
+    cr_expect_eq(multi->max_inflight, 1);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &results);
+    ssq_multi_run(multi);
+
+    cr_assert_eq(results.count, 1);
+    cr_assert_eq(results.last.err.code, SSQ_OK);
+    ssq_info_free(results.last.info);
+
+    ssq_multi_free(multi);
+    responder_join(&responder);
+}
+
+Test(multi, max_inflight) {
+    RESPONDER responders[3];
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_set_max_inflight(multi, 1);
+
+    for (size_t i = 0; i < 3; ++i) {
+        responder_start(&responders[i], (const char *const *const []){ g_css }, 1);
+        ssq_multi_add(multi, "127.0.0.1", responders[i].port, SSQ_MULTI_INFO, &results);
+    }
+
+    while (ssq_multi_perform(multi, -1) != 0) {
+        cr_assert(ssq_multi_ok(multi));
+        cr_expect_leq(multi->inflight_count, 1);
+
+        if (results.last.info != NULL) {
+            ssq_info_free(results.last.info);
+            results.last.info = NULL;
+        }
+    }
+
+    if (results.last.info != NULL)
+        ssq_info_free(results.last.info);
+
+    cr_expect_eq(results.count, 3);
+
+    ssq_multi_free(multi);
+
+    for (size_t i = 0; i < 3; ++i)
+        responder_join(&responders[i]);
+}
+
+Test(multi, shared_socket) {
+    // The responder answers the requests in the order they come, so the replies cross over:
+    // only their response header routes them back to the right query.
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_chall, g_css, g_rules }, 3);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS info_results  = { 0 };
+    RESULTS rules_results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_set_shared_socket(multi, true);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &info_results);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_RULES, &rules_results);
+    ssq_multi_run(multi);
+
+    cr_assert(ssq_multi_ok(multi));
+    cr_expect_neq(multi->sockfd, -1);
+
+    cr_assert_eq(info_results.count, 1);
+    cr_assert_eq(info_results.last.err.code, SSQ_OK);
+    cr_expect_str_eq(info_results.last.info->map, "de_dust");
+
+    cr_assert_eq(rules_results.count, 1);
+    cr_assert_eq(rules_results.last.err.code, SSQ_OK);
+    cr_expect_eq(rules_results.last.rule_count, 224);
+
+    cr_expect_eq(multi->table_count, 0);
+    cr_expect_eq(multi->stray_count, 0);
+
+    ssq_info_free(info_results.last.info);
+    ssq_rules_free(rules_results.last.rules, rules_results.last.rule_count);
+    ssq_multi_free(multi);
+    responder_join(&responder);
+}
+
+Test(multi, shared_socket_same_target) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css, g_css }, 2);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_set_shared_socket(multi, true);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &results);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &results);
+
+    // The second query waits for the first one, as their replies could not be told apart.
+    cr_expect_eq(ssq_multi_perform(multi, 0), 2);
+    cr_expect_eq(multi->inflight_count, 1);
+    cr_expect_eq(multi->waiting_count, 1);
+
+    while (ssq_multi_perform(multi, -1) != 0) {
+        cr_assert(ssq_multi_ok(multi));
+
+        if (results.last.info != NULL) {
+            ssq_info_free(results.last.info);
+            results.last.info = NULL;
+        }
+    }
+
+    if (results.last.info != NULL)
+        ssq_info_free(results.last.info);
+
+    cr_expect_eq(results.count, 2);
+    cr_expect_eq(multi->waiting_count, 0);
+
+    ssq_multi_free(multi);
+    responder_join(&responder);
+}
+
+Test(multi, shared_socket_strays) {
+    // A fragment of a rules response nobody asked for comes before the reply.
+    static const char *const stray_then_css[] = { "dgram/rules/tf2_0.bin", "dgram/info/css.bin", NULL };
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ stray_then_css }, 1);
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_set_shared_socket(multi, true);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &results);
+    ssq_multi_run(multi);
+
+    cr_assert_eq(results.count, 1);
+    cr_assert_eq(results.last.err.code, SSQ_OK);
+    cr_expect_eq(multi->stray_count, 1);
+
+    ssq_info_free(results.last.info);
+    ssq_multi_free(multi);
+    responder_join(&responder);
+}
+
+Test(multi, resolver) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css, g_css }, 2);
+
+    // Sends the hostname to the resolver rather than to the cache.
+    ssq_resolve_clear_cache();
+
+    SSQ_MULTI *multi = ssq_multi_init();
+    cr_assert_neq(multi, NULL);
+
+    RESULTS results = { 0 };
+    ssq_multi_set_callback(multi, helper_record_result);
+    ssq_multi_add(multi, "localhost", responder.port, SSQ_MULTI_INFO, &results);
+    ssq_multi_add(multi, "127.0.0.1", responder.port, SSQ_MULTI_INFO, &results);
+
+    // The numeric host goes out at once, while the other one waits for the resolver.
+    ssq_multi_perform(multi, 0);
+    cr_expect_neq(multi->resolver, NULL);
+    cr_expect_eq(multi->lookup_count + multi->inflight_count + results.count, 2);
+
+    if (results.last.info != NULL) {
+        ssq_info_free(results.last.info);
+        results.last.info = NULL;
+    }
+
+    while (ssq_multi_perform(multi, -1) != 0) {
+        cr_assert(ssq_multi_ok(multi));
+
+        if (results.last.info != NULL) {
+            ssq_info_free(results.last.info);
+            results.last.info = NULL;
+        }
+    }
+
+    cr_assert(ssq_multi_ok(multi));
+    cr_expect_eq(results.count, 2);
+    cr_expect_eq(results.last.err.code, SSQ_OK);
+    cr_expect_eq(multi->lookup_count, 0);
+
+    if (results.last.info != NULL)
+        ssq_info_free(results.last.info);
+
+    ssq_multi_free(multi);
+    responder_join(&responder);
+}
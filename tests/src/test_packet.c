@@ -1,5 +1,6 @@
 #include <criterion/criterion.h>
 #include "helper.h"
+#include "ssq/mem.h"
 #include "ssq/packet.h"
 
 Test(packet, deserialize_single) {
@@ -135,3 +136,352 @@ Test(packet, to_response) {
     for (size_t i = 0; i < packet_count; ++i)
         ssq_packet_free(packets[i]);
 }
+
+static void helper_reassemble_tf2_rules(const size_t order[5]) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_REASSEMBLY reassembly;
+    ssq_reassembly_init(&reassembly);
+
+    for (size_t i = 0; i < 5; ++i) {
+        const size_t filename_size = 32;
+        char filename[filename_size];
+        snprintf(filename, filename_size, "dgram/rules/tf2_%zu.bin", order[i]);
+
+        size_t   datagram_len;
+        uint8_t *datagram = read_datagram(filename, &datagram_len);
+
+        const bool complete = ssq_reassembly_add(&reassembly, datagram, datagram_len, &err);
+
+        cr_assert_eq(err.code, SSQ_OK);
+        cr_expect_eq(complete, i == 4);
+
+        free(datagram);
+    }
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = ssq_reassembly_release(&reassembly, &buf_len, &err);
+
+    cr_assert_neq(buf, NULL);
+    cr_assert_eq(buf_len, 5723);
+    cr_expect_eq(reassembly.buf, NULL);
+
+    cr_expect_arr_eq(buf, "\xFF\xFF\xFF\xFF\x45\xE0\x00", 7);
+    cr_expect_arr_eq(buf + 7, "brimmunity_version", 19);
+    cr_expect_arr_eq(buf + 5704, "tv_relaypassword", 17);
+    cr_expect_arr_eq(buf + 5721, "0", 2);
+
+    free(buf);
+}
+
+Test(packet, reassembly) {
+    helper_reassemble_tf2_rules((const size_t []){ 0, 1, 2, 3, 4 });
+}
+
+Test(packet, reassembly_out_of_order) {
+    helper_reassemble_tf2_rules((const size_t []){ 4, 2, 0, 3, 1 });
+}
+
+Test(packet, reassembly_short_packet) {
+    // The packets announce 4-byte payloads but the first one is shorter.
+    const uint8_t datagrams[3][16] = {
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x03, 0x00, 0x04, 0x00, 'a', 'b' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x03, 0x01, 0x04, 0x00, 'c', 'd', 'e', 'f' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x03, 0x02, 0x04, 0x00, 'g' }
+    };
+    const uint16_t datagram_lens[3] = { 14, 16, 13 };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_REASSEMBLY reassembly;
+    ssq_reassembly_init(&reassembly);
+
+    for (size_t i = 0; i < 3; ++i)
+        ssq_reassembly_add(&reassembly, datagrams[i], datagram_lens[i], &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(reassembly.slot_size, 4);
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = ssq_reassembly_release(&reassembly, &buf_len, &err);
+
+    cr_assert_eq(buf_len, 7);
+    cr_expect_arr_eq(buf, "abcdefg", 7);
+
+    free(buf);
+}
+
+Test(packet, reassembly_grow) {
+    // The packets announce 2-byte payloads but carry 4-byte ones.
+    const uint8_t datagrams[2][16] = {
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x02, 0x01, 0x02, 0x00, 'e', 'f', 'g', 'h' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x00, 'a', 'b', 'c', 'd' }
+    };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_REASSEMBLY reassembly;
+    ssq_reassembly_init(&reassembly);
+
+    cr_expect(!ssq_reassembly_add(&reassembly, datagrams[0], 16, &err));
+    cr_expect(ssq_reassembly_add(&reassembly, datagrams[1], 16, &err));
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(reassembly.slot_size, SSQ_PACKET_SIZE);
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = ssq_reassembly_release(&reassembly, &buf_len, &err);
+
+    cr_assert_eq(buf_len, 8);
+    cr_expect_arr_eq(buf, "abcdefgh", 8);
+
+    free(buf);
+}
+
+Test(packet, reassembly_foreign_id) {
+    const uint8_t datagrams[3][13] = {
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x00, 'a' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2B, 0x00, 0x00, 0x00, 0x02, 0x01, 0x01, 0x00, 'x' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x02, 0x01, 0x01, 0x00, 'b' }
+    };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_REASSEMBLY reassembly;
+    ssq_reassembly_init(&reassembly);
+
+    cr_expect(!ssq_reassembly_add(&reassembly, datagrams[0], 13, &err));
+    cr_expect(!ssq_reassembly_add(&reassembly, datagrams[1], 13, &err));
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(reassembly.received, 1);
+
+    cr_expect(ssq_reassembly_add(&reassembly, datagrams[2], 13, &err));
+    cr_assert_eq(err.code, SSQ_OK);
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = ssq_reassembly_release(&reassembly, &buf_len, &err);
+
+    cr_assert_eq(buf_len, 2);
+    cr_expect_arr_eq(buf, "ab", 2);
+
+    free(buf);
+}
+
+Test(packet, reassembly_duplicate) {
+    const uint8_t datagrams[2][13] = {
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x00, 'a' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x02, 0x01, 0x01, 0x00, 'b' }
+    };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_REASSEMBLY reassembly;
+    ssq_reassembly_init(&reassembly);
+
+    // A duplicate does not count as another packet.
+    cr_expect(!ssq_reassembly_add(&reassembly, datagrams[0], 13, &err));
+    cr_expect(!ssq_reassembly_add(&reassembly, datagrams[0], 13, &err));
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(reassembly.received, 1);
+
+    cr_expect(ssq_reassembly_add(&reassembly, datagrams[1], 13, &err));
+    cr_expect(!ssq_reassembly_add(&reassembly, datagrams[1], 13, &err));
+    cr_assert_eq(err.code, SSQ_OK);
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = ssq_reassembly_release(&reassembly, &buf_len, &err);
+
+    cr_assert_eq(buf_len, 2);
+    cr_expect_arr_eq(buf, "ab", 2);
+
+    free(buf);
+}
+
+Test(packet, reassembly_total_learnt_later) {
+    // The first packets to come do not announce the total, and one of them is past it.
+    const uint8_t datagrams[4][13] = {
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01, 0x00, 'c' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x00, 0x05, 0x01, 0x00, 'x' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x03, 0x00, 0x01, 0x00, 'a' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x03, 0x01, 0x01, 0x00, 'b' }
+    };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_REASSEMBLY reassembly;
+    ssq_reassembly_init(&reassembly);
+
+    cr_expect(!ssq_reassembly_add(&reassembly, datagrams[0], 13, &err));
+    cr_expect(!ssq_reassembly_add(&reassembly, datagrams[1], 13, &err));
+    cr_expect_eq(reassembly.total, 0);
+    cr_expect_eq(reassembly.received, 2);
+
+    cr_expect(!ssq_reassembly_add(&reassembly, datagrams[2], 13, &err));
+    cr_expect_eq(reassembly.total, 3);
+    cr_expect_eq(reassembly.received, 2);
+
+    cr_expect(ssq_reassembly_add(&reassembly, datagrams[3], 13, &err));
+    cr_assert_eq(err.code, SSQ_OK);
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = ssq_reassembly_release(&reassembly, &buf_len, &err);
+
+    cr_assert_eq(buf_len, 3);
+    cr_expect_arr_eq(buf, "abc", 3);
+
+    free(buf);
+}
+
+Test(packet, reassembly_contradicting_packets) {
+    const uint8_t datagrams[4][13] = {
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x00, 'a' },
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x03, 0x01, 0x01, 0x00, 'x' }, // other total
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x02, 0x02, 0x01, 0x00, 'y' }, // number past total
+        { 0xFE, 0xFF, 0xFF, 0xFF, 0x2A, 0x00, 0x00, 0x00, 0x00, 0x04, 0x01, 0x00, 'z' }  // number past total
+    };
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    SSQ_REASSEMBLY reassembly;
+    ssq_reassembly_init(&reassembly);
+
+    for (size_t i = 0; i < 4; ++i)
+        cr_expect(!ssq_reassembly_add(&reassembly, datagrams[i], 13, &err));
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_expect_eq(reassembly.received, 1);
+
+    ssq_reassembly_free(&reassembly);
+    cr_expect_eq(reassembly.buf, NULL);
+}
+
+/**
+ * Reassembles the compressed TF2 rules response.
+ *
+ * @param offset  offset of the byte of the first datagram to tamper with
+ * @param mask    value XOR'ed into that byte
+ * @param err     where to report potential errors
+ * @param buf_len where to store the length of the response
+ *
+ * @return reassembled response
+ */
+static uint8_t *helper_reassemble_tf2_rules_bz2(const size_t offset, const uint8_t mask, SSQ_ERROR *const err, size_t *const buf_len) {
+    SSQ_REASSEMBLY reassembly;
+    ssq_reassembly_init(&reassembly);
+
+    bool complete = false;
+
+    for (size_t i = 0; i < 2 && err->code == SSQ_OK; ++i) {
+        const size_t filename_size = 32;
+        char filename[filename_size];
+        snprintf(filename, filename_size, "dgram/rules/tf2_bz2_%zu.bin", i);
+
+        size_t   datagram_len;
+        uint8_t *datagram = read_datagram(filename, &datagram_len);
+
+        if (i == 0)
+            datagram[offset] ^= mask;
+
+        complete = ssq_reassembly_add(&reassembly, datagram, datagram_len, err);
+
+        free(datagram);
+    }
+
+    if (!complete) {
+        ssq_reassembly_free(&reassembly);
+        return NULL;
+    }
+
+    return ssq_reassembly_release(&reassembly, buf_len, err);
+}
+
+#ifdef SSQ_HAVE_BZIP2
+Test(packet, reassembly_compressed) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = helper_reassemble_tf2_rules_bz2(0, 0x00, &err, &buf_len);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(buf, NULL);
+    cr_assert_eq(buf_len, 5723);
+
+    cr_expect_arr_eq(buf, "\xFF\xFF\xFF\xFF\x45\xE0\x00", 7);
+    cr_expect_arr_eq(buf + 5704, "tv_relaypassword", 17);
+
+    free(buf);
+}
+
+static void packet_mem_reset(void) {
+    ssq_set_accounting(false);
+    ssq_mem_charge(NULL);
+}
+
+Test(packet, reassembly_compressed_charged, .fini = packet_mem_reset) {
+    ssq_set_accounting(true);
+
+    SSQ_MEM_STATS stats = { 0 };
+    ssq_mem_charge(&stats);
+
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = helper_reassemble_tf2_rules_bz2(0, 0x00, &err, &buf_len);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(buf, NULL);
+    cr_expect_eq(stats.current, buf_len);
+
+    // The state of the decompressor, at least 400 KB, is charged along with the response.
+    cr_expect_gt(stats.peak, 400000);
+
+    ssq_mem_free(buf);
+    cr_expect_eq(stats.current, 0);
+    cr_expect_eq(stats.allocs, stats.frees);
+}
+
+Test(packet, reassembly_compressed_bad_crc) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = helper_reassemble_tf2_rules_bz2(16, 0x01, &err, &buf_len);
+
+    cr_expect_eq(buf, NULL);
+    cr_expect_eq(err.code, SSQ_ERR_BADRES);
+    cr_expect_str_eq(err.message, "CRC32 checksum mismatch");
+}
+
+Test(packet, reassembly_compressed_bad_size) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    // Announces a decompressed size one byte short.
+    size_t   buf_len = 0;
+    uint8_t *buf     = helper_reassemble_tf2_rules_bz2(12, 0x01, &err, &buf_len);
+
+    cr_expect_eq(buf, NULL);
+    cr_expect_eq(err.code, SSQ_ERR_BADRES);
+    cr_expect_str_eq(err.message, "Decompressed size mismatch");
+}
+#else /* not SSQ_HAVE_BZIP2 */
+Test(packet, reassembly_compressed_unsupported) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    size_t   buf_len = 0;
+    uint8_t *buf     = helper_reassemble_tf2_rules_bz2(0, 0x00, &err, &buf_len);
+
+    cr_expect_eq(buf, NULL);
+    cr_expect_eq(err.code, SSQ_ERR_UNSUPPORTED);
+}
+#endif /* SSQ_HAVE_BZIP2 */
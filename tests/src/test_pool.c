@@ -0,0 +1,59 @@
+#include <criterion/criterion.h>
+#include "ssq/pool.h"
+
+Test(pool, init) {
+    SSQ_POOL pool;
+    ssq_pool_init(&pool, 1);
+
+    cr_expect_geq(pool.slot_size, sizeof (void *));
+    cr_expect_eq(pool.slot_size % 16, 0);
+    cr_expect_eq(pool.hits, 0);
+    cr_expect_eq(pool.misses, 0);
+
+    ssq_pool_free(&pool);
+}
+
+Test(pool, reuse) {
+    SSQ_POOL pool;
+    ssq_pool_init(&pool, 1400);
+
+    uint8_t *const first = ssq_pool_alloc(&pool);
+    cr_assert_neq(first, NULL);
+    cr_expect_eq((uintptr_t)first % 16, 0);
+    cr_expect_eq(pool.misses, 1);
+    cr_expect_eq(pool.hits, 0);
+
+    memset(first, 0xAB, 1400);
+    ssq_pool_release(&pool, first);
+
+    uint8_t *const second = ssq_pool_alloc(&pool);
+    cr_expect_eq(second, first);
+    cr_expect_eq(pool.misses, 1);
+    cr_expect_eq(pool.hits, 1);
+
+    ssq_pool_release(&pool, second);
+    ssq_pool_release(&pool, NULL);
+    ssq_pool_free(&pool);
+}
+
+Test(pool, grow) {
+    SSQ_POOL pool;
+    ssq_pool_init(&pool, 64);
+
+    uint8_t *slots[2 * SSQ_POOL_SLAB_SLOTS + 1];
+
+    for (size_t i = 0; i < 2 * SSQ_POOL_SLAB_SLOTS + 1; ++i) {
+        slots[i] = ssq_pool_alloc(&pool);
+        cr_assert_neq(slots[i], NULL);
+        memset(slots[i], (int)i, 64);
+    }
+
+    // A new slab is only allocated once the slots of the previous ones are all handed out.
+    cr_expect_eq(pool.misses, 3);
+    cr_expect_eq(pool.hits, 2 * SSQ_POOL_SLAB_SLOTS + 1 - 3);
+
+    for (size_t i = 0; i < 2 * SSQ_POOL_SLAB_SLOTS + 1; ++i)
+        cr_expect_eq(slots[i][63], (uint8_t)i);
+
+    ssq_pool_free(&pool);
+}
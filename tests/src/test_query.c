@@ -0,0 +1,550 @@
+#include <criterion/criterion.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "helper.h"
+#include "ssq/a2s/info.h"
+#include "ssq/a2s/player.h"
+#include "ssq/a2s/rules.h"
+#include "ssq/helper.h"
+#include "ssq/query.h"
+#include "ssq/response.h"
+
+static const char *const g_chall[]  = { "dgram/chall/example_0.bin", NULL };
+static const char *const g_css[]    = { "dgram/info/css.bin", NULL };
+static const char *const g_player[] = { "dgram/player/example_0.bin", NULL };
+static const char *const g_tf2[]    = { "dgram/info/tf2.bin", NULL };
+
+/* Gives the target of a querier several addresses on the loopback interface, one per port. */
+static void helper_set_targets(SSQ_QUERIER *const querier, const uint16_t ports[], const size_t port_count) {
+    struct addrinfo *const addr_list = calloc(port_count, sizeof (struct addrinfo) + sizeof (struct sockaddr_in));
+    cr_assert_neq(addr_list, NULL);
+
+    struct sockaddr_in *const addrs = (struct sockaddr_in *)(addr_list + port_count);
+
+    for (size_t i = 0; i < port_count; ++i) {
+        addrs[i].sin_family      = AF_INET;
+        addrs[i].sin_port        = htons(ports[i]);
+        addrs[i].sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        addr_list[i].ai_family   = AF_INET;
+        addr_list[i].ai_socktype = SOCK_DGRAM;
+        addr_list[i].ai_addrlen  = sizeof (addrs[i]);
+        addr_list[i].ai_addr     = (struct sockaddr *)&(addrs[i]);
+        addr_list[i].ai_next     = (i + 1 < port_count) ? &(addr_list[i + 1]) : NULL;
+    }
+
+    ssq_set_target(querier, "127.0.0.1", 0);
+    free(querier->addr_list);
+    querier->addr_list = addr_list;
+}
+
+static uint16_t helper_addr_port(const struct addrinfo *const addr) {
+    return ntohs(((const struct sockaddr_in *)addr->ai_addr)->sin_port);
+}
+
+Test(query, socket_persists) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css, g_css }, 2);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+    cr_expect_eq(querier->sockfd, SSQ_SOCKET_INVALID);
+
+    A2S_INFO *info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    ssq_info_free(info);
+
+    const SSQ_SOCKET sockfd = querier->sockfd;
+    cr_expect_neq(sockfd, SSQ_SOCKET_INVALID);
+    cr_expect(!querier->timeouts_changed);
+
+    info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    ssq_info_free(info);
+
+    cr_expect_eq(querier->sockfd, sockfd);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_expect_eq(querier->sockfd, SSQ_SOCKET_INVALID);
+
+    ssq_free(querier);
+    responder_join(&responder);
+}
+
+Test(query, drains_stale_datagrams) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css, g_tf2 }, 2);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    A2S_INFO *info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    ssq_info_free(info);
+
+    // Late answer to a query which would have timed out.
+    struct sockaddr_storage querier_addr;
+    socklen_t               querier_addr_len = sizeof (querier_addr);
+    cr_assert_neq(getsockname(querier->sockfd, (struct sockaddr *)&querier_addr, &querier_addr_len), -1);
+
+    size_t   datagram_len;
+    uint8_t *datagram = read_datagram("dgram/info/css.bin", &datagram_len);
+    sendto(responder.sockfd, datagram, datagram_len, 0, (struct sockaddr *)&querier_addr, querier_addr_len);
+    free(datagram);
+
+    info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    cr_expect_str_eq(info->map, "pl_badwater_pro_v12_skial");
+    ssq_info_free(info);
+
+    ssq_free(querier);
+    responder_join(&responder);
+}
+
+Test(query, timeouts_changed) {
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    // The waits for datagrams are bounded by `poll', so only the send timeout goes to the socket.
+    querier->timeouts_changed = false;
+    ssq_set_timeout(querier, SSQ_TIMEOUT_RECV | SSQ_TIMEOUT_QUERY, 1234);
+    cr_expect(!querier->timeouts_changed);
+
+    ssq_set_timeout(querier, SSQ_TIMEOUT_SEND, 1234);
+    cr_expect(querier->timeouts_changed);
+
+    ssq_free(querier);
+}
+
+Test(query, timeouts_disabled) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css }, 1);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    // A timeout of 0 waits with no limit instead of giving up at once, and a negative one counts as 0.
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    ssq_set_timeout(querier, SSQ_TIMEOUT_RECV, 0);
+    ssq_set_timeout(querier, SSQ_TIMEOUT_QUERY, -1);
+    cr_assert(ssq_ok(querier));
+    cr_expect_eq(querier->timeout_query, 0);
+
+    A2S_INFO *info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    cr_assert_neq(info, NULL);
+    cr_expect_str_eq(info->map, "de_dust");
+
+    ssq_info_free(info);
+    ssq_free(querier);
+    responder_join(&responder);
+}
+
+Test(query, challenge_cached) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_chall, g_css, g_css }, 3);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+    cr_expect_eq(querier->chall, A2S_CHALLENGE_NONE);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    A2S_INFO *info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    ssq_info_free(info);
+
+    info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    ssq_info_free(info);
+
+    ssq_free(querier);
+    responder_join(&responder);
+
+    cr_assert_eq(responder.request_count, 3);
+    cr_expect_eq(responder.request_lens[0], A2S_INFO_PAYLOAD_LEN - 4);
+    cr_expect_eq(responder.request_lens[2], A2S_INFO_PAYLOAD_LEN);
+    cr_expect_arr_eq(responder.requests[2] + A2S_INFO_PAYLOAD_LEN - 4, "\x4B\xA1\xD5\x22", 4);
+}
+
+Test(query, challenge_shared) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_chall, g_css, g_player }, 3);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    A2S_INFO *info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    ssq_info_free(info);
+
+    uint8_t     player_count = 0;
+    A2S_PLAYER *players      = ssq_player(querier, &player_count);
+    cr_assert(ssq_ok(querier));
+    cr_expect_eq(player_count, 2);
+    ssq_player_free(players, player_count);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_expect_eq(querier->chall, A2S_CHALLENGE_NONE);
+
+    ssq_free(querier);
+    responder_join(&responder);
+
+    cr_assert_eq(responder.request_count, 3);
+    cr_expect_arr_eq(responder.requests[2], "\xFF\xFF\xFF\xFF\x55\x4B\xA1\xD5\x22", A2S_PLAYER_PAYLOAD_LEN);
+}
+
+Test(query, single_packet) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css }, 1);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    uint8_t      payload[A2S_INFO_PAYLOAD_LEN];
+    const size_t payload_len = ssq_info_payload(payload, A2S_CHALLENGE_NONE);
+
+    size_t   response_len = 0;
+    uint8_t *response     = ssq_query(querier, payload, payload_len, &response_len);
+
+    cr_assert(ssq_ok(querier));
+    cr_assert_neq(response, NULL);
+
+    size_t   datagram_len;
+    uint8_t *datagram = read_datagram("dgram/info/css.bin", &datagram_len);
+
+    cr_expect_eq(response_len, datagram_len);
+    cr_expect_arr_eq(response, datagram, datagram_len);
+
+    free(datagram);
+    free(response);
+    ssq_free(querier);
+    responder_join(&responder);
+}
+
+Test(query, multi_packet) {
+    static const char *const rules[] = {
+        "dgram/rules/tf2_0.bin",
+        "dgram/rules/tf2_1.bin",
+        "dgram/rules/tf2_2.bin",
+        "dgram/rules/tf2_3.bin",
+        "dgram/rules/tf2_4.bin",
+        NULL
+    };
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ rules }, 1);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    const uint8_t payload[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0x56, 0x4B, 0xA1, 0xD5, 0x22 };
+
+    size_t   response_len = 0;
+    uint8_t *response     = ssq_query(querier, payload, sizeof (payload), &response_len);
+
+    cr_assert(ssq_ok(querier));
+    cr_assert_neq(response, NULL);
+    cr_expect_eq(response_len, 5723);
+    cr_expect_arr_eq(response, "\xFF\xFF\xFF\xFF\x45\xE0\x00", 7);
+    cr_expect_arr_eq(response + 5704, "tv_relaypassword", 17);
+
+    free(response);
+    ssq_free(querier);
+    responder_join(&responder);
+}
+
+Test(query, multi_packet_duplicates) {
+    // Reordered packets, two of which come twice.
+    static const char *const rules[] = {
+        "dgram/rules/tf2_3.bin",
+        "dgram/rules/tf2_0.bin",
+        "dgram/rules/tf2_3.bin",
+        "dgram/rules/tf2_1.bin",
+        "dgram/rules/tf2_0.bin",
+        "dgram/rules/tf2_4.bin",
+        "dgram/rules/tf2_2.bin",
+        NULL
+    };
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ rules }, 1);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    uint16_t   rule_count = 0;
+    A2S_RULES *rules_res  = ssq_rules(querier, &rule_count);
+
+    cr_assert(ssq_ok(querier));
+    cr_assert_eq(rule_count, 224);
+    cr_expect_str_eq(rules_res[223].name, "tv_relaypassword");
+
+    ssq_rules_free(rules_res, rule_count);
+    ssq_free(querier);
+    responder_join(&responder);
+}
+
+Test(query, deadline_covers_all_packets) {
+    // Two of the five packets never come.
+    static const char *const rules[] = {
+        "dgram/rules/tf2_0.bin",
+        "dgram/rules/tf2_1.bin",
+        "dgram/rules/tf2_2.bin",
+        NULL
+    };
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ rules }, 1);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    ssq_set_timeout(querier, SSQ_TIMEOUT_RECV, 5000);
+    ssq_set_timeout(querier, SSQ_TIMEOUT_QUERY, 200);
+    cr_assert(ssq_ok(querier));
+
+    const int64_t start = ssq_helper_now_ms();
+
+    uint16_t   rule_count = 0;
+    A2S_RULES *rules_res  = ssq_rules(querier, &rule_count);
+
+    const int64_t elapsed = ssq_helper_now_ms() - start;
+
+    cr_expect_eq(rules_res, NULL);
+    cr_expect_eq(ssq_errc(querier), SSQ_ERR_TIMEOUT);
+    cr_expect_geq(elapsed, 200);
+    cr_expect_lt(elapsed, 1000);
+
+    ssq_free(querier);
+    responder_join(&responder);
+}
+
+Test(query, max_challenges) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_chall, g_chall, g_chall }, 3);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    ssq_set_max_challenges(querier, 2);
+    cr_assert(ssq_ok(querier));
+
+    A2S_INFO *info = ssq_info(querier);
+
+    cr_expect_eq(info, NULL);
+    cr_expect_eq(ssq_errc(querier), SSQ_ERR_BADRES);
+    cr_expect_str_eq(ssq_errm(querier), "Too many challenges");
+
+    ssq_free(querier);
+    responder_join(&responder);
+
+    cr_expect_eq(responder.request_count, 3);
+}
+
+Test(query, retransmit) {
+    static const char *const drop[] = { NULL };
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css, drop, g_css }, 3);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    ssq_set_max_attempts(querier, 3);
+    cr_assert(ssq_ok(querier));
+
+    A2S_INFO *info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    ssq_info_free(info);
+
+    // The round-trip time to the loopback interface puts the retransmission timeout at its minimum.
+    cr_assert(querier->rtt.measured);
+    cr_expect_eq(ssq_rtt_rto(&(querier->rtt), 0), SSQ_RTT_RTO_MIN);
+
+    const int64_t start = ssq_helper_now_ms();
+
+    info = ssq_info(querier);
+
+    const int64_t elapsed = ssq_helper_now_ms() - start;
+
+    cr_assert(ssq_ok(querier));
+    cr_expect_str_eq(info->map, "de_dust");
+    cr_expect_geq(elapsed, SSQ_RTT_RTO_MIN);
+    cr_expect_lt(elapsed, SSQ_RTT_RTO_INITIAL);
+    ssq_info_free(info);
+
+    ssq_free(querier);
+    responder_join(&responder);
+
+    cr_expect_eq(responder.request_count, 3);
+}
+
+Test(query, max_attempts) {
+    static const char *const drop[] = { NULL };
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ drop, drop, g_css }, 3);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    ssq_set_max_attempts(querier, 2);
+    ssq_set_timeout(querier, SSQ_TIMEOUT_QUERY, 1500);
+    cr_assert(ssq_ok(querier));
+
+    A2S_INFO *info = ssq_info(querier);
+
+    cr_expect_eq(info, NULL);
+    cr_expect_eq(ssq_errc(querier), SSQ_ERR_TIMEOUT);
+
+    ssq_free(querier);
+    responder_join(&responder);
+
+    cr_expect_eq(responder.request_count, 2);
+}
+
+#ifdef SSQ_HAVE_BZIP2
+Test(query, compressed) {
+    static const char *const datagrams[] = { "dgram/rules/tf2_bz2_0.bin", "dgram/rules/tf2_bz2_1.bin", NULL };
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ datagrams }, 1);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    uint16_t   rule_count = 0;
+    A2S_RULES *rules  = ssq_rules(querier, &rule_count);
+
+    cr_assert(ssq_ok(querier));
+    cr_assert_eq(rule_count, 224);
+    cr_expect_str_eq(rules[223].name, "tv_relaypassword");
+
+    ssq_rules_free(rules, rule_count);
+    ssq_free(querier);
+    responder_join(&responder);
+}
+#endif /* SSQ_HAVE_BZIP2 */
+
+static bool sum_scores(const A2S_PLAYER_REF *const player, void *const user_data) {
+    *(int32_t *)user_data += player->score;
+    return true;
+}
+
+Test(query, player_foreach) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_player }, 1);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    int32_t score = 0;
+    ssq_player_foreach(querier, sum_scores, &score);
+
+    cr_assert(ssq_ok(querier));
+    cr_expect_eq(score, 14 + 5);
+
+    ssq_free(querier);
+    responder_join(&responder);
+}
+
+Test(query, race_first_reply_wins) {
+    static const char *const drop[] = { NULL };
+
+    RESPONDER silent, responder;
+    responder_start(&silent, (const char *const *const []){ drop }, 1);
+    responder_start(&responder, (const char *const *const []){ g_css, g_css }, 2);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    helper_set_targets(querier, (const uint16_t []){ silent.port, responder.port }, 2);
+    ssq_set_race(querier, SSQ_RACE_ALL, 50);
+    cr_assert(ssq_ok(querier));
+
+    A2S_INFO *info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    cr_expect_str_eq(info->map, "de_dust");
+    ssq_info_free(info);
+
+    cr_assert_neq(querier->addr_preferred, NULL);
+    cr_expect_eq(helper_addr_port(querier->addr_preferred), responder.port);
+
+    // The address which won the race is used alone from then on.
+    info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    ssq_info_free(info);
+
+    ssq_free(querier);
+    responder_join(&silent);
+    responder_join(&responder);
+
+    cr_expect_eq(silent.request_count, 1);
+    cr_expect_eq(responder.request_count, 2);
+}
+
+Test(query, race_skips_unreachable) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css }, 1);
+
+    // A port nothing listens on any longer.
+    const int           closed_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in  closed    = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t           closed_len = sizeof (closed);
+    cr_assert_neq(bind(closed_fd, (struct sockaddr *)&closed, sizeof (closed)), -1);
+    cr_assert_neq(getsockname(closed_fd, (struct sockaddr *)&closed, &closed_len), -1);
+    close(closed_fd);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    helper_set_targets(querier, (const uint16_t []){ ntohs(closed.sin_port), responder.port }, 2);
+    ssq_set_race(querier, SSQ_RACE_ALL, 10000);
+    ssq_set_timeout(querier, SSQ_TIMEOUT_QUERY, 1000);
+    cr_assert(ssq_ok(querier));
+
+    // The next address is raced as soon as the first one is found unreachable, without waiting for the stagger.
+    A2S_INFO *info = ssq_info(querier);
+    cr_assert(ssq_ok(querier));
+    ssq_info_free(info);
+
+    cr_assert_neq(querier->addr_preferred, NULL);
+    cr_expect_eq(helper_addr_port(querier->addr_preferred), responder.port);
+
+    ssq_free(querier);
+    responder_join(&responder);
+}
@@ -0,0 +1,96 @@
+#include <criterion/criterion.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include "ssq/resolve.h"
+
+static uint16_t helper_port(const struct addrinfo *const addr) {
+    return ntohs(((const struct sockaddr_in *)addr->ai_addr)->sin_port);
+}
+
+Test(resolve, numeric) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    struct addrinfo *addr_list = ssq_resolve("127.0.0.1", 27015, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(addr_list, NULL);
+    cr_expect_eq(addr_list->ai_next, NULL);
+    cr_expect_eq(addr_list->ai_family, AF_INET);
+    cr_expect_eq(addr_list->ai_socktype, SOCK_DGRAM);
+    cr_expect_eq(addr_list->ai_addrlen, sizeof (struct sockaddr_in));
+    cr_expect_eq(helper_port(addr_list), 27015);
+    cr_expect_eq(((const struct sockaddr_in *)addr_list->ai_addr)->sin_addr.s_addr, htonl(INADDR_LOOPBACK));
+
+    ssq_resolve_free(addr_list);
+
+    // Numeric hosts never need the resolver.
+    ssq_resolve_set_cache_ttl(0);
+    cr_expect(ssq_resolve_cached("127.0.0.1", 27015, &addr_list, &err));
+    cr_expect_eq(err.code, SSQ_OK);
+    ssq_resolve_free(addr_list);
+    ssq_resolve_set_cache_ttl(SSQ_RESOLVE_CACHE_TTL_DEFAULT_VALUE);
+}
+
+Test(resolve, numeric_ipv6) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    struct addrinfo *addr_list = ssq_resolve("::1", 27015, &err);
+
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(addr_list, NULL);
+    cr_expect_eq(addr_list->ai_next, NULL);
+    cr_expect_eq(addr_list->ai_family, AF_INET6);
+    cr_expect_eq(addr_list->ai_addrlen, sizeof (struct sockaddr_in6));
+
+    const struct sockaddr_in6 *const addr = (const struct sockaddr_in6 *)addr_list->ai_addr;
+    cr_expect_eq(addr->sin6_family, AF_INET6);
+    cr_expect_eq(ntohs(addr->sin6_port), 27015);
+    cr_expect(IN6_IS_ADDR_LOOPBACK(&(addr->sin6_addr)));
+
+    ssq_resolve_free(addr_list);
+}
+
+Test(resolve, cache) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    ssq_resolve_clear_cache();
+
+    struct addrinfo *addr_list = NULL;
+    cr_expect(!ssq_resolve_cached("localhost", 27015, &addr_list, &err));
+    cr_expect_eq(addr_list, NULL);
+
+    addr_list = ssq_resolve("localhost", 27015, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(addr_list, NULL);
+    cr_expect_eq(helper_port(addr_list), 27015);
+    ssq_resolve_free(addr_list);
+
+    // The cached addresses are given the port number of each lookup.
+    cr_assert(ssq_resolve_cached("localhost", 27016, &addr_list, &err));
+    cr_assert_eq(err.code, SSQ_OK);
+    cr_assert_neq(addr_list, NULL);
+    cr_expect_eq(helper_port(addr_list), 27016);
+    ssq_resolve_free(addr_list);
+
+    ssq_resolve_clear_cache();
+    cr_expect(!ssq_resolve_cached("localhost", 27015, &addr_list, &err));
+}
+
+Test(resolve, cache_disabled) {
+    SSQ_ERROR err;
+    ssq_error_clear(&err);
+
+    ssq_resolve_clear_cache();
+    ssq_resolve_set_cache_ttl(0);
+
+    struct addrinfo *addr_list = ssq_resolve("localhost", 27015, &err);
+    cr_assert_eq(err.code, SSQ_OK);
+    ssq_resolve_free(addr_list);
+
+    cr_expect(!ssq_resolve_cached("localhost", 27015, &addr_list, &err));
+
+    ssq_resolve_set_cache_ttl(SSQ_RESOLVE_CACHE_TTL_DEFAULT_VALUE);
+}
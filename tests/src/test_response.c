@@ -84,6 +84,16 @@ Test(response, get_challenge) {
     free(response);
 }
 
+Test(response, single_packet_header) {
+    size_t   datagram_len;
+    uint8_t *datagram = read_datagram("dgram/chall/example_0.bin", &datagram_len);
+
+    cr_expect(ssq_response_has_challenge(datagram, datagram_len));
+    cr_expect_eq(ssq_response_get_challenge(datagram, datagram_len), 0x22D5A14B);
+
+    free(datagram);
+}
+
 Test(response, is_truncated) {
     const size_t packet_count = 5;
     SSQ_PACKET  *packets[packet_count];
@@ -0,0 +1,39 @@
+#include <criterion/criterion.h>
+#include "ssq/rtt.h"
+
+Test(rtt, initial) {
+    SSQ_RTT rtt;
+    ssq_rtt_init(&rtt);
+
+    cr_expect(!rtt.measured);
+    cr_expect_eq(ssq_rtt_rto(&rtt, 0), SSQ_RTT_RTO_INITIAL);
+    cr_expect_eq(ssq_rtt_rto(&rtt, 1), SSQ_RTT_RTO_INITIAL * 2);
+}
+
+Test(rtt, sample) {
+    SSQ_RTT rtt;
+    ssq_rtt_init(&rtt);
+
+    // srtt = 200, rttvar = 100
+    ssq_rtt_sample(&rtt, 200);
+    cr_expect(rtt.measured);
+    cr_expect_eq(ssq_rtt_rto(&rtt, 0), 600);
+
+    // srtt = 200, rttvar = 75
+    ssq_rtt_sample(&rtt, 200);
+    cr_expect_eq(ssq_rtt_rto(&rtt, 0), 500);
+
+    // srtt = 200 + 800 / 8 = 300, rttvar = 75 + (800 - 75) / 4 = 256.25
+    ssq_rtt_sample(&rtt, 1000);
+    cr_expect_eq(ssq_rtt_rto(&rtt, 0), 1325);
+}
+
+Test(rtt, bounds) {
+    SSQ_RTT rtt;
+    ssq_rtt_init(&rtt);
+
+    ssq_rtt_sample(&rtt, 1);
+    cr_expect_eq(ssq_rtt_rto(&rtt, 0), SSQ_RTT_RTO_MIN);
+    cr_expect_eq(ssq_rtt_rto(&rtt, 1), SSQ_RTT_RTO_MIN * 2);
+    cr_expect_eq(ssq_rtt_rto(&rtt, UINT8_MAX), SSQ_RTT_RTO_MAX);
+}
@@ -0,0 +1,123 @@
+#include <criterion/criterion.h>
+#include "helper.h"
+#include "ssq/a2s/info.h"
+#include "ssq/a2s/player.h"
+#include "ssq/a2s/rules.h"
+#include "ssq/snapshot.h"
+
+static const char *const g_chall[]  = { "dgram/chall/example_0.bin", NULL };
+static const char *const g_css[]    = { "dgram/info/css.bin", NULL };
+static const char *const g_player[] = { "dgram/player/example_0.bin", NULL };
+static const char *const g_rules[]  = {
+    "dgram/rules/tf2_0.bin",
+    "dgram/rules/tf2_1.bin",
+    "dgram/rules/tf2_2.bin",
+    "dgram/rules/tf2_3.bin",
+    "dgram/rules/tf2_4.bin",
+    NULL
+};
+
+static void expect_snapshot(const SSQ_SNAPSHOT *const snapshot) {
+    cr_assert_neq(snapshot, NULL);
+
+    cr_assert_neq(snapshot->info, NULL);
+    cr_expect_str_eq(snapshot->info->map, "de_dust");
+
+    cr_expect_neq(snapshot->players, NULL);
+    cr_expect_eq(snapshot->player_count, 2);
+
+    cr_assert_neq(snapshot->rules, NULL);
+    cr_assert_eq(snapshot->rule_count, 224);
+    cr_expect_str_eq(snapshot->rules[223].name, "tv_relaypassword");
+}
+
+Test(snapshot, challenge_shared) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_chall, g_chall, g_chall, g_css, g_player, g_rules }, 6);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    SSQ_SNAPSHOT *snapshot = ssq_snapshot(querier);
+    cr_assert(ssq_ok(querier));
+    expect_snapshot(snapshot);
+    ssq_snapshot_free(snapshot);
+
+    ssq_free(querier);
+    responder_join(&responder);
+
+    // Each query is sent again once only, with the challenge of the first answer.
+    cr_assert_eq(responder.request_count, 6);
+    cr_expect_arr_eq(responder.requests[4], "\xFF\xFF\xFF\xFF\x55\x4B\xA1\xD5\x22", A2S_PLAYER_PAYLOAD_LEN);
+}
+
+Test(snapshot, responses_out_of_order) {
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_rules, g_player, g_css }, 3);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    cr_assert(ssq_ok(querier));
+
+    SSQ_SNAPSHOT *snapshot = ssq_snapshot(querier);
+    cr_assert(ssq_ok(querier));
+    expect_snapshot(snapshot);
+    ssq_snapshot_free(snapshot);
+
+    ssq_free(querier);
+    responder_join(&responder);
+
+    cr_expect_eq(responder.request_count, 3);
+}
+
+Test(snapshot, retransmit_lost_query) {
+    static const char *const drop[] = { NULL };
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css, drop, g_rules, g_player }, 4);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    ssq_set_max_attempts(querier, 2);
+    cr_assert(ssq_ok(querier));
+
+    SSQ_SNAPSHOT *snapshot = ssq_snapshot(querier);
+    cr_assert(ssq_ok(querier));
+    expect_snapshot(snapshot);
+    ssq_snapshot_free(snapshot);
+
+    ssq_free(querier);
+    responder_join(&responder);
+
+    // Only the query left unanswered is sent again.
+    cr_assert_eq(responder.request_count, 4);
+    cr_expect_eq(responder.request_lens[3], A2S_PLAYER_PAYLOAD_LEN);
+}
+
+Test(snapshot, timeout) {
+    static const char *const drop[] = { NULL };
+
+    RESPONDER responder;
+    responder_start(&responder, (const char *const *const []){ g_css, drop, g_rules }, 3);
+
+    SSQ_QUERIER *querier = ssq_init();
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_target(querier, "127.0.0.1", responder.port);
+    ssq_set_timeout(querier, SSQ_TIMEOUT_QUERY, 500);
+    cr_assert(ssq_ok(querier));
+
+    SSQ_SNAPSHOT *snapshot = ssq_snapshot(querier);
+    cr_expect_eq(snapshot, NULL);
+    cr_expect_eq(ssq_errc(querier), SSQ_ERR_TIMEOUT);
+
+    ssq_free(querier);
+    responder_join(&responder);
+}
@@ -12,10 +12,17 @@ Test(ssq, init) {
     cr_assert_neq(querier, NULL);
 
     cr_expect_eq(querier->addr_list, NULL);
+    cr_expect_eq(querier->sockfd, SSQ_SOCKET_INVALID);
     cr_expect(ssq_ok(querier));
     cr_expect_str_empty(ssq_errm(querier));
     helper_expect_timeouts_eq(&(querier->timeout_recv), SSQ_TIMEOUT_RECV_DEFAULT_VALUE);
     helper_expect_timeouts_eq(&(querier->timeout_send), SSQ_TIMEOUT_SEND_DEFAULT_VALUE);
+    cr_expect_eq(querier->timeout_query, SSQ_TIMEOUT_QUERY_DEFAULT_VALUE);
+    cr_expect_eq(querier->max_challenges, SSQ_MAX_CHALLENGES_DEFAULT_VALUE);
+    cr_expect_eq(querier->max_attempts, SSQ_MAX_ATTEMPTS_DEFAULT_VALUE);
+    cr_expect(!querier->rtt.measured);
+    cr_expect_eq(querier->race, SSQ_RACE_OFF);
+    cr_expect_eq(querier->race_stagger, SSQ_RACE_STAGGER_DEFAULT_VALUE);
 
     ssq_free(querier);
 }
@@ -64,3 +71,31 @@ Test(ssq, set_timeout) {
 
     ssq_free(querier);
 }
+
+Test(ssq, set_timeout_query) {
+    SSQ_QUERIER *querier = ssq_init();
+
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_timeout(querier, SSQ_TIMEOUT_QUERY, 1234);
+
+    cr_expect_eq(querier->timeout_query, 1234);
+    helper_expect_timeouts_eq(&(querier->timeout_recv), SSQ_TIMEOUT_RECV_DEFAULT_VALUE);
+
+    ssq_free(querier);
+}
+
+Test(ssq, set_max_attempts) {
+    SSQ_QUERIER *querier = ssq_init();
+
+    cr_assert_neq(querier, NULL);
+
+    ssq_set_max_attempts(querier, 3);
+    cr_expect_eq(querier->max_attempts, 3);
+
+    // A request is always sent at least once.
+    ssq_set_max_attempts(querier, 0);
+    cr_expect_eq(querier->max_attempts, 1);
+
+    ssq_free(querier);
+}